@@ -0,0 +1,91 @@
+#include "bench_data.h"
+#include "archive/archive_writer.h"
+#include "fusion/complementary_fusion.h"
+#include "simulation/flight_simulator.h"
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace astvdp::bench {
+
+namespace {
+
+struct Dataset {
+    std::vector<SampleBlock> blocks;
+    std::vector<FusedBlock> fused;
+    std::string csv_path;
+    std::string archive_paths[2];  // raw, compressed
+};
+
+const Dataset& dataset(size_t samples) {
+    static std::mutex mutex;
+    static std::map<size_t, Dataset> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(samples);
+    if (it != cache.end()) return it->second;
+
+    FlightSimulator::Profile profile;
+    profile.duration_sec = static_cast<double>(samples) / profile.sample_rate_hz;
+    profile.inject_vibration_fault = true;
+    profile.inject_gnss_dropout = true;
+    std::vector<TimestampedSample> rows = FlightSimulator::generate(profile);
+    rows.resize(samples, rows.empty() ? TimestampedSample{} : rows.back());
+
+    Dataset& data = cache[samples];
+    ComplementaryFusion fusion;
+    for (const auto& row : rows) {
+        if (data.blocks.empty() || data.blocks.back().full()) data.blocks.emplace_back();
+        data.blocks.back().push(row);
+    }
+    for (const auto& block : data.blocks) {
+        data.fused.emplace_back(block.size);
+        fusion.processBlock(block, data.fused.back());
+    }
+
+    data.csv_path = tempPath("astvdp_bench_" + std::to_string(samples) + ".csv");
+    FlightSimulator::saveToCsv(rows, data.csv_path);
+
+    for (bool compress : {false, true}) {
+        std::string& path = data.archive_paths[compress];
+        path = tempPath("astvdp_bench_" + std::to_string(samples) + (compress ? "_xor" : "_raw") + ".astvdp");
+        ArchiveWriter::Options options;
+        options.compress = compress;
+        ArchiveWriter writer;
+        writer.open(path, options);
+        for (const auto& block : data.blocks) writer.append(block);
+        writer.close();
+    }
+    return data;
+}
+
+}  // namespace
+
+const std::vector<SampleBlock>& simulatedBlocks(size_t samples) {
+    return dataset(samples).blocks;
+}
+
+const std::vector<FusedBlock>& fusedBlocks(size_t samples) {
+    return dataset(samples).fused;
+}
+
+const std::string& simulatedCsv(size_t samples) {
+    return dataset(samples).csv_path;
+}
+
+const std::string& simulatedArchive(size_t samples, bool compress) {
+    return dataset(samples).archive_paths[compress];
+}
+
+std::string tempPath(const std::string& name) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return path.string();
+}
+
+void sizeArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"samples"})->Arg(4096)->Arg(65536)->Arg(262144)->Unit(benchmark::kMillisecond);
+}
+
+}  // namespace astvdp::bench
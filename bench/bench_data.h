@@ -0,0 +1,24 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace astvdp::bench {
+
+// Simulated flights at 100 Hz with vibration and GNSS faults injected, built
+// once per size and shared by every benchmark in the process.
+// Rows are split into pipeline-sized blocks (SampleBlock::kDefaultCapacity).
+const std::vector<SampleBlock>& simulatedBlocks(size_t samples);
+const std::vector<FusedBlock>& fusedBlocks(size_t samples);  // through ComplementaryFusion
+const std::string& simulatedCsv(size_t samples);             // the same rows as a temp CSV
+const std::string& simulatedArchive(size_t samples, bool compress);  // ... as a temp archive
+
+// Fresh path under the system temp directory; any existing file is removed
+std::string tempPath(const std::string& name);
+
+// Standard input sizes: ~40 s, ~11 min and ~44 min of flight at 100 Hz
+void sizeArgs(benchmark::internal::Benchmark* b);
+
+}  // namespace astvdp::bench
@@ -0,0 +1,19 @@
+// astvdp_bench entry point: standard google-benchmark flags, plus build and
+// CPU details in the JSON "context" so results from different releases and
+// machines can be told apart when diffed.
+#include "core/cpu_features.h"
+#include <benchmark/benchmark.h>
+
+#ifndef ASTVDP_VERSION
+#define ASTVDP_VERSION "unknown"
+#endif
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::AddCustomContext("astvdp_version", ASTVDP_VERSION);
+    benchmark::AddCustomContext("simd_level", astvdp::simdLevelName(astvdp::detectSimdLevel()));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,84 @@
+// End-to-end throughput: simulated CSV -> mmap ingest -> fusion ->
+// verify/diagnose -> episodes -> SQLite, the same stage wiring as the CLI.
+#include "analysis/episode_tracker.h"
+#include "bench_data.h"
+#include "core/database.h"
+#include "diagnostics/diagnostic_engine.h"
+#include "fusion/complementary_fusion.h"
+#include "ingest/mmap_csv_ingest.h"
+#include "pipeline/staged_pipeline.h"
+#include "verification/safety_verifier.h"
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace astvdp::bench {
+
+namespace {
+
+// range(0) = samples, range(1) = pipeline threads (1 = serial)
+void BM_Pipeline(benchmark::State& state) {
+    const size_t samples = static_cast<size_t>(state.range(0));
+    const std::string& csv = simulatedCsv(samples);
+    size_t anomalies = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        const std::string db_path = tempPath("astvdp_bench_pipeline.db");
+        Database db(db_path);  // default write options, as the CLI without --wal
+        if (!db.open()) {
+            state.SkipWithError("cannot open database");
+            return;
+        }
+        const int64_t session = db.startSession("bench", "sim");
+        state.ResumeTiming();
+
+        MmapCsvIngest ingest;
+        if (!ingest.open(csv)) {
+            state.SkipWithError("cannot open simulated CSV");
+            return;
+        }
+        ComplementaryFusion fusion;
+        SafetyVerifierImpl verifier;
+        DiagnosticEngine diagnostics;
+        EpisodeTracker tracker;
+        std::vector<AnomalyEpisode> episodes;
+
+        StagedPipeline::Stages stages;
+        stages.ingest = &ingest;
+        stages.fusion = &fusion;
+        stages.verifier = &verifier;
+        stages.diagnostics = &diagnostics;
+        stages.episodes = &tracker;
+        stages.persist = [&](PipelineBatch& batch) {
+            db.appendFlightData(session, batch.samples);
+            for (const auto& e : batch.episodes) db.insertEpisode(session, e);
+            episodes.insert(episodes.end(), batch.episodes.begin(), batch.episodes.end());
+        };
+        StagedPipeline::Options options;
+        options.threads = static_cast<size_t>(state.range(1));
+        const auto run = StagedPipeline::run(stages, options);
+        ingest.close();
+        // Episodes still open at end of input are stored too, as by SessionRunner
+        const size_t closed_count = episodes.size();
+        tracker.finish(episodes);
+        for (size_t i = closed_count; i < episodes.size(); ++i) db.insertEpisode(session, episodes[i]);
+        db.endSession(session, run.last_time);
+        anomalies = episodes.size();
+
+        state.PauseTiming();
+        db.close();
+        std::filesystem::remove(db_path);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * samples));
+    state.counters["episodes"] = static_cast<double>(anomalies);
+}
+BENCHMARK(BM_Pipeline)
+    ->ArgNames({"samples", "threads"})
+    ->ArgsProduct({{4096, 65536, 262144}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace astvdp::bench
@@ -0,0 +1,267 @@
+// Per-stage throughput: each benchmark runs one stage over a whole simulated
+// flight in pipeline-sized blocks and reports samples/s as items_per_second.
+#include "bench_data.h"
+#include "core/cpu_features.h"
+#include "core/database.h"
+#include "core/work_stealing_pool.h"
+#include "diagnostics/diagnostic_engine.h"
+#include "fusion/complementary_fusion.h"
+#include "fusion/ekf_fusion.h"
+#include "ingest/archive_ingest.h"
+#include "ingest/csv_ingest.h"
+#include "ingest/mmap_csv_ingest.h"
+#include "ingest/parallel_csv_ingest.h"
+#include "ingest/simulator_ingest.h"
+#include "simulation/flight_simulator.h"
+#include "simulation/scenario_simulator.h"
+#include "verification/safety_verifier.h"
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace astvdp::bench {
+
+namespace {
+
+const SimdLevel kSimdLevels[] = {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2};
+
+// Adds one run per SIMD level the CPU supports; the level index is range(1)
+void simdSizeArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"samples", "simd"})->Unit(benchmark::kMillisecond);
+    for (int64_t samples : {4096, 65536, 262144}) {
+        for (int level = 0; level <= static_cast<int>(detectSimdLevel()); ++level) {
+            b->Args({samples, level});
+        }
+    }
+}
+
+void setSamples(benchmark::State& state, size_t samples) {
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * samples));
+}
+
+template <typename Ingest, typename... Args>
+void ingestFile(benchmark::State& state, const std::string& path, Args... args) {
+    const size_t samples = static_cast<size_t>(state.range(0));
+    SampleBlock block;
+    for (auto _ : state) {
+        Ingest ingest(args...);
+        if (!ingest.open(path)) {
+            state.SkipWithError("cannot open simulated input");
+            return;
+        }
+        size_t rows = 0;
+        while (size_t n = ingest.readBatch(block)) rows += n;
+        ingest.close();
+        benchmark::DoNotOptimize(rows);
+    }
+    setSamples(state, samples);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() *
+                                                 std::filesystem::file_size(path)));
+}
+
+void BM_CsvIngest(benchmark::State& state) {
+    ingestFile<CsvIngest>(state, simulatedCsv(static_cast<size_t>(state.range(0))));
+}
+BENCHMARK(BM_CsvIngest)->Apply(sizeArgs);
+
+void BM_MmapCsvIngest(benchmark::State& state) {
+    ingestFile<MmapCsvIngest>(state, simulatedCsv(static_cast<size_t>(state.range(0))));
+}
+BENCHMARK(BM_MmapCsvIngest)->Apply(sizeArgs);
+
+// range(1) = parse threads; UseRealTime since the work is on pool threads
+void BM_ParallelCsvIngest(benchmark::State& state) {
+    ingestFile<ParallelCsvIngest>(state, simulatedCsv(static_cast<size_t>(state.range(0))),
+                                  static_cast<size_t>(state.range(1)));
+}
+BENCHMARK(BM_ParallelCsvIngest)
+    ->ArgNames({"samples", "threads"})
+    ->ArgsProduct({{4096, 65536, 262144}, {1, 2, 4, 8}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// range(1) = 1 for the compressed (XOR/delta) archive, 0 for raw columns
+void BM_ArchiveIngest(benchmark::State& state) {
+    ingestFile<ArchiveIngest>(state, simulatedArchive(static_cast<size_t>(state.range(0)),
+                                                      state.range(1) != 0));
+}
+BENCHMARK(BM_ArchiveIngest)
+    ->ArgNames({"samples", "compress"})
+    ->ArgsProduct({{4096, 65536, 262144}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// Simulated input: range(1) = 0 generates blocks in place (SimulatorIngest),
+// 1 takes the CSV round trip (generate + saveToCsv + MmapCsvIngest)
+void BM_SimulatedIngest(benchmark::State& state) {
+    const size_t samples = static_cast<size_t>(state.range(0));
+    const bool via_csv = state.range(1) != 0;
+    FlightSimulator::Profile profile;
+    profile.duration_sec = static_cast<double>(samples) / profile.sample_rate_hz;
+    profile.inject_vibration_fault = true;
+    profile.inject_gnss_dropout = true;
+    const std::string csv = tempPath("astvdp_bench_sim_roundtrip.csv");
+    SampleBlock block;
+    for (auto _ : state) {
+        size_t rows = 0;
+        if (via_csv) {
+            FlightSimulator::saveToCsv(FlightSimulator::generate(profile), csv);
+            MmapCsvIngest ingest;
+            ingest.open(csv);
+            while (size_t n = ingest.readBatch(block)) rows += n;
+            ingest.close();
+        } else {
+            SimulatorIngest ingest(profile);
+            ingest.open({});
+            while (size_t n = ingest.readBatch(block)) rows += n;
+            ingest.close();
+        }
+        benchmark::DoNotOptimize(rows);
+    }
+    setSamples(state, samples);
+    std::filesystem::remove(csv);
+}
+BENCHMARK(BM_SimulatedIngest)
+    ->ArgNames({"samples", "via_csv"})
+    ->ArgsProduct({{4096, 65536, 262144}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// Scenario flight generated into one preallocated block; range(1) = threads
+// (1 generates inline), UseRealTime since the work is on pool threads
+void BM_ScenarioGenerate(benchmark::State& state) {
+    const size_t samples = static_cast<size_t>(state.range(0));
+    const size_t threads = static_cast<size_t>(state.range(1));
+    Scenario scenario;
+    scenario.sample_rate_hz = 1000.0;
+    scenario.segments = {{60.0, 5.0, 0.1}, {120.0}, {60.0, 0.0, 0.0, 0.26, 0.02}, {60.0, -5.0, -0.05}};
+    scenario.faults = {{Scenario::Fault::kVibrationRamp, 200.0}};
+    scenario.repeat = static_cast<size_t>(samples / scenario.sampleCount()) + 1;
+    const ScenarioSimulator sim(scenario);
+    SampleBlock block(samples);
+    WorkStealingPool pool(threads);
+    for (auto _ : state) {
+        if (threads > 1) {
+            sim.generate(0, samples, block, 0, pool);
+        } else {
+            sim.generate(0, samples, block);
+        }
+        benchmark::DoNotOptimize(block.vib_z.data());
+    }
+    setSamples(state, samples);
+}
+BENCHMARK(BM_ScenarioGenerate)
+    ->ArgNames({"samples", "threads"})
+    ->ArgsProduct({{262144, 4194304}, {1, 2, 4, 8}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+void fuseBlocks(SensorFusion& fusion, const std::vector<SampleBlock>& blocks, FusedBlock& fused) {
+    for (const auto& block : blocks) fusion.processBlock(block, fused);
+    benchmark::DoNotOptimize(fused.q_dyn.data());
+}
+
+void BM_ComplementaryFusion(benchmark::State& state) {
+    const size_t samples = static_cast<size_t>(state.range(0));
+    const auto& blocks = simulatedBlocks(samples);
+    FusedBlock fused;
+    for (auto _ : state) {
+        ComplementaryFusion fusion;
+        fusion.setSimdLevel(kSimdLevels[state.range(1)]);
+        fuseBlocks(fusion, blocks, fused);
+    }
+    setSamples(state, samples);
+}
+BENCHMARK(BM_ComplementaryFusion)->Apply(simdSizeArgs);
+
+void BM_EkfFusion(benchmark::State& state) {
+    const size_t samples = static_cast<size_t>(state.range(0));
+    const auto& blocks = simulatedBlocks(samples);
+    FusedBlock fused;
+    for (auto _ : state) {
+        EkfFusion fusion;
+        fuseBlocks(fusion, blocks, fused);
+    }
+    setSamples(state, samples);
+}
+BENCHMARK(BM_EkfFusion)->Apply(sizeArgs);
+
+void BM_SafetyVerifier(benchmark::State& state) {
+    const size_t samples = static_cast<size_t>(state.range(0));
+    const auto& blocks = simulatedBlocks(samples);
+    const auto& fused = fusedBlocks(samples);
+    std::vector<BlockAnomaly> anomalies;
+    for (auto _ : state) {
+        SafetyVerifierImpl verifier;
+        verifier.setSimdLevel(kSimdLevels[state.range(1)]);
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            anomalies.clear();
+            verifier.checkBlock(fused[b], blocks[b], anomalies);
+        }
+        benchmark::DoNotOptimize(anomalies.data());
+    }
+    setSamples(state, samples);
+}
+BENCHMARK(BM_SafetyVerifier)->Apply(simdSizeArgs);
+
+void diagnose(benchmark::State& state, bool spectral) {
+    const size_t samples = static_cast<size_t>(state.range(0));
+    const auto& blocks = simulatedBlocks(samples);
+    std::vector<BlockAnomaly> anomalies;
+    for (auto _ : state) {
+        DiagnosticEngine diagnostics;
+        if (spectral) diagnostics.enableSpectral();
+        for (const auto& block : blocks) {
+            anomalies.clear();
+            diagnostics.processBlock(block, anomalies);
+        }
+        benchmark::DoNotOptimize(anomalies.data());
+    }
+    setSamples(state, samples);
+}
+
+void BM_Diagnostics(benchmark::State& state) {
+    diagnose(state, false);
+}
+BENCHMARK(BM_Diagnostics)->Apply(sizeArgs);
+
+void BM_DiagnosticsSpectral(benchmark::State& state) {
+    diagnose(state, true);
+}
+BENCHMARK(BM_DiagnosticsSpectral)->Apply(sizeArgs);
+
+// Batched flight_data inserts into a fresh on-disk database per iteration;
+// range(1) selects journal_mode=WAL
+void BM_DatabaseAppend(benchmark::State& state) {
+    const size_t samples = static_cast<size_t>(state.range(0));
+    const auto& blocks = simulatedBlocks(samples);
+    Database::WriteOptions options;
+    options.wal = state.range(1) != 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        const std::string path = tempPath("astvdp_bench_append.db");
+        Database db(path);
+        if (!db.open()) {
+            state.SkipWithError("cannot open database");
+            return;
+        }
+        db.setWriteOptions(options);
+        const int64_t session = db.startSession("bench", "sim");
+        state.ResumeTiming();
+
+        for (const auto& block : blocks) db.appendFlightData(session, block);
+        db.flush();
+
+        state.PauseTiming();
+        db.close();
+        std::filesystem::remove(path);
+        state.ResumeTiming();
+    }
+    setSamples(state, samples);
+}
+BENCHMARK(BM_DatabaseAppend)
+    ->ArgNames({"samples", "wal"})
+    ->ArgsProduct({{4096, 65536, 262144}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+}  // namespace astvdp::bench
@@ -37,6 +37,9 @@ CREATE TABLE IF NOT EXISTS anomalies (
     param_affected TEXT,
     severity TEXT,
     details TEXT,
+    end_time REAL,
+    sample_count INTEGER DEFAULT 1,
+    peak_value REAL,
     FOREIGN KEY(session_id) REFERENCES flight_sessions(id)
 );
 
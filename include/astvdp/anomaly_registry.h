@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace astvdp {
+
+using AnomalyId = uint16_t;
+
+// The strings an anomaly is reported with. Anomalies only carry an id; the
+// strings are looked up at the DB/report boundary.
+struct AnomalyDescriptor {
+    std::string type;
+    std::string param;
+    std::string details;
+};
+
+// Descriptors raised by the built-in verifier and diagnostics
+namespace anomaly_ids {
+enum : AnomalyId {
+    kRollRateBreach,
+    kPitchRateBreach,
+    kYawRateBreach,
+    kDynPressureBreach,
+    kAltitudeBreach,
+    kTemperatureBreach,
+    kVibrationExcess,
+    kGnssDropout,
+    kVibrationBuildup,
+    kImuBiasDrift,
+    kVibrationBuildupX,
+    kVibrationBuildupY,
+    kAccelBiasDriftX,
+    kAccelBiasDriftY,
+    kGyroBiasDriftX,
+    kGyroBiasDriftY,
+    kGyroBiasDriftZ,
+    kGnssIntermittent,
+    kBuiltinCount
+};
+}  // namespace anomaly_ids
+
+// Process-wide, thread-safe descriptor table. Built-in ids resolve without
+// locking; intern() registers further descriptors once, e.g. when a detector
+// is configured, and returns the same id for identical strings.
+class AnomalyRegistry {
+public:
+    static AnomalyId intern(const std::string& type, const std::string& param,
+                            const std::string& details);
+    static const AnomalyDescriptor& describe(AnomalyId id);
+};
+
+}  // namespace astvdp
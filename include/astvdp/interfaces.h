@@ -14,18 +14,111 @@ struct FusedState {
     double q_dyn = 0;
 };
 
+// Structure-of-arrays counterpart of FusedState, row-aligned with a SampleBlock.
+struct FusedBlock {
+    explicit FusedBlock(size_t capacity = SampleBlock::kDefaultCapacity) { reserve(capacity); }
+
+    size_t size = 0;
+    std::vector<double> timestamp;
+    std::vector<double> roll, pitch, yaw;
+    std::vector<double> alt_msl;
+    std::vector<double> vn, ve, vd;
+    std::vector<double> q_dyn;
+
+    size_t capacity() const { return timestamp.size(); }
+
+    void reserve(size_t capacity) {
+        for (auto* ch : {&timestamp, &roll, &pitch, &yaw, &alt_msl, &vn, &ve, &vd, &q_dyn}) {
+            ch->resize(capacity);
+        }
+    }
+
+    void set(size_t i, const FusedState& f) {
+        timestamp[i] = f.timestamp;
+        roll[i] = f.roll; pitch[i] = f.pitch; yaw[i] = f.yaw;
+        alt_msl[i] = f.alt_msl;
+        vn[i] = f.vn; ve[i] = f.ve; vd[i] = f.vd;
+        q_dyn[i] = f.q_dyn;
+    }
+
+    FusedState get(size_t i) const {
+        FusedState f;
+        f.timestamp = timestamp[i];
+        f.roll = roll[i]; f.pitch = pitch[i]; f.yaw = yaw[i];
+        f.alt_msl = alt_msl[i];
+        f.vn = vn[i]; f.ve = ve[i]; f.vd = vd[i];
+        f.q_dyn = q_dyn[i];
+        return f;
+    }
+};
+
 class DataIngest {
 public:
     virtual ~DataIngest() = default;
     virtual bool open(const std::string& source) = 0;
     virtual bool readNext(TimestampedSample& out) = 0;
     virtual void close() = 0;
+
+    // Refills `out` with up to capacity() rows and returns the row count
+    // (0 at end of input). A row that fails to parse ends the input, as it
+    // ends the per-sample readNext() loop: readers return the rows before it
+    // and 0 from then on.
+    //
+    // The default adapts readNext() for legacy ingesters. Columns a row
+    // leaves unset keep the previous row's values, exactly as with a reused
+    // TimestampedSample, and the first false from readNext() ends the
+    // input. Readers that rely on it call resetBatch() when they open, seek
+    // or close.
+    virtual size_t readBatch(SampleBlock& out) {
+        out.clear();
+        while (!batch_ended_ && !out.full()) {
+            if (!readNext(batch_row_)) {
+                batch_ended_ = true;
+                break;
+            }
+            out.push(batch_row_);
+        }
+        return out.size;
+    }
+
+    // Positions the reader so that the next row returned is the first one
+    // with a timestamp >= `timestamp`; timestamps are assumed not to decrease.
+    // Returns false, leaving the position unchanged, if the source cannot
+    // seek. Columns that rows after a seek leave unset are carried into
+    // readBatch() output as reading from the start would have set them;
+    // readNext() leaves them as they are in the caller's sample.
+    virtual bool seek(double timestamp) {
+        (void)timestamp;
+        return false;
+    }
+
+protected:
+    // Restarts the default readBatch() with `carry` as the previous row
+    void resetBatch(const TimestampedSample& carry = TimestampedSample{}) {
+        batch_row_ = carry;
+        batch_ended_ = false;
+    }
+
+private:
+    TimestampedSample batch_row_{};  // default readBatch(): carries unset columns
+    bool batch_ended_ = false;
 };
 
 class SensorFusion {
 public:
     virtual ~SensorFusion() = default;
     virtual void process(const TimestampedSample& raw, FusedState& fused) = 0;
+
+    // Fuses a whole block; the default falls back to per-sample process().
+    virtual void processBlock(const SampleBlock& raw, FusedBlock& fused) {
+        if (fused.capacity() < raw.size) fused.reserve(raw.size);
+        for (size_t i = 0; i < raw.size; ++i) {
+            FusedState f;
+            process(raw.get(i), f);
+            fused.set(i, f);
+        }
+        fused.size = raw.size;
+    }
 };
 
 class SafetyVerifier {
@@ -34,6 +127,17 @@ public:
     virtual bool loadLimitsFromDb(const std::string& db_path) = 0;
     virtual std::vector<Anomaly> check(const FusedState& state,
                                        const TimestampedSample& raw) = 0;
+
+    // Checks a whole block, appending anomalies in row order; the default
+    // falls back to per-sample check().
+    virtual void checkBlock(const FusedBlock& state, const SampleBlock& raw,
+                            std::vector<BlockAnomaly>& out) {
+        for (size_t i = 0; i < raw.size; ++i) {
+            for (auto& a : check(state.get(i), raw.get(i))) {
+                out.push_back({static_cast<uint32_t>(i), std::move(a)});
+            }
+        }
+    }
 };
 
-}  // namespace astvdp
\ No newline at end of file
+}  // namespace astvdp
@@ -1,7 +1,11 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
+#include "astvdp/anomaly_registry.h"
 
 namespace astvdp {
 
@@ -16,14 +20,121 @@ struct TimestampedSample {
     double vib_x = 0, vib_y = 0, vib_z = 0;
 };
 
-enum class Severity { Observation, Minor, Major, Critical };
+// Structure-of-arrays block of samples: one contiguous array per channel,
+// sized once to the block capacity and reused between reads.
+struct SampleBlock {
+    static constexpr size_t kDefaultCapacity = 4096;
 
+    explicit SampleBlock(size_t capacity = kDefaultCapacity) { reserve(capacity); }
+
+    size_t size = 0;
+    std::vector<double> timestamp;
+    std::vector<double> imu_ax, imu_ay, imu_az;
+    std::vector<double> imu_gx, imu_gy, imu_gz;
+    std::vector<double> gps_lat, gps_lon, gps_alt;
+    std::vector<double> gps_vx, gps_vy;
+    std::vector<double> static_pressure;
+    std::vector<double> temperature;
+    std::vector<double> vib_x, vib_y, vib_z;
+
+    size_t capacity() const { return timestamp.size(); }
+    bool full() const { return size >= capacity(); }
+    void clear() { size = 0; }
+
+    void reserve(size_t capacity) {
+        for (auto* ch : channels()) ch->resize(capacity);
+    }
+
+    void set(size_t i, const TimestampedSample& s) {
+        timestamp[i] = s.timestamp;
+        imu_ax[i] = s.imu_ax; imu_ay[i] = s.imu_ay; imu_az[i] = s.imu_az;
+        imu_gx[i] = s.imu_gx; imu_gy[i] = s.imu_gy; imu_gz[i] = s.imu_gz;
+        gps_lat[i] = s.gps_lat; gps_lon[i] = s.gps_lon; gps_alt[i] = s.gps_alt;
+        gps_vx[i] = s.gps_vx; gps_vy[i] = s.gps_vy;
+        static_pressure[i] = s.static_pressure;
+        temperature[i] = s.temperature;
+        vib_x[i] = s.vib_x; vib_y[i] = s.vib_y; vib_z[i] = s.vib_z;
+    }
+
+    TimestampedSample get(size_t i) const {
+        TimestampedSample s;
+        s.timestamp = timestamp[i];
+        s.imu_ax = imu_ax[i]; s.imu_ay = imu_ay[i]; s.imu_az = imu_az[i];
+        s.imu_gx = imu_gx[i]; s.imu_gy = imu_gy[i]; s.imu_gz = imu_gz[i];
+        s.gps_lat = gps_lat[i]; s.gps_lon = gps_lon[i]; s.gps_alt = gps_alt[i];
+        s.gps_vx = gps_vx[i]; s.gps_vy = gps_vy[i];
+        s.static_pressure = static_pressure[i];
+        s.temperature = temperature[i];
+        s.vib_x = vib_x[i]; s.vib_y = vib_y[i]; s.vib_z = vib_z[i];
+        return s;
+    }
+
+    bool push(const TimestampedSample& s) {
+        if (full()) return false;
+        set(size++, s);
+        return true;
+    }
+
+    // Copies rows [from, from + n) of `src` over rows [at, at + n); does not
+    // change size
+    void copyRows(size_t at, const SampleBlock& src, size_t from, size_t n) {
+        const auto dst = channels();
+        const auto in = src.channels();
+        for (size_t c = 0; c < dst.size(); ++c) {
+            std::copy_n(in[c]->data() + from, n, dst[c]->data() + at);
+        }
+    }
+
+private:
+    static constexpr size_t kChannels = 17;
+
+    std::array<std::vector<double>*, kChannels> channels() {
+        return {&timestamp, &imu_ax, &imu_ay, &imu_az, &imu_gx, &imu_gy, &imu_gz,
+                &gps_lat, &gps_lon, &gps_alt, &gps_vx, &gps_vy,
+                &static_pressure, &temperature, &vib_x, &vib_y, &vib_z};
+    }
+    std::array<const std::vector<double>*, kChannels> channels() const {
+        return {&timestamp, &imu_ax, &imu_ay, &imu_az, &imu_gx, &imu_gy, &imu_gz,
+                &gps_lat, &gps_lon, &gps_alt, &gps_vx, &gps_vy,
+                &static_pressure, &temperature, &vib_x, &vib_y, &vib_z};
+    }
+};
+
+enum class Severity : uint8_t { Observation, Minor, Major, Critical };
+
+// Compact anomaly record: type/param/details live in the AnomalyRegistry.
+// `value` measures how bad the sample is (distance beyond the violated limit,
+// outage length, RMS ratio, ...); larger is worse.
 struct Anomaly {
     double timestamp;
-    std::string type;
-    std::string param;
+    AnomalyId id;
     Severity severity;
-    std::string details;
+    float value = 0.0f;
+
+    const AnomalyDescriptor& describe() const { return AnomalyRegistry::describe(id); }
+};
+static_assert(sizeof(Anomaly) <= 16, "Anomaly should stay a 16-byte record");
+
+// Run of identical anomalies (same id and severity) on consecutive samples
+struct AnomalyEpisode {
+    double start_time;
+    double end_time;
+    uint32_t count;  // samples in the run
+    float peak;      // largest Anomaly::value seen
+    AnomalyId id;
+    Severity severity;
+
+    static AnomalyEpisode single(const Anomaly& a) {
+        return {a.timestamp, a.timestamp, 1, a.value, a.id, a.severity};
+    }
+    const AnomalyDescriptor& describe() const { return AnomalyRegistry::describe(id); }
+};
+
+// Anomaly raised while processing a SampleBlock, tagged with its block row so
+// outputs of several block stages can be merged back into sample order.
+struct BlockAnomaly {
+    uint32_t row;
+    Anomaly anomaly;
 };
 
-}  // namespace astvdp
\ No newline at end of file
+}  // namespace astvdp
@@ -77,6 +77,8 @@ export default async function SessionDetailPage({ params, searchParams }: Sessio
             <thead className="table-head">
               <tr>
                 <th className="px-3 py-2 text-left">Timestamp</th>
+                <th className="px-3 py-2 text-left">End</th>
+                <th className="px-3 py-2 text-left">Samples</th>
                 <th className="px-3 py-2 text-left">Type</th>
                 <th className="px-3 py-2 text-left">Parameter</th>
                 <th className="px-3 py-2 text-left">Severity</th>
@@ -86,7 +88,7 @@ export default async function SessionDetailPage({ params, searchParams }: Sessio
             <tbody className="divide-y divide-cyan-900/20 text-sm">
               {anomalies.length === 0 ? (
                 <tr>
-                  <td colSpan={5} className="px-3 py-6 text-center text-slate-400">
+                  <td colSpan={7} className="px-3 py-6 text-center text-slate-400">
                     No anomalies for selected filter.
                   </td>
                 </tr>
@@ -94,6 +96,8 @@ export default async function SessionDetailPage({ params, searchParams }: Sessio
                 anomalies.map((anomaly) => (
                   <tr key={anomaly.id} className="bg-panelAlt/40">
                     <td className="px-3 py-2 font-mono text-xs">{anomaly.timestamp.toFixed(3)}</td>
+                    <td className="px-3 py-2 font-mono text-xs">{anomaly.endTime?.toFixed(3) ?? '-'}</td>
+                    <td className="px-3 py-2">{anomaly.sampleCount}</td>
                     <td className="px-3 py-2">{anomaly.type}</td>
                     <td className="px-3 py-2">{anomaly.paramAffected ?? '-'}</td>
                     <td className="px-3 py-2">
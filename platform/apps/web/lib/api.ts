@@ -67,6 +67,9 @@ export interface Anomaly {
   paramAffected?: string | null;
   severity: 'CRITICAL' | 'MAJOR' | 'MINOR' | 'OBSERVATION';
   details?: string | null;
+  endTime?: number | null;
+  sampleCount: number;
+  peakValue?: number | null;
 }
 
 export async function fetchJson<T>(path: string, init?: RequestInit): Promise<T | null> {
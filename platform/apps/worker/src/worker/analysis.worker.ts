@@ -266,9 +266,12 @@ export class AnalysisWorkerService implements OnModuleInit, OnModuleDestroy {
           param_affected: string | null;
           severity: string | null;
           details: string | null;
+          end_time: number | null;
+          sample_count: number | null;
+          peak_value: number | null;
         }[]
       >(
-        'SELECT timestamp, type, param_affected, severity, details FROM anomalies WHERE session_id = ? ORDER BY timestamp ASC',
+        'SELECT timestamp, type, param_affected, severity, details, end_time, sample_count, peak_value FROM anomalies WHERE session_id = ? ORDER BY timestamp ASC',
         session.id
       );
 
@@ -304,7 +307,10 @@ export class AnalysisWorkerService implements OnModuleInit, OnModuleDestroy {
             type: item.type,
             paramAffected: item.param_affected,
             severity: this.mapSeverity(item.severity),
-            details: item.details
+            details: item.details,
+            endTime: item.end_time,
+            sampleCount: item.sample_count ?? 1,
+            peakValue: item.peak_value
           }))
         });
       }
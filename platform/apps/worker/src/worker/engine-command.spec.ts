@@ -16,6 +16,7 @@ describe('buildEngineArgs', () => {
     expect(args).toEqual(
       expect.arrayContaining([
         '--simulate',
+        '--save-sim',
         '--mission',
         'TEST-001',
         '--aircraft',
@@ -16,7 +16,8 @@ export const buildEngineArgs = (input: EngineCommandInput): string[] => {
   const dbPath = path.resolve(input.outputDir, 'test.db');
 
   if (input.mode === JobMode.SIMULATE) {
-    args.push('--simulate');
+    // --save-sim keeps sim_flight.csv, which is synced as the CSV artifact
+    args.push('--simulate', '--save-sim');
   } else {
     if (!input.inputFilePath) {
       throw new Error('inputFilePath is required for CSV_UPLOAD mode');
@@ -56,6 +56,9 @@ export interface AnomalyDto {
   paramAffected?: string | null;
   severity: Severity;
   details?: string | null;
+  endTime?: number | null;
+  sampleCount: number;
+  peakValue?: number | null;
 }
 
 export interface PaginationResponse<T> {
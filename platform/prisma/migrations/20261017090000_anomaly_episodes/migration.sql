@@ -0,0 +1,4 @@
+-- AlterTable
+ALTER TABLE `Anomaly` ADD COLUMN `endTime` DOUBLE NULL,
+    ADD COLUMN `sampleCount` INTEGER NOT NULL DEFAULT 1,
+    ADD COLUMN `peakValue` DOUBLE NULL;
@@ -0,0 +1,43 @@
+#include "episode_tracker.h"
+#include <algorithm>
+
+namespace astvdp {
+
+void EpisodeTracker::add(uint64_t sample_index, const Anomaly& a,
+                         std::vector<AnomalyEpisode>& closed) {
+    for (auto& open : open_) {
+        if (open.episode.id != a.id || open.episode.severity != a.severity) continue;
+
+        if (open.last_index + 1 >= sample_index) {
+            AnomalyEpisode& ep = open.episode;
+            ep.end_time = a.timestamp;
+            ep.count++;
+            ep.peak = std::max(ep.peak, a.value);
+            open.last_index = sample_index;
+        } else {
+            closed.push_back(open.episode);
+            open = {AnomalyEpisode::single(a), sample_index};
+        }
+        return;
+    }
+    open_.push_back({AnomalyEpisode::single(a), sample_index});
+}
+
+void EpisodeTracker::advanceTo(uint64_t next_sample_index, std::vector<AnomalyEpisode>& closed) {
+    size_t kept = 0;
+    for (size_t i = 0; i < open_.size(); ++i) {
+        if (open_[i].last_index + 1 >= next_sample_index) {
+            open_[kept++] = open_[i];
+        } else {
+            closed.push_back(open_[i].episode);
+        }
+    }
+    open_.resize(kept);
+}
+
+void EpisodeTracker::finish(std::vector<AnomalyEpisode>& closed) {
+    for (const auto& open : open_) closed.push_back(open.episode);
+    open_.clear();
+}
+
+}  // namespace astvdp
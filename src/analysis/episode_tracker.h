@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "astvdp/types.h"
+
+namespace astvdp {
+
+// Incrementally coalesces anomalies into episodes: an anomaly extends the open
+// episode with the same id and severity when it was raised on the very next
+// sample, otherwise that episode closes and a new one opens. Closed episodes
+// are appended to the caller's vector as soon as they are known to be final.
+class EpisodeTracker {
+public:
+    // Sample indices must be non-decreasing across calls.
+    void add(uint64_t sample_index, const Anomaly& anomaly, std::vector<AnomalyEpisode>& closed);
+
+    // Closes every episode that did not continue into `next_sample_index`.
+    void advanceTo(uint64_t next_sample_index, std::vector<AnomalyEpisode>& closed);
+
+    // Closes all remaining episodes (end of input).
+    void finish(std::vector<AnomalyEpisode>& closed);
+
+private:
+    struct OpenEpisode {
+        AnomalyEpisode episode;
+        uint64_t last_index;
+    };
+
+    std::vector<OpenEpisode> open_;
+};
+
+}  // namespace astvdp
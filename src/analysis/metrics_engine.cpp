@@ -3,7 +3,11 @@
 
 namespace astvdp {
 
-SessionMetrics computeMetrics(const std::vector<Anomaly>& anomalies, size_t total_samples) {
+namespace {
+// Scores a sequence of (severity, occurrences) groups; an episode counts once
+// per sample it covers, so raw anomalies and their episodes score the same.
+template <typename Range, typename SeverityOf, typename CountOf>
+SessionMetrics score(const Range& items, size_t total_samples, SeverityOf severityOf, CountOf countOf) {
     if (total_samples == 0) return {};
 
     SessionMetrics m;
@@ -14,22 +18,26 @@ SessionMetrics computeMetrics(const std::vector<Anomaly>& anomalies, size_t tota
 
     double total_weight = 0.0;
     int critical_count = 0, major_count = 0;
+    size_t anomaly_count = 0;
 
-    for (const auto& a : anomalies) {
-        switch (a.severity) {
+    // Weights are multiples of 0.5, so these sums are exact in any order
+    for (const auto& item : items) {
+        const size_t n = countOf(item);
+        anomaly_count += n;
+        switch (severityOf(item)) {
             case Severity::Critical:
-                total_weight += critical_weight;
-                critical_count++;
+                total_weight += critical_weight * n;
+                critical_count += static_cast<int>(n);
                 break;
             case Severity::Major:
-                total_weight += major_weight;
-                major_count++;
+                total_weight += major_weight * n;
+                major_count += static_cast<int>(n);
                 break;
             case Severity::Minor:
-                total_weight += minor_weight;
+                total_weight += minor_weight * n;
                 break;
             default:
-                total_weight += obs_weight;
+                total_weight += obs_weight * n;
                 break;
         }
     }
@@ -38,7 +46,7 @@ SessionMetrics computeMetrics(const std::vector<Anomaly>& anomalies, size_t tota
     m.sensor_reliability = std::max(0.0, 1.0 - (total_weight / total_samples));
 
     // Stability: penalize high-rate anomalies
-    double anomaly_rate = static_cast<double>(anomalies.size()) / total_samples;
+    double anomaly_rate = static_cast<double>(anomaly_count) / total_samples;
     m.stability_index = std::max(0.0, 1.0 - anomaly_rate * 10.0);
 
     // Compliance: fails if any critical
@@ -57,5 +65,18 @@ SessionMetrics computeMetrics(const std::vector<Anomaly>& anomalies, size_t tota
 
     return m;
 }
+}  // namespace
+
+SessionMetrics computeMetrics(const std::vector<Anomaly>& anomalies, size_t total_samples) {
+    return score(anomalies, total_samples,
+                 [](const Anomaly& a) { return a.severity; },
+                 [](const Anomaly&) { return size_t{1}; });
+}
+
+SessionMetrics computeMetrics(const std::vector<AnomalyEpisode>& episodes, size_t total_samples) {
+    return score(episodes, total_samples,
+                 [](const AnomalyEpisode& e) { return e.severity; },
+                 [](const AnomalyEpisode& e) { return static_cast<size_t>(e.count); });
+}
 
 }  // namespace astvdp
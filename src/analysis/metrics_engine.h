@@ -13,5 +13,6 @@ struct SessionMetrics {
 };
 
 SessionMetrics computeMetrics(const std::vector<Anomaly>& anomalies, size_t total_samples);
+SessionMetrics computeMetrics(const std::vector<AnomalyEpisode>& episodes, size_t total_samples);
 
 }  // namespace astvdp
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "archive_format.h"
+#include "column_codec.h"
+#include <cstring>
+
+namespace astvdp {
+
+namespace archive {
+
+ChannelArray channels(SampleBlock& b) {
+    return {&b.timestamp, &b.imu_ax, &b.imu_ay, &b.imu_az, &b.imu_gx, &b.imu_gy, &b.imu_gz,
+            &b.gps_lat, &b.gps_lon, &b.gps_alt, &b.gps_vx, &b.gps_vy,
+            &b.static_pressure, &b.temperature, &b.vib_x, &b.vib_y, &b.vib_z};
+}
+
+std::array<const std::vector<double>*, kChannelCount> channels(const SampleBlock& b) {
+    return {&b.timestamp, &b.imu_ax, &b.imu_ay, &b.imu_az, &b.imu_gx, &b.imu_gy, &b.imu_gz,
+            &b.gps_lat, &b.gps_lon, &b.gps_alt, &b.gps_vx, &b.gps_vy,
+            &b.static_pressure, &b.temperature, &b.vib_x, &b.vib_y, &b.vib_z};
+}
+
+}  // namespace archive
+
+namespace {
+
+template <typename T>
+T load(const char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof value);
+    return value;
+}
+
+}  // namespace
+
+bool readArchiveIndex(const char* data, size_t size, std::vector<ArchiveChunkInfo>& chunks) {
+    using namespace archive;
+    chunks.clear();
+    if (!data || size < kHeaderSize + kTrailerSize) return false;
+    if (std::memcmp(data, kHeaderMagic, sizeof kHeaderMagic) != 0) return false;
+    if (load<uint32_t>(data + 8) != kVersion || load<uint32_t>(data + 12) != kChannelCount) return false;
+
+    const char* trailer = data + size - kTrailerSize;
+    if (std::memcmp(trailer + 16, kTrailerMagic, sizeof kTrailerMagic) != 0) return false;
+    const uint64_t footer_offset = load<uint64_t>(trailer);
+    const uint32_t count = load<uint32_t>(trailer + 8);
+    const uint64_t footer_end = size - kTrailerSize;
+    if (footer_offset < kHeaderSize || footer_offset > footer_end ||
+        (footer_end - footer_offset) != uint64_t{count} * sizeof(ArchiveChunkInfo)) {
+        return false;
+    }
+
+    chunks.resize(count);
+    if (count) std::memcpy(chunks.data(), data + footer_offset, count * sizeof(ArchiveChunkInfo));
+    for (const auto& c : chunks) {
+        if (c.offset < kHeaderSize || c.offset > footer_offset || c.bytes > footer_offset - c.offset) {
+            chunks.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool decodeArchiveChunk(const char* data, size_t size, const ArchiveChunkInfo& info, SampleBlock& out) {
+    using namespace archive;
+    if (out.capacity() < info.rows || info.offset + info.bytes > size) return false;
+    const char* p = data + info.offset;
+    const char* end = p + info.bytes;
+    const ChannelArray columns = channels(out);
+    for (size_t c = 0; c < kChannelCount; ++c) {
+        if (static_cast<size_t>(end - p) < kColumnHeaderSize) return false;
+        const auto encoding = static_cast<ColumnEncoding>(static_cast<uint8_t>(p[0]));
+        const uint32_t bytes = load<uint32_t>(p + 1);
+        p += kColumnHeaderSize;
+        if (bytes > static_cast<size_t>(end - p)) return false;
+        if (!decodeColumn(encoding, reinterpret_cast<const uint8_t*>(p), bytes, columns[c]->data(),
+                          info.rows)) {
+            return false;
+        }
+        p += bytes;
+    }
+    out.size = info.rows;
+    return p == end;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,61 @@
+#pragma once
+#include "astvdp/types.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace astvdp {
+
+// Columnar session archive (.astvdp), little-endian:
+//
+//   header   "ASTVDPA\1", u32 version, u32 channel count
+//   chunks   per channel: u8 ColumnEncoding, u32 byte count, encoded values
+//   footer   one ArchiveChunkInfo per chunk
+//   trailer  u64 footer offset, u32 chunk count, u32 reserved, "ASTVDPF\1"
+//
+// Channels are the SampleBlock columns in CSV order, timestamp first. Every
+// chunk holds the same rows for all channels; the footer is the index that
+// readers load first (per-chunk row count, time span and channel min/max).
+namespace archive {
+
+constexpr char kHeaderMagic[8] = {'A', 'S', 'T', 'V', 'D', 'P', 'A', '\1'};
+constexpr char kTrailerMagic[8] = {'A', 'S', 'T', 'V', 'D', 'P', 'F', '\1'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kChannelCount = 17;
+constexpr size_t kHeaderSize = 16;
+constexpr size_t kTrailerSize = 24;
+constexpr size_t kColumnHeaderSize = 5;
+
+// Pointers to the SampleBlock columns in archive channel order
+using ChannelArray = std::array<std::vector<double>*, kChannelCount>;
+ChannelArray channels(SampleBlock& block);
+std::array<const std::vector<double>*, kChannelCount> channels(const SampleBlock& block);
+
+}  // namespace archive
+
+struct ArchiveChannelStats {
+    double min;  // NaN-ignoring; NaN if the chunk has no numbers
+    double max;
+};
+
+struct ArchiveChunkInfo {
+    uint64_t offset;  // file offset of the chunk's first column header
+    uint64_t bytes;   // encoded size of the whole chunk
+    uint32_t rows;
+    uint32_t reserved;
+    double first_time;
+    double last_time;
+    ArchiveChannelStats stats[archive::kChannelCount];
+};
+static_assert(sizeof(ArchiveChunkInfo) == 40 + 16 * archive::kChannelCount,
+              "ArchiveChunkInfo is written to disk as-is");
+
+// Validates header and trailer and loads the footer index of a mapped archive
+bool readArchiveIndex(const char* data, size_t size, std::vector<ArchiveChunkInfo>& chunks);
+
+// Decodes one chunk into rows [0, info.rows) of `out`, which must have the
+// capacity; sets out.size
+bool decodeArchiveChunk(const char* data, size_t size, const ArchiveChunkInfo& info, SampleBlock& out);
+
+}  // namespace astvdp
@@ -0,0 +1,137 @@
+#include "archive_writer.h"
+#include "archive/column_codec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace astvdp {
+
+namespace {
+
+template <typename T>
+void store(std::vector<uint8_t>& out, T value) {
+    const size_t at = out.size();
+    out.resize(at + sizeof value);
+    std::memcpy(out.data() + at, &value, sizeof value);
+}
+
+void storeMagic(std::vector<uint8_t>& out, const char (&magic)[8]) {
+    const size_t at = out.size();
+    out.resize(at + sizeof magic);
+    std::memcpy(out.data() + at, magic, sizeof magic);
+}
+
+ArchiveChannelStats channelStats(const double* values, size_t n) {
+    ArchiveChannelStats s{std::numeric_limits<double>::infinity(),
+                          -std::numeric_limits<double>::infinity()};
+    for (size_t i = 0; i < n; ++i) {
+        if (std::isnan(values[i])) continue;
+        s.min = std::min(s.min, values[i]);
+        s.max = std::max(s.max, values[i]);
+    }
+    if (s.min > s.max) s.min = s.max = std::numeric_limits<double>::quiet_NaN();
+    return s;
+}
+
+}  // namespace
+
+ArchiveWriter::~ArchiveWriter() {
+    close();
+}
+
+bool ArchiveWriter::open(const std::string& path, const Options& options) {
+    close();
+    options_ = options;
+    options_.chunk_rows = std::max<size_t>(options_.chunk_rows, 1);
+    pending_ = SampleBlock(options_.chunk_rows);
+    chunks_.clear();
+    rows_written_ = 0;
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) return false;
+    encoded_.clear();
+    storeMagic(encoded_, archive::kHeaderMagic);
+    store(encoded_, archive::kVersion);
+    store(encoded_, static_cast<uint32_t>(archive::kChannelCount));
+    file_.write(reinterpret_cast<const char*>(encoded_.data()), static_cast<std::streamsize>(encoded_.size()));
+    offset_ = encoded_.size();
+    ok_ = static_cast<bool>(file_);
+    return ok_;
+}
+
+bool ArchiveWriter::append(const SampleBlock& block) {
+    if (!file_.is_open()) return false;
+    const auto src = archive::channels(block);
+    const auto dst = archive::channels(pending_);
+    size_t row = 0;
+    while (row < block.size) {
+        const size_t n = std::min(block.size - row, pending_.capacity() - pending_.size);
+        for (size_t c = 0; c < archive::kChannelCount; ++c) {
+            std::memcpy(dst[c]->data() + pending_.size, src[c]->data() + row, n * sizeof(double));
+        }
+        pending_.size += n;
+        row += n;
+        if (pending_.full() && !writeChunk()) return false;
+    }
+    return ok_;
+}
+
+bool ArchiveWriter::writeChunk() {
+    const size_t rows = pending_.size;
+    if (rows == 0) return ok_;
+    ArchiveChunkInfo info{};
+    info.offset = offset_;
+    info.rows = static_cast<uint32_t>(rows);
+    info.first_time = pending_.timestamp[0];
+    info.last_time = pending_.timestamp[rows - 1];
+
+    encoded_.clear();
+    const auto columns = archive::channels(static_cast<const SampleBlock&>(pending_));
+    for (size_t c = 0; c < archive::kChannelCount; ++c) {
+        const double* values = columns[c]->data();
+        info.stats[c] = channelStats(values, rows);
+        const size_t header_at = encoded_.size();
+        encoded_.resize(header_at + archive::kColumnHeaderSize);
+        ColumnEncoding encoding = ColumnEncoding::kRaw;
+        if (options_.compress) {
+            encoding = encodeColumnSmallest(values, rows, encoded_);
+        } else {
+            encodeColumn(encoding, values, rows, encoded_);
+        }
+        const auto bytes = static_cast<uint32_t>(encoded_.size() - header_at - archive::kColumnHeaderSize);
+        encoded_[header_at] = static_cast<uint8_t>(encoding);
+        std::memcpy(encoded_.data() + header_at + 1, &bytes, sizeof bytes);
+    }
+    info.bytes = encoded_.size();
+
+    file_.write(reinterpret_cast<const char*>(encoded_.data()), static_cast<std::streamsize>(encoded_.size()));
+    offset_ += encoded_.size();
+    chunks_.push_back(info);
+    rows_written_ += rows;
+    pending_.clear();
+    ok_ = ok_ && static_cast<bool>(file_);
+    return ok_;
+}
+
+bool ArchiveWriter::close() {
+    if (!file_.is_open()) return ok_;
+    writeChunk();
+
+    const uint64_t footer_offset = offset_;
+    if (!chunks_.empty()) {
+        file_.write(reinterpret_cast<const char*>(chunks_.data()),
+                    static_cast<std::streamsize>(chunks_.size() * sizeof(ArchiveChunkInfo)));
+    }
+    encoded_.clear();
+    store(encoded_, footer_offset);
+    store(encoded_, static_cast<uint32_t>(chunks_.size()));
+    store(encoded_, uint32_t{0});
+    storeMagic(encoded_, archive::kTrailerMagic);
+    file_.write(reinterpret_cast<const char*>(encoded_.data()), static_cast<std::streamsize>(encoded_.size()));
+    file_.close();
+    ok_ = ok_ && !file_.fail();
+    return ok_;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,47 @@
+#pragma once
+#include "archive/archive_format.h"
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+// Streams SampleBlocks into a columnar archive (see archive_format.h). Rows
+// are buffered until a chunk is full; close() writes the last partial chunk
+// and the footer index, and must succeed for the file to be readable.
+class ArchiveWriter {
+public:
+    struct Options {
+        size_t chunk_rows = SampleBlock::kDefaultCapacity;
+        bool compress = true;  // smallest of XOR/delta/raw per channel and chunk
+    };
+
+    ArchiveWriter() = default;
+    ~ArchiveWriter();
+
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    bool open(const std::string& path) { return open(path, Options()); }
+    bool open(const std::string& path, const Options& options);
+    bool append(const SampleBlock& block);
+    bool close();
+
+    bool isOpen() const { return file_.is_open(); }
+    size_t rowsWritten() const { return rows_written_; }
+
+private:
+    bool writeChunk();
+
+    std::ofstream file_;
+    Options options_;
+    SampleBlock pending_{0};
+    std::vector<ArchiveChunkInfo> chunks_;
+    std::vector<uint8_t> encoded_;
+    uint64_t offset_ = 0;
+    size_t rows_written_ = 0;
+    bool ok_ = false;
+};
+
+}  // namespace astvdp
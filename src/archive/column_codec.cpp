@@ -0,0 +1,269 @@
+#include "column_codec.h"
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace astvdp {
+
+namespace {
+
+uint64_t toBits(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof bits);
+    return bits;
+}
+
+double fromBits(uint64_t bits) {
+    double v;
+    std::memcpy(&v, &bits, sizeof v);
+    return v;
+}
+
+// x must be non-zero
+int leadingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(x);
+#endif
+}
+
+int trailingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+uint64_t lowMask(int bits) {
+    return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+}
+
+// MSB-first bit packing
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void write(uint64_t value, int bits) {
+        if (bits > 32) {
+            write(value >> 32, bits - 32);
+            bits = 32;
+        }
+        acc_ = (acc_ << bits) | (value & lowMask(bits));
+        pending_ += bits;
+        while (pending_ >= 8) {
+            pending_ -= 8;
+            out_.push_back(static_cast<uint8_t>(acc_ >> pending_));
+        }
+    }
+
+    void finish() {
+        if (pending_ > 0) out_.push_back(static_cast<uint8_t>(acc_ << (8 - pending_)));
+        pending_ = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t acc_ = 0;
+    int pending_ = 0;  // bits in acc_ not yet written, < 8 between calls
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : p_(data), end_(data + size) {}
+
+    uint64_t read(int bits) {
+        if (bits > 32) {
+            const uint64_t high = read(bits - 32);
+            return (high << 32) | read(32);
+        }
+        while (avail_ < bits) {
+            if (p_ == end_) {
+                overrun_ = true;
+                buf_ <<= 8;
+            } else {
+                buf_ = (buf_ << 8) | *p_++;
+            }
+            avail_ += 8;
+        }
+        avail_ -= bits;
+        return (buf_ >> avail_) & lowMask(bits);
+    }
+
+    bool ok() const { return !overrun_; }
+    bool atEnd() const { return p_ == end_; }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t buf_ = 0;
+    int avail_ = 0;
+    bool overrun_ = false;
+};
+
+void encodeXor(const double* values, size_t n, std::vector<uint8_t>& out) {
+    if (n == 0) return;
+    BitWriter bits(out);
+    uint64_t prev = toBits(values[0]);
+    bits.write(prev, 64);
+    int prev_lead = 65;  // no window yet
+    int prev_trail = 0;
+    for (size_t i = 1; i < n; ++i) {
+        const uint64_t cur = toBits(values[i]);
+        const uint64_t x = cur ^ prev;
+        prev = cur;
+        if (x == 0) {
+            bits.write(0, 1);
+            continue;
+        }
+        int lead = leadingZeros(x);
+        const int trail = trailingZeros(x);
+        if (lead > 31) lead = 31;  // 5-bit field
+        if (lead >= prev_lead && trail >= prev_trail && prev_lead <= 31) {
+            // Fits the previous window: control bits 10
+            bits.write(0b10, 2);
+            bits.write(x >> prev_trail, 64 - prev_lead - prev_trail);
+        } else {
+            // New window: control bits 11, 5-bit leading zeros, 6-bit length - 1
+            const int sig = 64 - lead - trail;
+            bits.write(0b11, 2);
+            bits.write(static_cast<uint64_t>(lead), 5);
+            bits.write(static_cast<uint64_t>(sig - 1), 6);
+            bits.write(x >> trail, sig);
+            prev_lead = lead;
+            prev_trail = trail;
+        }
+    }
+    bits.finish();
+}
+
+bool decodeXor(const uint8_t* data, size_t size, double* out, size_t n) {
+    if (n == 0) return size == 0;
+    BitReader bits(data, size);
+    uint64_t prev = bits.read(64);
+    out[0] = fromBits(prev);
+    int lead = 0;
+    int trail = 0;
+    bool window = false;
+    for (size_t i = 1; i < n; ++i) {
+        if (bits.read(1) != 0) {
+            if (bits.read(1) != 0) {
+                lead = static_cast<int>(bits.read(5));
+                const int sig = static_cast<int>(bits.read(6)) + 1;
+                trail = 64 - lead - sig;
+                if (trail < 0) return false;
+                window = true;
+            } else if (!window) {
+                return false;
+            }
+            prev ^= bits.read(64 - lead - trail) << trail;
+        }
+        out[i] = fromBits(prev);
+    }
+    return bits.ok() && bits.atEnd();
+}
+
+void encodeDelta(const double* values, size_t n, std::vector<uint8_t>& out) {
+    uint64_t prev = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const uint64_t cur = toBits(values[i]);
+        const auto delta = static_cast<int64_t>(cur - prev);  // wraps
+        prev = cur;
+        uint64_t zz = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+        while (zz >= 0x80) {
+            out.push_back(static_cast<uint8_t>(zz | 0x80));
+            zz >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(zz));
+    }
+}
+
+bool decodeDelta(const uint8_t* data, size_t size, double* out, size_t n) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    uint64_t prev = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t zz = 0;
+        for (int shift = 0;; shift += 7) {
+            if (p == end || shift > 63) return false;
+            const uint8_t byte = *p++;
+            zz |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        const uint64_t delta = (zz >> 1) ^ (~(zz & 1) + 1);
+        prev += delta;
+        out[i] = fromBits(prev);
+    }
+    return p == end;
+}
+
+}  // namespace
+
+void encodeColumn(ColumnEncoding encoding, const double* values, size_t n, std::vector<uint8_t>& out) {
+    switch (encoding) {
+        case ColumnEncoding::kXor:
+            encodeXor(values, n, out);
+            break;
+        case ColumnEncoding::kDelta:
+            encodeDelta(values, n, out);
+            break;
+        case ColumnEncoding::kRaw:
+        default: {
+            const size_t start = out.size();
+            out.resize(start + n * sizeof(double));
+            std::memcpy(out.data() + start, values, n * sizeof(double));
+            break;
+        }
+    }
+}
+
+bool decodeColumn(ColumnEncoding encoding, const uint8_t* data, size_t size, double* out, size_t n) {
+    switch (encoding) {
+        case ColumnEncoding::kRaw:
+            if (size != n * sizeof(double)) return false;
+            if (n) std::memcpy(out, data, size);
+            return true;
+        case ColumnEncoding::kXor:
+            return decodeXor(data, size, out, n);
+        case ColumnEncoding::kDelta:
+            return decodeDelta(data, size, out, n);
+    }
+    return false;
+}
+
+ColumnEncoding encodeColumnSmallest(const double* values, size_t n, std::vector<uint8_t>& out) {
+    thread_local std::vector<uint8_t> xor_bytes;
+    thread_local std::vector<uint8_t> delta_bytes;
+    xor_bytes.clear();
+    delta_bytes.clear();
+    encodeXor(values, n, xor_bytes);
+    encodeDelta(values, n, delta_bytes);
+
+    const std::vector<uint8_t>* best = nullptr;
+    ColumnEncoding encoding = ColumnEncoding::kRaw;
+    size_t best_size = n * sizeof(double);
+    if (xor_bytes.size() < best_size) {
+        best = &xor_bytes;
+        best_size = xor_bytes.size();
+        encoding = ColumnEncoding::kXor;
+    }
+    if (delta_bytes.size() < best_size) {
+        best = &delta_bytes;
+        encoding = ColumnEncoding::kDelta;
+    }
+    if (best) {
+        out.insert(out.end(), best->begin(), best->end());
+    } else {
+        encodeColumn(ColumnEncoding::kRaw, values, n, out);
+    }
+    return encoding;
+}
+
+}  // namespace astvdp
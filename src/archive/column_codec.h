@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace astvdp {
+
+// Lossless encodings for one channel of doubles. All of them round-trip the
+// exact IEEE bit patterns, NaNs included.
+enum class ColumnEncoding : uint8_t {
+    kRaw = 0,    // little-endian doubles
+    kXor = 1,    // Gorilla-style XOR against the previous value, bit-packed
+    kDelta = 2,  // delta of the bit patterns as int64, zigzag + LEB128 varint
+};
+
+// Appends the encoded column to `out`
+void encodeColumn(ColumnEncoding encoding, const double* values, size_t n, std::vector<uint8_t>& out);
+
+// Decodes exactly n values from [data, data + size); false if the bytes are
+// truncated, malformed or not fully consumed
+bool decodeColumn(ColumnEncoding encoding, const uint8_t* data, size_t size, double* out, size_t n);
+
+// Encodes with every compressing encoding and keeps the smallest (raw if
+// nothing beats it); returns the encoding chosen
+ColumnEncoding encodeColumnSmallest(const double* values, size_t n, std::vector<uint8_t>& out);
+
+}  // namespace astvdp
@@ -0,0 +1,64 @@
+#include "batch_manifest.h"
+#include "core/json.h"
+#include <fstream>
+#include <iterator>
+
+namespace astvdp {
+
+bool loadBatchManifest(const std::string& path, BatchManifest& out, std::string& error) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        error = "cannot open manifest: " + path;
+        return false;
+    }
+    const std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    JsonValue root;
+    if (!parseJson(text, root, error)) return false;
+
+    const JsonValue* sessions = &root;
+    if (root.kind == JsonValue::Kind::Object) {
+        if (!readString(root, "db_path", out.db_path)) {
+            error = "\"db_path\" must be a string";
+            return false;
+        }
+        if (const JsonValue* t = member(root, "threads")) {
+            if (t->kind != JsonValue::Kind::Number || t->number < 0) {
+                error = "\"threads\" must be a non-negative number";
+                return false;
+            }
+            out.threads = static_cast<size_t>(t->number);
+        }
+        sessions = member(root, "sessions");
+    }
+    if (!sessions || sessions->kind != JsonValue::Kind::Array) {
+        error = "manifest needs a \"sessions\" array";
+        return false;
+    }
+
+    for (size_t i = 0; i < sessions->array.size(); ++i) {
+        const JsonValue& item = sessions->array[i];
+        BatchSession s;
+        bool ok = item.kind == JsonValue::Kind::Object &&
+                  readString(item, "input", s.input) &&
+                  readBool(item, "simulate", s.simulate) &&
+                  readString(item, "scenario", s.scenario) &&
+                  readString(item, "mission", s.mission_id) &&
+                  readString(item, "aircraft", s.aircraft) &&
+                  readString(item, "output_dir", s.output_dir) &&
+                  readBool(item, "pdf", s.pdf);
+        if (!ok) {
+            error = "session " + std::to_string(i) + ": malformed entry";
+            return false;
+        }
+        if (int{s.simulate} + int{!s.input.empty()} + int{!s.scenario.empty()} != 1) {
+            error = "session " + std::to_string(i) +
+                    ": set exactly one of \"input\", \"simulate\" or \"scenario\"";
+            return false;
+        }
+        out.sessions.push_back(std::move(s));
+    }
+    return true;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+struct BatchSession {
+    std::string input;  // CSV path; unused when simulating
+    bool simulate = false;
+    std::string scenario;  // scenario JSON path; simulates that flight
+    std::string mission_id = "TEST-001";
+    std::string aircraft = "UNKNOWN";
+    std::string output_dir;  // empty: <batch output dir>/session-<n>
+    bool pdf = false;
+};
+
+struct BatchManifest {
+    std::string db_path;  // empty: CLI --db-path or <output dir>/test.db
+    size_t threads = 0;   // 0: CLI --threads or hardware concurrency
+    std::vector<BatchSession> sessions;
+};
+
+// Reads a batch manifest. Accepted layouts:
+//   { "db_path": "...", "threads": 8, "sessions": [ {...}, ... ] }
+//   [ {...}, ... ]
+// where each session object may hold "input", "simulate", "scenario",
+// "mission", "aircraft", "output_dir" and "pdf", with exactly one of the
+// first three.
+bool loadBatchManifest(const std::string& path, BatchManifest& out, std::string& error);
+
+}  // namespace astvdp
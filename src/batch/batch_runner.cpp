@@ -0,0 +1,310 @@
+#include "batch_runner.h"
+#include "core/database.h"
+#include "core/db_writer.h"
+#include "core/profiler.h"
+#include "core/tracer.h"
+#include "core/work_stealing_pool.h"
+#include "ingest/ingest_factory.h"
+#include "ingest/scenario_ingest.h"
+#include "ingest/simulator_ingest.h"
+#include "pipeline/session_runner.h"
+#include "reporting/report_generator.h"
+#include "simulation/flight_simulator.h"
+#include "simulation/scenario.h"
+#include "verification/safety_verifier.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace astvdp {
+
+namespace {
+
+struct SessionOutcome {
+    bool ok = false;
+    int64_t session_id = -1;
+    std::string message;
+};
+
+struct SharedContext {
+    SerializedDbWriter& writer;
+    const SafetyVerifierImpl& limits;  // prototype verifier with limits loaded
+    const std::string& report_template;
+    size_t diag_window;
+    bool spectral;
+    bool axis_drift;
+    const std::string& fusion;
+};
+
+// Session output posted to the shared writer. Rows are copied into blocks
+// from a per-session pool because the pipeline reuses its blocks. Writes run
+// on the writer thread; after the first failure the rest of the session is
+// not written.
+class WriterSink : public SessionSink {
+public:
+    explicit WriterSink(SerializedDbWriter& writer) : writer_(writer) {}
+
+    int64_t beginSession(const std::string& mission_id, const std::string& aircraft) override {
+        session_id_ = writer_.call([&](Database& db) {
+            return db.startSession(mission_id, aircraft);
+        }).get();
+        return session_id_;
+    }
+
+    void writeSamples(const SampleBlock& samples) override {
+        SampleBlock* copy = acquire(samples.size);
+        copy->copyRows(0, samples, 0, samples.size);
+        copy->size = samples.size;
+        writer_.post([this, copy](Database& db) {
+            failed_ = failed_ || !db.appendFlightData(session_id_, *copy);
+            release(copy);
+        });
+    }
+
+    void writeAnomaly(const Anomaly& anomaly) override {
+        writer_.post([this, anomaly](Database& db) {
+            failed_ = failed_ || !db.insertAnomaly(session_id_, anomaly);
+        });
+    }
+
+    void writeEpisode(const AnomalyEpisode& episode) override {
+        writer_.post([this, episode](Database& db) {
+            failed_ = failed_ || !db.insertEpisode(session_id_, episode);
+        });
+    }
+
+    // Waits for this session's writes, which also keeps the pool alive
+    // until the writer is done with it
+    bool finishWrites() override {
+        return writer_.call([this](Database&) { return !failed_; }).get();
+    }
+
+    void endSession(const SessionResult& result) override {
+        if (!result.ok()) {
+            writer_.post([id = session_id_](Database& db) { db.endSession(id, 0.0); });
+            return;
+        }
+        writer_.post([id = session_id_, end = result.last_time, metrics = result.metrics](Database& db) {
+            db.endSession(id, end);
+            db.saveSessionMetrics(id, metrics.stability_index, metrics.sensor_reliability,
+                                  metrics.mission_compliance, metrics.risk_classification);
+        });
+    }
+
+private:
+    SampleBlock* acquire(size_t rows) {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (free_.empty()) {
+            blocks_.push_back(std::make_unique<SampleBlock>(rows));
+            return blocks_.back().get();
+        }
+        SampleBlock* block = free_.back();
+        free_.pop_back();
+        if (block->capacity() < rows) block->reserve(rows);
+        return block;
+    }
+
+    void release(SampleBlock* block) {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        free_.push_back(block);
+    }
+
+    SerializedDbWriter& writer_;
+    int64_t session_id_ = -1;
+    bool failed_ = false;  // written and read on the writer thread only
+    std::mutex pool_mutex_;
+    std::vector<std::unique_ptr<SampleBlock>> blocks_;
+    std::vector<SampleBlock*> free_;
+};
+
+SessionOutcome runSession(const BatchSession& session, const std::string& output_dir,
+                          SharedContext& shared) {
+    SessionOutcome outcome;
+    std::error_code fs_err;
+    std::filesystem::create_directories(output_dir, fs_err);
+    if (fs_err) {
+        outcome.message = "failed to create output directory: " + output_dir;
+        return outcome;
+    }
+
+    const std::string input_path = session.simulate             ? "simulation"
+                                   : !session.scenario.empty() ? session.scenario
+                                                               : session.input;
+    std::unique_ptr<DataIngest> ingest;
+    std::string open_error;
+    if (!session.scenario.empty()) {
+        // Generated inline: sessions already fill the cores
+        Scenario scenario;
+        std::string error;
+        if (!loadScenario(session.scenario, scenario, error)) {
+            outcome.message = "invalid scenario: " + error;
+            return outcome;
+        }
+        ingest = std::make_unique<ScenarioIngest>(scenario, 1);
+        if (!ingest->open({})) {
+            outcome.message = "failed to open input: " + input_path + " (cannot start the scenario)";
+            return outcome;
+        }
+    } else if (session.simulate) {
+        // Generated block by block straight into the pipeline
+        FlightSimulator::Profile prof;
+        prof.duration_sec = 120.0;
+        prof.inject_vibration_fault = true;
+        prof.inject_gnss_dropout = true;
+        ingest = std::make_unique<SimulatorIngest>(prof);
+        if (!ingest->open({})) {
+            outcome.message = "failed to open input: " + input_path + " (cannot start the simulation)";
+            return outcome;
+        }
+    } else {
+        ingest = openIngest(input_path, 1, &open_error);
+    }
+    if (!ingest) {
+        outcome.message = "failed to open input: " + input_path + " (" + open_error + ")";
+        return outcome;
+    }
+
+    // Sessions already run in parallel, so each one runs its stages serially
+    // and hands copies of its rows to the shared writer.
+    SessionConfig config;
+    config.mission_id = session.mission_id;
+    config.aircraft = session.aircraft;
+    config.fusion = shared.fusion;
+    config.diag_window = shared.diag_window;
+    config.spectral = shared.spectral;
+    config.axis_drift = shared.axis_drift;
+    config.threads = 1;
+    config.limits = &shared.limits;
+    WriterSink sink(shared.writer);
+    const SessionResult result = SessionRunner(config).run(*ingest, &sink);
+    ingest->close();
+    outcome.session_id = result.session_id;
+
+    if (result.status == SessionResult::kSessionFailed) {
+        outcome.message = "DB session failed";
+        return outcome;
+    }
+    if (result.status == SessionResult::kNoSamples) {
+        outcome.message = "no valid samples were processed from: " + input_path;
+        return outcome;
+    }
+
+    bool html_ok;
+    {
+        ScopedStageTimer timer(Profiler::kReport);
+        html_ok = ReportGenerator::generateHtmlReport(shared.report_template, output_dir,
+                                                      session.mission_id, session.aircraft,
+                                                      result.duration(), result.metrics,
+                                                      result.anomalies);
+    }
+    if (!html_ok) {
+        outcome.message = "failed to generate HTML report";
+        return outcome;
+    }
+
+    const std::string html_path = (std::filesystem::path(output_dir) / "report.html").string();
+    outcome.message = "report " + html_path;
+    if (session.pdf) {
+        const std::string pdf_path = (std::filesystem::path(output_dir) / "report.pdf").string();
+        bool pdf_ok;
+        {
+            ScopedStageTimer timer(Profiler::kPdf);
+            pdf_ok = ReportGenerator::convertHtmlToPdf(html_path, pdf_path);
+        }
+        if (pdf_ok) {
+            outcome.message += ", pdf " + pdf_path;
+        } else {
+            outcome.message += " (PDF generation failed)";
+        }
+    }
+    outcome.ok = true;
+    return outcome;
+}
+
+}  // namespace
+
+int runBatch(const BatchManifest& manifest, const BatchOptions& options) {
+    const auto wall_start = std::chrono::steady_clock::now();
+    const std::string& output_root = options.output_dir;
+    std::string db_path = !manifest.db_path.empty() ? manifest.db_path : options.db_path;
+    if (db_path.empty()) db_path = (std::filesystem::path(output_root) / "test.db").string();
+
+    size_t threads = manifest.threads ? manifest.threads : options.threads;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, std::max<size_t>(manifest.sessions.size(), 1));
+
+    Database db(db_path);
+    Database::WriteOptions write_opts;
+    write_opts.wal = options.wal;
+    db.setWriteOptions(write_opts);
+    if (!db.open()) {
+        std::cerr << "Failed to open database: " << db_path << "\n";
+        return 1;
+    }
+
+    // Shared, read-only per-process state
+    SafetyVerifierImpl limits;
+    limits.loadLimitsFromDb(db_path);  // falls back to defaults if table is empty/missing
+    const std::string report_template = ReportGenerator::loadTemplate();
+    if (report_template.empty()) {
+        std::cerr << "Report template not found.\n";
+        return 1;
+    }
+
+    std::vector<SessionOutcome> outcomes(manifest.sessions.size());
+    {
+        SerializedDbWriter writer(db);
+        SharedContext shared{writer, limits, report_template, options.diag_window,
+                             options.spectral, options.axis_drift, options.fusion};
+        WorkStealingPool pool(threads);
+        for (size_t i = 0; i < manifest.sessions.size(); ++i) {
+            pool.submit([&, i] {
+                ScopedTrace span("session", "batch");
+                const BatchSession& s = manifest.sessions[i];
+                const std::string dir = !s.output_dir.empty()
+                    ? s.output_dir
+                    : (std::filesystem::path(output_root) / ("session-" + std::to_string(i))).string();
+                outcomes[i] = runSession(s, dir, shared);
+            });
+        }
+        pool.wait();
+        writer.drain();
+    }
+
+    size_t failed = 0;
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        const auto& o = outcomes[i];
+        const auto& s = manifest.sessions[i];
+        if (o.ok) {
+            std::cout << "[" << s.mission_id << "] Session ID " << o.session_id << ": " << o.message << "\n";
+        } else {
+            ++failed;
+            std::cerr << "[" << s.mission_id << "] Failed: " << o.message << "\n";
+        }
+    }
+    if (options.profile) {
+        const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wall_start;
+        const auto report = Profiler::collect(wall.count());
+        Profiler::print(report, std::cout);
+        std::error_code fs_err;
+        std::filesystem::create_directories(output_root, fs_err);
+        const std::string profile_path = (std::filesystem::path(output_root) / "profile.json").string();
+        if (Profiler::writeJson(report, profile_path)) {
+            std::cout << "Profile: " << profile_path << "\n";
+        } else {
+            std::cerr << "Failed to write profile: " << profile_path << "\n";
+        }
+    }
+
+    std::cout << "Done. Batch sessions: " << (outcomes.size() - failed) << " ok, "
+              << failed << " failed (" << threads << " threads)\n";
+    return failed == 0 ? 0 : 1;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,26 @@
+#pragma once
+#include "batch/batch_manifest.h"
+#include "diagnostics/diagnostic_engine.h"
+#include <cstddef>
+#include <string>
+
+namespace astvdp {
+
+struct BatchOptions {
+    std::string db_path;
+    std::string output_dir = "output";
+    size_t threads = 0;  // 0: hardware concurrency
+    size_t diag_window = DiagnosticEngine::kDefaultWindowSize;
+    bool spectral = false;    // Welch PSD band-energy diagnostics
+    bool axis_drift = false;  // bias drift on imu_ax/ay and the gyro axes
+    std::string fusion = "complementary";
+    bool profile = false;  // write <output_dir>/profile.json for the whole batch
+    bool wal = false;      // switch the database to journal_mode=WAL
+};
+
+// Runs every manifest session inside this process on a work-stealing pool.
+// Safety limits and the report template are loaded once and shared; all DB
+// writes go through one serialized writer. Returns the process exit code.
+int runBatch(const BatchManifest& manifest, const BatchOptions& options);
+
+}  // namespace astvdp
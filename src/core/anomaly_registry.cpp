@@ -0,0 +1,76 @@
+#include "astvdp/anomaly_registry.h"
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+
+namespace astvdp {
+
+namespace {
+
+const AnomalyDescriptor kBuiltins[anomaly_ids::kBuiltinCount] = {
+    {"limit_breach", "roll_rate", "Rate out of bounds"},
+    {"limit_breach", "pitch_rate", "Rate out of bounds"},
+    {"limit_breach", "yaw_rate", "Rate out of bounds"},
+    {"limit_breach", "dynamic_pressure", "q outside envelope"},
+    {"limit_breach", "altitude", "Altitude out of range"},
+    {"limit_breach", "temperature", "Temp out of spec"},
+    {"vibration_excess", "vibration", "RMS vibration exceeds threshold"},
+    {"gnss_dropout", "gps", "GNSS signal lost >1s"},
+    {"vibration_buildup", "vib_z", "Vibration RMS rising rapidly"},
+    {"imu_bias_drift", "imu_az", "Accelerometer Z bias drifting"},
+    {"vibration_buildup", "vib_x", "Vibration RMS rising rapidly"},
+    {"vibration_buildup", "vib_y", "Vibration RMS rising rapidly"},
+    {"imu_bias_drift", "imu_ax", "Accelerometer X bias drifting"},
+    {"imu_bias_drift", "imu_ay", "Accelerometer Y bias drifting"},
+    {"imu_bias_drift", "imu_gx", "Gyro X bias drifting"},
+    {"imu_bias_drift", "imu_gy", "Gyro Y bias drifting"},
+    {"imu_bias_drift", "imu_gz", "Gyro Z bias drifting"},
+    {"gnss_intermittent", "gps", "GNSS fix repeatedly lost"},
+};
+
+struct DynamicTable {
+    std::mutex mutex;
+    std::deque<AnomalyDescriptor> entries;  // deque: references stay valid on growth
+};
+
+DynamicTable& dynamicTable() {
+    static DynamicTable table;
+    return table;
+}
+
+bool sameStrings(const AnomalyDescriptor& d, const std::string& type,
+                 const std::string& param, const std::string& details) {
+    return d.type == type && d.param == param && d.details == details;
+}
+
+}  // namespace
+
+AnomalyId AnomalyRegistry::intern(const std::string& type, const std::string& param,
+                                  const std::string& details) {
+    for (AnomalyId id = 0; id < anomaly_ids::kBuiltinCount; ++id) {
+        if (sameStrings(kBuiltins[id], type, param, details)) return id;
+    }
+
+    DynamicTable& table = dynamicTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    for (size_t i = 0; i < table.entries.size(); ++i) {
+        if (sameStrings(table.entries[i], type, param, details)) {
+            return static_cast<AnomalyId>(anomaly_ids::kBuiltinCount + i);
+        }
+    }
+    if (anomaly_ids::kBuiltinCount + table.entries.size() > UINT16_MAX) {
+        throw std::length_error("AnomalyRegistry: descriptor table full");
+    }
+    table.entries.push_back({type, param, details});
+    return static_cast<AnomalyId>(anomaly_ids::kBuiltinCount + table.entries.size() - 1);
+}
+
+const AnomalyDescriptor& AnomalyRegistry::describe(AnomalyId id) {
+    if (id < anomaly_ids::kBuiltinCount) return kBuiltins[id];
+
+    DynamicTable& table = dynamicTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.entries.at(id - anomaly_ids::kBuiltinCount);
+}
+
+}  // namespace astvdp
@@ -0,0 +1,47 @@
+#include "cpu_features.h"
+
+#if defined(ASTVDP_X86) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace astvdp {
+
+namespace {
+#ifdef ASTVDP_X86
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;  // OS saves YMM state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+}  // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef ASTVDP_X86
+    static const SimdLevel level = cpuHasAvx2() ? SimdLevel::Avx2 : SimdLevel::Sse2;
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Sse2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+}  // namespace astvdp
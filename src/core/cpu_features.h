@@ -0,0 +1,23 @@
+#pragma once
+
+// Kernel translation units include <immintrin.h> under ASTVDP_X86 and mark
+// AVX2 functions with ASTVDP_TARGET_AVX2 so the rest of the build stays baseline
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ASTVDP_X86 1
+#endif
+
+#if defined(ASTVDP_X86) && (defined(__GNUC__) || defined(__clang__))
+#define ASTVDP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define ASTVDP_TARGET_AVX2
+#endif
+
+namespace astvdp {
+
+// Instruction-set tiers used by the runtime-dispatched SIMD kernels
+enum class SimdLevel { Scalar, Sse2, Avx2 };
+
+SimdLevel detectSimdLevel();  // best level supported by this CPU and OS
+const char* simdLevelName(SimdLevel level);
+
+}  // namespace astvdp
@@ -1,5 +1,7 @@
 #include "database.h"
 #include "astvdp/sqlite_compat.h"
+#include "profiler.h"
+#include "tracer.h"
 #include <ctime>
 #include <filesystem>
 #include <string>
@@ -29,7 +31,7 @@ bool Database::open() {
 
     sqlite3_exec(db_, "PRAGMA foreign_keys = ON;", nullptr, nullptr, nullptr);
 
-    if (!initializeSchema()) {
+    if (!applyJournalMode() || !initializeSchema()) {
         close();
         return false;
     }
@@ -39,11 +41,43 @@ bool Database::open() {
 
 void Database::close() {
     if (db_) {
+        flush();
+        sqlite3_finalize(flight_data_stmt_);
+        sqlite3_finalize(anomaly_stmt_);
+        flight_data_stmt_ = nullptr;
+        anomaly_stmt_ = nullptr;
         sqlite3_close(db_);
         db_ = nullptr;
     }
 }
 
+void Database::setWriteOptions(const WriteOptions& options) {
+    write_options_ = options;
+    if (write_options_.max_rows == 0) write_options_.max_rows = 1;
+    if (db_) applyJournalMode();
+}
+
+bool Database::applyJournalMode() {
+    if (!write_options_.wal) return true;
+    int rc = sqlite3_exec(db_, "PRAGMA journal_mode = WAL;", nullptr, nullptr, nullptr);
+    if (rc != SQLITE_OK) return false;
+    rc = sqlite3_exec(db_, "PRAGMA synchronous = NORMAL;", nullptr, nullptr, nullptr);
+    return (rc == SQLITE_OK);
+}
+
+sqlite3_stmt* Database::cachedStatement(sqlite3_stmt*& slot, const char* sql) {
+    if (slot) {
+        sqlite3_reset(slot);
+        sqlite3_clear_bindings(slot);
+        return slot;
+    }
+    if (sqlite3_prepare_v2(db_, sql, -1, &slot, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(slot);
+        slot = nullptr;
+    }
+    return slot;
+}
+
 int64_t Database::startSession(const std::string& mission_id, const std::string& aircraft) {
     const char* sql = "INSERT INTO flight_sessions (mission_id, start_time, aircraft_type) VALUES (?, ?, ?);";
     sqlite3_stmt* stmt;
@@ -61,6 +95,8 @@ int64_t Database::startSession(const std::string& mission_id, const std::string&
 }
 
 bool Database::endSession(int64_t session_id, double end_time) {
+    if (!flush()) return false;
+
     const char* sql = "UPDATE flight_sessions SET end_time = ? WHERE id = ?;";
     sqlite3_stmt* stmt;
     int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
@@ -74,6 +110,76 @@ bool Database::endSession(int64_t session_id, double end_time) {
 }
 
 bool Database::insertFlightData(int64_t session_id, const TimestampedSample& s) {
+    return writeFlightData(session_id, s);
+}
+
+template <typename RowAt>
+bool Database::appendRows(int64_t session_id, size_t count, RowAt row_at) {
+    // A batch holds one session's rows, so sessions sharing the connection
+    // never commit or lose each other's rows
+    if (in_batch_ && session_id != batch_session_id_ && !flush()) return false;
+    for (size_t i = 0; i < count;) {
+        if (!in_batch_) {
+            if (sqlite3_exec(db_, "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+            in_batch_ = true;
+            batch_session_id_ = session_id;
+            batch_rows_ = 0;
+            batch_start_time_ = row_at(i).timestamp;
+            if (Tracer::enabled()) batch_begin_ = Tracer::Clock::now();
+        }
+
+        // This call's rows sit under a savepoint: a failed row drops only
+        // them, not the anomalies and episodes already pending in the batch
+        if (sqlite3_exec(db_, "SAVEPOINT append_rows;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+        const size_t rows_before = batch_rows_;
+        bool full = false;
+        for (; i < count && !full; ++i) {
+            const TimestampedSample s = row_at(i);
+            if (!writeFlightData(session_id, s)) {
+                sqlite3_exec(db_, "ROLLBACK TO append_rows; RELEASE append_rows;", nullptr, nullptr, nullptr);
+                batch_rows_ = rows_before;
+                return false;
+            }
+            ++batch_rows_;
+            const double span_ms = (s.timestamp - batch_start_time_) * 1000.0;
+            full = batch_rows_ >= write_options_.max_rows || span_ms >= write_options_.max_span_ms;
+        }
+        if (sqlite3_exec(db_, "RELEASE append_rows;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+        if (full && !flush()) return false;
+    }
+    return true;
+}
+
+bool Database::appendFlightData(int64_t session_id, const TimestampedSample& s) {
+    return appendRows(session_id, 1, [&s](size_t) { return s; });
+}
+
+bool Database::appendFlightData(int64_t session_id, const SampleBlock& block) {
+    return appendRows(session_id, block.size, [&block](size_t i) { return block.get(i); });
+}
+
+bool Database::flush() {
+    if (!in_batch_) return true;
+    const size_t rows = batch_rows_;
+    in_batch_ = false;
+    batch_rows_ = 0;
+    bool ok;
+    {
+        ScopedStageTimer timer(Profiler::kDbCommit);
+        ok = sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+    }
+    if (Tracer::enabled()) {
+        Tracer::complete("db_transaction", "db", batch_begin_, Tracer::Clock::now(),
+                         static_cast<int64_t>(rows));
+    }
+    if (!ok) {
+        sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return true;
+}
+
+bool Database::writeFlightData(int64_t session_id, const TimestampedSample& s) {
     const char* sql =
         "INSERT INTO flight_data (session_id, timestamp, "
         "imu_ax,imu_ay,imu_az,imu_gx,imu_gy,imu_gz,"
@@ -81,9 +187,8 @@ bool Database::insertFlightData(int64_t session_id, const TimestampedSample& s)
         "static_pressure,temperature,vibration_x,vibration_y,vibration_z) "
         "VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) return false;
+    sqlite3_stmt* stmt = cachedStatement(flight_data_stmt_, sql);
+    if (!stmt) return false;
 
     auto bind = [&](int i, double v) { sqlite3_bind_double(stmt, i, v); };
     sqlite3_bind_int64(stmt, 1, session_id);
@@ -95,24 +200,31 @@ bool Database::insertFlightData(int64_t session_id, const TimestampedSample& s)
     bind(14, s.static_pressure); bind(15, s.temperature);
     bind(16, s.vib_x); bind(17, s.vib_y); bind(18, s.vib_z);
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-    return (rc == SQLITE_DONE);
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    if (rc != SQLITE_DONE) return false;
+    Profiler::count(Profiler::kDbRows, 1);
+    return true;
 }
 
 bool Database::insertAnomaly(int64_t session_id, const Anomaly& a) {
+    return insertEpisode(session_id, AnomalyEpisode::single(a));
+}
+
+bool Database::insertEpisode(int64_t session_id, const AnomalyEpisode& a) {
     const char* sql =
-        "INSERT INTO anomalies (session_id, timestamp, type, param_affected, severity, details) "
-        "VALUES (?, ?, ?, ?, ?, ?);";
+        "INSERT INTO anomalies (session_id, timestamp, type, param_affected, severity, details, "
+        "end_time, sample_count, peak_value) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) return false;
+    sqlite3_stmt* stmt = cachedStatement(anomaly_stmt_, sql);
+    if (!stmt) return false;
 
+    const AnomalyDescriptor& desc = a.describe();
     sqlite3_bind_int64(stmt, 1, session_id);
-    sqlite3_bind_double(stmt, 2, a.timestamp);
-    sqlite3_bind_text(stmt, 3, a.type.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 4, a.param.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_double(stmt, 2, a.start_time);
+    sqlite3_bind_text(stmt, 3, desc.type.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 4, desc.param.c_str(), -1, SQLITE_STATIC);
     const char* sev_str = "observation";
     switch (a.severity) {
         case Severity::Critical: sev_str = "critical"; break;
@@ -121,10 +233,13 @@ bool Database::insertAnomaly(int64_t session_id, const Anomaly& a) {
         default: sev_str = "observation";
     }
     sqlite3_bind_text(stmt, 5, sev_str, -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 6, a.details.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 6, desc.details.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_double(stmt, 7, a.end_time);
+    sqlite3_bind_int64(stmt, 8, a.count);
+    sqlite3_bind_double(stmt, 9, a.peak);
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
     return (rc == SQLITE_DONE);
 }
 
@@ -190,6 +305,9 @@ CREATE TABLE IF NOT EXISTS anomalies (
     param_affected TEXT,
     severity TEXT,
     details TEXT,
+    end_time REAL,
+    sample_count INTEGER DEFAULT 1,
+    peak_value REAL,
     FOREIGN KEY(session_id) REFERENCES flight_sessions(id)
 );
 
@@ -219,6 +337,19 @@ CREATE TABLE IF NOT EXISTS session_metrics (
         return false;
     }
 
+    // Databases created before anomaly episodes lack the episode columns
+    sqlite3_stmt* stmt;
+    rc = sqlite3_prepare_v2(db_, "SELECT end_time FROM anomalies LIMIT 0;", -1, &stmt, nullptr);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_OK) {
+        static const char* kEpisodeColumnsSql =
+            "ALTER TABLE anomalies ADD COLUMN end_time REAL;"
+            "ALTER TABLE anomalies ADD COLUMN sample_count INTEGER DEFAULT 1;"
+            "ALTER TABLE anomalies ADD COLUMN peak_value REAL;";
+        rc = sqlite3_exec(db_, kEpisodeColumnsSql, nullptr, nullptr, nullptr);
+        if (rc != SQLITE_OK) return false;
+    }
+
     return true;
 }
 
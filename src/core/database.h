@@ -1,19 +1,33 @@
 #pragma once
+#include <chrono>
+#include <cstddef>
 #include <string>
 #include <vector>
 #include "astvdp/types.h"
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace astvdp {
 
 class Database {
 public:
+    // Batched writer settings. A flight_data batch is committed once it holds
+    // max_rows samples or spans max_span_ms of sample time, whichever comes first.
+    // WAL changes the database file's journal mode for every later reader and
+    // writer, so it is opt-in (--wal).
+    struct WriteOptions {
+        size_t max_rows = 4096;
+        double max_span_ms = 1000.0;
+        bool wal = false;  // journal_mode=WAL with synchronous=NORMAL
+    };
+
     explicit Database(const std::string& path);
     ~Database();
 
     bool open();
     void close();
+    void setWriteOptions(const WriteOptions& options);
 
     // Flight session
     int64_t startSession(const std::string& mission_id, const std::string& aircraft);
@@ -22,6 +36,17 @@ public:
     // Data & anomalies
     bool insertFlightData(int64_t session_id, const TimestampedSample& sample);
     bool insertAnomaly(int64_t session_id, const Anomaly& anomaly);
+    bool insertEpisode(int64_t session_id, const AnomalyEpisode& episode);
+
+    // Batched data path: rows are grouped into transactions; flush() commits
+    // whatever is pending (endSession and close flush implicitly). If a row
+    // fails to insert, the call returns false and drops the rows it added
+    // since the batch last committed; anomalies, episodes and rows from
+    // earlier calls stay pending. Rows for another session commit the
+    // pending batch first.
+    bool appendFlightData(int64_t session_id, const TimestampedSample& sample);
+    bool appendFlightData(int64_t session_id, const SampleBlock& block);
+    bool flush();
 
     // Metrics
     bool saveSessionMetrics(int64_t session_id, double stability, double reliability,
@@ -29,9 +54,23 @@ public:
 
 private:
     bool initializeSchema();
+    bool applyJournalMode();
+    sqlite3_stmt* cachedStatement(sqlite3_stmt*& slot, const char* sql);
+    bool writeFlightData(int64_t session_id, const TimestampedSample& sample);
+    template <typename RowAt>
+    bool appendRows(int64_t session_id, size_t count, RowAt row_at);
 
     std::string path_;
     sqlite3* db_ = nullptr;
+
+    WriteOptions write_options_;
+    sqlite3_stmt* flight_data_stmt_ = nullptr;
+    sqlite3_stmt* anomaly_stmt_ = nullptr;
+    bool in_batch_ = false;
+    int64_t batch_session_id_ = -1;
+    size_t batch_rows_ = 0;
+    double batch_start_time_ = 0.0;
+    std::chrono::steady_clock::time_point batch_begin_;  // wall clock, for --trace
 };
 
 }  // namespace astvdp
@@ -0,0 +1,58 @@
+#include "db_writer.h"
+#include "tracer.h"
+
+namespace astvdp {
+
+SerializedDbWriter::SerializedDbWriter(Database& db, size_t max_queued)
+    : db_(db), max_queued_(max_queued ? max_queued : 1), thread_([this] { run(); }) {}
+
+SerializedDbWriter::~SerializedDbWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    not_empty_.notify_all();
+    thread_.join();
+}
+
+void SerializedDbWriter::post(std::function<void(Database&)> write) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return queue_.size() < max_queued_; });
+        queue_.push_back(std::move(write));
+    }
+    not_empty_.notify_one();
+}
+
+void SerializedDbWriter::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+void SerializedDbWriter::run() {
+    Tracer::setThreadName("db-writer");
+    for (;;) {
+        std::function<void(Database&)> write;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_empty_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                // Stopping: commit whatever the last writes left pending
+                db_.flush();
+                return;
+            }
+            write = std::move(queue_.front());
+            queue_.pop_front();
+            busy_ = true;
+        }
+        not_full_.notify_one();
+
+        write(db_);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        busy_ = false;
+        if (queue_.empty()) drained_.notify_all();
+    }
+}
+
+}  // namespace astvdp
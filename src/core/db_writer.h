@@ -0,0 +1,55 @@
+#pragma once
+#include "core/database.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace astvdp {
+
+// Owns a Database and applies every write on one dedicated thread, so many
+// concurrent sessions can share a single SQLite connection and its batched
+// transactions. The queue is bounded: producers block when it is full.
+class SerializedDbWriter {
+public:
+    explicit SerializedDbWriter(Database& db, size_t max_queued = 64);
+    ~SerializedDbWriter();
+
+    SerializedDbWriter(const SerializedDbWriter&) = delete;
+    SerializedDbWriter& operator=(const SerializedDbWriter&) = delete;
+
+    // Fire-and-forget write, applied in submission order
+    void post(std::function<void(Database&)> write);
+
+    // Write whose result the caller needs (e.g. a new session id)
+    template <typename Fn>
+    auto call(Fn&& fn) -> std::future<decltype(fn(std::declval<Database&>()))> {
+        using R = decltype(fn(std::declval<Database&>()));
+        auto task = std::make_shared<std::packaged_task<R(Database&)>>(std::forward<Fn>(fn));
+        auto result = task->get_future();
+        post([task](Database& db) { (*task)(db); });
+        return result;
+    }
+
+    void drain();  // blocks until everything posted so far has been applied
+
+private:
+    void run();
+
+    Database& db_;
+    const size_t max_queued_;
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::condition_variable drained_;
+    std::deque<std::function<void(Database&)>> queue_;
+    bool busy_ = false;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+}  // namespace astvdp
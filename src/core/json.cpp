@@ -0,0 +1,185 @@
+#include "json.h"
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+namespace astvdp {
+
+namespace {
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : s_(text) {}
+
+    bool parse(JsonValue& out, std::string& error) {
+        if (!parseValue(out, 0) || (skipWs(), pos_ != s_.size())) {
+            error = "invalid JSON near offset " + std::to_string(pos_);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr int kMaxDepth = 32;
+
+    void skipWs() {
+        while (pos_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[pos_]))) ++pos_;
+    }
+
+    bool consume(char c) {
+        skipWs();
+        if (pos_ < s_.size() && s_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool literal(const char* word) {
+        size_t n = std::char_traits<char>::length(word);
+        if (s_.compare(pos_, n, word) != 0) return false;
+        pos_ += n;
+        return true;
+    }
+
+    bool parseValue(JsonValue& v, int depth) {
+        if (depth > kMaxDepth) return false;
+        skipWs();
+        if (pos_ >= s_.size()) return false;
+        char c = s_[pos_];
+        if (c == '{') return parseObject(v, depth);
+        if (c == '[') return parseArray(v, depth);
+        if (c == '"') {
+            v.kind = JsonValue::Kind::String;
+            return parseString(v.string);
+        }
+        if (literal("true")) { v.kind = JsonValue::Kind::Bool; v.boolean = true; return true; }
+        if (literal("false")) { v.kind = JsonValue::Kind::Bool; v.boolean = false; return true; }
+        if (literal("null")) { v.kind = JsonValue::Kind::Null; return true; }
+
+        const char* begin = s_.c_str() + pos_;
+        char* end = nullptr;
+        v.number = std::strtod(begin, &end);
+        if (end == begin) return false;
+        v.kind = JsonValue::Kind::Number;
+        pos_ += static_cast<size_t>(end - begin);
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        ++pos_;  // opening quote
+        while (pos_ < s_.size()) {
+            char c = s_[pos_++];
+            if (c == '"') return true;
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            if (pos_ >= s_.size()) return false;
+            char e = s_[pos_++];
+            switch (e) {
+                case '"': case '\\': case '/': out.push_back(e); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u': {
+                    if (pos_ + 4 > s_.size()) return false;
+                    unsigned long cp = std::strtoul(s_.substr(pos_, 4).c_str(), nullptr, 16);
+                    pos_ += 4;
+                    // BMP only; documents hold paths and identifiers
+                    if (cp < 0x80) {
+                        out.push_back(static_cast<char>(cp));
+                    } else if (cp < 0x800) {
+                        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                    } else {
+                        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                    }
+                    break;
+                }
+                default: return false;
+            }
+        }
+        return false;
+    }
+
+    bool parseArray(JsonValue& v, int depth) {
+        ++pos_;
+        v.kind = JsonValue::Kind::Array;
+        if (consume(']')) return true;
+        do {
+            v.array.emplace_back();
+            if (!parseValue(v.array.back(), depth + 1)) return false;
+        } while (consume(','));
+        return consume(']');
+    }
+
+    bool parseObject(JsonValue& v, int depth) {
+        ++pos_;
+        v.kind = JsonValue::Kind::Object;
+        if (consume('}')) return true;
+        do {
+            skipWs();
+            std::string key;
+            if (pos_ >= s_.size() || s_[pos_] != '"' || !parseString(key)) return false;
+            if (!consume(':')) return false;
+            if (!parseValue(v.object[key], depth + 1)) return false;
+        } while (consume(','));
+        return consume('}');
+    }
+
+    const std::string& s_;
+    size_t pos_ = 0;
+};
+
+}  // namespace
+
+bool parseJson(const std::string& text, JsonValue& out, std::string& error) {
+    return JsonParser(text).parse(out, error);
+}
+
+bool loadJsonFile(const std::string& path, JsonValue& out, std::string& error) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+    const std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    return parseJson(text, out, error);
+}
+
+const JsonValue* member(const JsonValue& obj, const char* key) {
+    auto it = obj.object.find(key);
+    return (it != obj.object.end()) ? &it->second : nullptr;
+}
+
+bool readString(const JsonValue& obj, const char* key, std::string& out) {
+    const JsonValue* v = member(obj, key);
+    if (!v) return true;
+    if (v->kind != JsonValue::Kind::String) return false;
+    out = v->string;
+    return true;
+}
+
+bool readBool(const JsonValue& obj, const char* key, bool& out) {
+    const JsonValue* v = member(obj, key);
+    if (!v) return true;
+    if (v->kind != JsonValue::Kind::Bool) return false;
+    out = v->boolean;
+    return true;
+}
+
+bool readNumber(const JsonValue& obj, const char* key, double& out) {
+    const JsonValue* v = member(obj, key);
+    if (!v) return true;
+    if (v->kind != JsonValue::Kind::Number) return false;
+    out = v->number;
+    return true;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,32 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+// Minimal JSON document model; enough for manifests and scenario files, not
+// a general library.
+struct JsonValue {
+    enum class Kind { Null, Bool, Number, String, Array, Object } kind = Kind::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::map<std::string, JsonValue> object;
+};
+
+bool parseJson(const std::string& text, JsonValue& out, std::string& error);
+// Reads and parses a whole file; `error` names the file if it cannot be read
+bool loadJsonFile(const std::string& path, JsonValue& out, std::string& error);
+
+// Object member, or nullptr
+const JsonValue* member(const JsonValue& obj, const char* key);
+
+// Optional members: true and `out` untouched when the key is absent, false
+// when it holds another kind of value
+bool readString(const JsonValue& obj, const char* key, std::string& out);
+bool readBool(const JsonValue& obj, const char* key, bool& out);
+bool readNumber(const JsonValue& obj, const char* key, double& out);
+
+}  // namespace astvdp
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace astvdp {
+
+// Read-only memory mapping of a whole file. Empty files open successfully
+// with size() == 0 and data() == nullptr.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return open_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+}  // namespace astvdp
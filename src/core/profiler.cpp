@@ -0,0 +1,158 @@
+#include "profiler.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace astvdp {
+
+namespace {
+
+// Written only by its owning thread; relaxed atomics keep collect() race-free
+struct ThreadSlot {
+    std::array<std::atomic<uint64_t>, Profiler::kStageCount> ns{};
+    std::array<std::atomic<uint64_t>, Profiler::kStageCount> calls{};
+    std::array<std::atomic<uint64_t>, Profiler::kCounterCount> counters{};
+};
+
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<ThreadSlot>> registry;  // slots outlive their threads
+
+ThreadSlot& localSlot() {
+    thread_local ThreadSlot* slot = nullptr;
+    if (!slot) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(std::make_unique<ThreadSlot>());
+        slot = registry.back().get();
+    }
+    return *slot;
+}
+
+void bump(std::atomic<uint64_t>& value, uint64_t n) {
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+double perSecond(uint64_t n, double seconds) {
+    return seconds > 0.0 ? static_cast<double>(n) / seconds : 0.0;
+}
+
+// Fraction of wall time the stage was busy. Stages on different threads
+// overlap and db_commit nests inside persist, so these do not sum to 1.
+double busy(const Profiler::Report& report, Profiler::Stage stage) {
+    return perSecond(report.stages[stage].ns, report.wall_seconds) * 1e-9;
+}
+
+}  // namespace
+
+void Profiler::addTime(Stage stage, uint64_t ns) {
+    ThreadSlot& slot = localSlot();
+    bump(slot.ns[stage], ns);
+    bump(slot.calls[stage], 1);
+}
+
+void Profiler::addCount(Counter counter, uint64_t n) {
+    bump(localSlot().counters[counter], n);
+}
+
+Profiler::Report Profiler::collect(double wall_seconds) {
+    Report report;
+    report.wall_seconds = wall_seconds;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (const auto& slot : registry) {
+        for (size_t s = 0; s < kStageCount; ++s) {
+            report.stages[s].ns += slot->ns[s].load(std::memory_order_relaxed);
+            report.stages[s].calls += slot->calls[s].load(std::memory_order_relaxed);
+        }
+        for (size_t c = 0; c < kCounterCount; ++c) {
+            report.counters[c] += slot->counters[c].load(std::memory_order_relaxed);
+        }
+    }
+    return report;
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (const auto& slot : registry) {
+        for (auto& v : slot->ns) v.store(0, std::memory_order_relaxed);
+        for (auto& v : slot->calls) v.store(0, std::memory_order_relaxed);
+        for (auto& v : slot->counters) v.store(0, std::memory_order_relaxed);
+    }
+}
+
+const char* Profiler::stageName(Stage stage) {
+    static const char* const kNames[kStageCount] = {
+        "ingest", "fusion", "verify", "diagnose", "episodes", "persist", "db_commit", "report", "pdf"};
+    return stage < kStageCount ? kNames[stage] : "unknown";
+}
+
+const char* Profiler::stageCategory(Stage stage) {
+    switch (stage) {
+        case kPersist:
+        case kDbCommit:
+            return "db";
+        case kReport:
+        case kPdf:
+            return "report";
+        default:
+            return "pipeline";
+    }
+}
+
+const char* Profiler::counterName(Counter counter) {
+    static const char* const kNames[kCounterCount] = {"samples", "anomalies", "db_rows", "bytes_parsed"};
+    return counter < kCounterCount ? kNames[counter] : "unknown";
+}
+
+void Profiler::print(const Report& report, std::ostream& out) {
+    char line[128];
+    std::snprintf(line, sizeof line, "Profile (wall %.3f s; stage times summed over threads):\n",
+                  report.wall_seconds);
+    out << line;
+    std::snprintf(line, sizeof line, "  %-10s %10s %8s %7s\n", "stage", "seconds", "calls", "busy");
+    out << line;
+    for (size_t s = 0; s < kStageCount; ++s) {
+        const StageTotals& t = report.stages[s];
+        if (t.calls == 0) continue;
+        std::snprintf(line, sizeof line, "  %-10s %10.4f %8llu %6.1f%%\n",
+                      stageName(static_cast<Stage>(s)), static_cast<double>(t.ns) * 1e-9,
+                      static_cast<unsigned long long>(t.calls),
+                      100.0 * busy(report, static_cast<Stage>(s)));
+        out << line;
+    }
+    for (size_t c = 0; c < kCounterCount; ++c) {
+        const uint64_t n = report.counters[c];
+        std::snprintf(line, sizeof line, "  %-12s %12llu (%.0f/s)\n",
+                      counterName(static_cast<Counter>(c)), static_cast<unsigned long long>(n),
+                      perSecond(n, report.wall_seconds));
+        out << line;
+    }
+}
+
+bool Profiler::writeJson(const Report& report, const std::string& path) {
+    std::ofstream file(path);
+    if (!file) return false;
+    char buf[160];
+    std::snprintf(buf, sizeof buf, "{\n  \"wall_seconds\": %.6f,\n", report.wall_seconds);
+    file << buf;
+    for (size_t c = 0; c < kCounterCount; ++c) {
+        const char* name = counterName(static_cast<Counter>(c));
+        const uint64_t n = report.counters[c];
+        std::snprintf(buf, sizeof buf, "  \"%s\": %llu,\n  \"%s_per_sec\": %.1f,\n", name,
+                      static_cast<unsigned long long>(n), name, perSecond(n, report.wall_seconds));
+        file << buf;
+    }
+    file << "  \"stages\": {";
+    for (size_t s = 0; s < kStageCount; ++s) {
+        const StageTotals& t = report.stages[s];
+        std::snprintf(buf, sizeof buf, "%s\n    \"%s\": {\"seconds\": %.6f, \"calls\": %llu, \"busy\": %.4f}",
+                      s ? "," : "", stageName(static_cast<Stage>(s)), static_cast<double>(t.ns) * 1e-9,
+                      static_cast<unsigned long long>(t.calls), busy(report, static_cast<Stage>(s)));
+        file << buf;
+    }
+    file << "\n  }\n}\n";
+    return static_cast<bool>(file);
+}
+
+}  // namespace astvdp
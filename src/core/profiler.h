@@ -0,0 +1,105 @@
+#pragma once
+#include "tracer.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace astvdp {
+
+// Process-wide stage timers and counters for --profile. Each thread adds to
+// its own slot (no sharing, no locks on the hot path); collect() sums the
+// slots once the work has finished. While disabled every hook is a single
+// relaxed load and branch, and hooks sit at block granularity, not per row.
+class Profiler {
+public:
+    enum Stage : uint8_t {
+        kIngest,       // CSV parsing into SampleBlocks
+        kFusion,
+        kVerify,       // safety envelope checks
+        kDiagnose,     // rolling-window and spectral diagnostics
+        kEpisodes,     // merge and episode coalescing
+        kPersist,      // session sink: DB inserts (and copies in batch mode)
+        kDbCommit,     // flight_data transaction commits
+        kReport,       // HTML report
+        kPdf,          // wkhtmltopdf
+        kStageCount
+    };
+
+    enum Counter : uint8_t {
+        kSamples,
+        kAnomalies,    // raw anomalies, before coalescing
+        kDbRows,       // flight_data rows written
+        kBytesParsed,  // CSV bytes consumed by ingest
+        kCounterCount
+    };
+
+    struct StageTotals {
+        uint64_t ns = 0;
+        uint64_t calls = 0;
+    };
+
+    struct Report {
+        double wall_seconds = 0.0;
+        std::array<StageTotals, kStageCount> stages{};
+        std::array<uint64_t, kCounterCount> counters{};
+    };
+
+    static void enable(bool on) { enabled_.store(on, std::memory_order_relaxed); }
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static void count(Counter counter, uint64_t n) {
+        if (enabled()) addCount(counter, n);
+    }
+    static void addTime(Stage stage, uint64_t ns);
+
+    // Sums every thread's slot; call after the profiled threads have finished
+    static Report collect(double wall_seconds);
+    static void reset();
+
+    static const char* stageName(Stage stage);
+    static const char* stageCategory(Stage stage);  // trace category
+    static const char* counterName(Counter counter);
+
+    static void print(const Report& report, std::ostream& out);
+    static bool writeJson(const Report& report, const std::string& path);
+
+private:
+    static void addCount(Counter counter, uint64_t n);
+
+    static inline std::atomic<bool> enabled_{false};
+};
+
+// Adds the lifetime of the scope to one stage and, while tracing, records it
+// as a span named after the stage; free when both are off
+class ScopedStageTimer {
+public:
+    explicit ScopedStageTimer(Profiler::Stage stage)
+        : stage_(stage), profiling_(Profiler::enabled()), tracing_(Tracer::enabled()) {
+        if (profiling_ || tracing_) start_ = std::chrono::steady_clock::now();
+    }
+    ~ScopedStageTimer() {
+        if (!profiling_ && !tracing_) return;
+        const auto end = std::chrono::steady_clock::now();
+        if (profiling_) {
+            Profiler::addTime(stage_, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count()));
+        }
+        if (tracing_) {
+            Tracer::complete(Profiler::stageName(stage_), Profiler::stageCategory(stage_), start_, end);
+        }
+    }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    Profiler::Stage stage_;
+    bool profiling_;
+    bool tracing_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace astvdp
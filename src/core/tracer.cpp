@@ -0,0 +1,109 @@
+#include "tracer.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace astvdp {
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    Tracer::Clock::time_point begin;
+    Tracer::Clock::time_point end;
+    int64_t rows;
+};
+
+// Appended to only by its owning thread; read by stop() after that thread
+// has finished its traced work
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    const char* name = nullptr;
+    std::vector<TraceEvent> events;
+};
+
+std::atomic<bool> tracing{false};
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;  // buffers outlive their threads
+std::string trace_path;
+Tracer::Clock::time_point epoch;
+
+ThreadBuffer& localBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(std::make_unique<ThreadBuffer>());
+        buffer = registry.back().get();
+        buffer->tid = static_cast<uint32_t>(registry.size());
+        buffer->events.reserve(1024);
+    }
+    return *buffer;
+}
+
+double micros(Tracer::Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+}  // namespace
+
+void Tracer::start(const std::string& path) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    trace_path = path;
+    epoch = Clock::now();
+    tracing.store(true, std::memory_order_release);
+}
+
+bool Tracer::enabled() {
+    return tracing.load(std::memory_order_relaxed);
+}
+
+void Tracer::complete(const char* name, const char* category, Clock::time_point begin,
+                      Clock::time_point end, int64_t rows) {
+    localBuffer().events.push_back({name, category, begin, end, rows});
+}
+
+void Tracer::setThreadName(const char* name) {
+    if (enabled()) localBuffer().name = name;
+}
+
+bool Tracer::stop() {
+    if (!tracing.exchange(false)) return true;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::ofstream file(trace_path);
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    char buf[256];
+    bool first = true;
+    for (const auto& buffer : registry) {
+        if (buffer->name) {
+            std::snprintf(buf, sizeof buf,
+                          "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, "
+                          "\"args\": {\"name\": \"%s\"}}",
+                          first ? "" : ",", buffer->tid, buffer->name);
+            file << buf;
+            first = false;
+        }
+        for (const auto& e : buffer->events) {
+            const auto begin = e.begin < epoch ? epoch : e.begin;
+            int n = std::snprintf(buf, sizeof buf,
+                                  "%s\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, "
+                                  "\"tid\": %u, \"ts\": %.3f, \"dur\": %.3f",
+                                  first ? "" : ",", e.name, e.category, buffer->tid,
+                                  micros(begin - epoch), micros(e.end - begin));
+            if (e.rows >= 0 && n > 0 && static_cast<size_t>(n) < sizeof buf) {
+                std::snprintf(buf + n, sizeof buf - n, ", \"args\": {\"rows\": %lld}",
+                              static_cast<long long>(e.rows));
+            }
+            file << buf << "}";
+            first = false;
+        }
+        buffer->events.clear();
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+}  // namespace astvdp
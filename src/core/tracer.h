@@ -0,0 +1,52 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace astvdp {
+
+// Records timed spans in Chrome trace-event format (chrome://tracing,
+// ui.perfetto.dev) for --trace. Every thread appends to its own buffer
+// without locking; the buffers are written out by stop(), once the traced
+// threads have finished. While disabled each hook is one relaxed load.
+class Tracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Starts recording; stop() writes the events to `path`
+    static void start(const std::string& path);
+    // Writes and discards all buffered events; false if the file failed
+    static bool stop();
+    static bool enabled();
+
+    // Complete ("X") event; `name` and `category` must be string literals.
+    // A non-negative `rows` is attached as args.rows.
+    static void complete(const char* name, const char* category, Clock::time_point begin,
+                         Clock::time_point end, int64_t rows = -1);
+
+    // Labels the calling thread's track; `name` must be a string literal
+    static void setThreadName(const char* name);
+};
+
+// Emits one complete event for the lifetime of the scope
+class ScopedTrace {
+public:
+    ScopedTrace(const char* name, const char* category)
+        : name_(name), category_(category), active_(Tracer::enabled()) {
+        if (active_) begin_ = Tracer::Clock::now();
+    }
+    ~ScopedTrace() {
+        if (active_) Tracer::complete(name_, category_, begin_, Tracer::Clock::now());
+    }
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    bool active_;
+    Tracer::Clock::time_point begin_;
+};
+
+}  // namespace astvdp
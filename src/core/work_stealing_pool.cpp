@@ -0,0 +1,93 @@
+#include "work_stealing_pool.h"
+#include "tracer.h"
+#include <algorithm>
+
+namespace astvdp {
+
+namespace {
+thread_local const WorkStealingPool* tls_pool = nullptr;
+thread_local size_t tls_index = 0;
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threads) {
+    threads = std::max<size_t>(threads, 1);
+    for (size_t i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < threads; ++i) workers_.emplace_back([this, i] { workerLoop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& w : workers_) w.join();
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    // Tasks spawned from a worker stay local; outside submissions round-robin
+    size_t index = (tls_pool == this) ? tls_index
+                                      : next_queue_.fetch_add(1) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        ++queued_;
+        ++unfinished_;
+    }
+    wake_cv_.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    idle_cv_.wait(lock, [this] { return unfinished_ == 0; });
+}
+
+bool WorkStealingPool::tryTake(size_t index, std::function<void()>& task) {
+    {
+        Queue& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t k = 1; k < queues_.size(); ++k) {
+        Queue& victim = *queues_[(index + k) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    tls_pool = this;
+    tls_index = index;
+    Tracer::setThreadName("pool-worker");
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait(lock, [this] { return stop_ || queued_ > 0; });
+            if (queued_ == 0) return;  // stopping and drained
+            --queued_;
+        }
+
+        // queued_ was reserved above, so some deque holds a task for us
+        std::function<void()> task;
+        while (!tryTake(index, task)) std::this_thread::yield();
+        task();
+
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        if (--unfinished_ == 0) idle_cv_.notify_all();
+    }
+}
+
+}  // namespace astvdp
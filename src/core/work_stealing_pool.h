@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace astvdp {
+
+// Fixed-size thread pool with one task deque per worker. Workers take their
+// own newest task first and steal the oldest task from a sibling when idle,
+// so long and short jobs balance without a shared queue hot spot.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+    void wait();  // blocks until every submitted task has finished
+
+    size_t size() const { return workers_.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool tryTake(size_t index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable idle_cv_;
+    size_t queued_ = 0;      // guarded by wake_mutex_
+    size_t unfinished_ = 0;  // guarded by wake_mutex_
+    bool stop_ = false;      // guarded by wake_mutex_
+    std::atomic<size_t> next_queue_{0};
+};
+
+}  // namespace astvdp
@@ -0,0 +1,134 @@
+#pragma once
+#include "astvdp/types.h"
+#include "rolling_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace astvdp {
+
+// Per-detector settings fixed at registration
+struct DetectorConfig {
+    AnomalyId id;
+    Severity severity;
+    double threshold;
+    double reference;  // statistic-specific: RMS floor, expected mean, ...
+};
+
+// ---- Channels: map one SampleBlock row to the value a detector windows ----
+
+template <std::vector<double> SampleBlock::*Column>
+struct ColumnChannel {
+    double read(const SampleBlock& b, size_t i) { return (b.*Column)[i]; }
+};
+
+// 1 on the sample where a valid GNSS fix is lost, else 0
+struct GnssFixLossChannel {
+    double read(const SampleBlock& b, size_t i) {
+        const bool valid = b.gps_lat[i] != 0.0 || b.gps_lon[i] != 0.0;
+        const bool lost = had_fix_ && !valid;
+        had_fix_ = valid;
+        return lost ? 1.0 : 0.0;
+    }
+
+private:
+    bool had_fix_ = true;
+};
+
+// ---- Statistics: evaluated over the channel window after each push ----
+
+// Second-half RMS rising above threshold x first-half RMS (reference: RMS floor)
+struct RmsTrendStat {
+    RmsTrendStat(size_t window, const DetectorConfig& cfg)
+        : cfg_(cfg), min_samples_(std::max<size_t>(window / 2, 2)) {}
+
+    template <typename Emit>
+    void check(const RollingWindow& w, double timestamp, Emit& emit) {
+        if (w.size() < min_samples_) return;
+        const double rms1 = w.firstHalfRms();
+        const double rms2 = w.secondHalfRms();
+        if (rms1 > cfg_.reference && rms2 > rms1 * cfg_.threshold) {
+            emit(Anomaly{timestamp, cfg_.id, cfg_.severity, static_cast<float>(rms2 / rms1)});
+        }
+    }
+
+private:
+    DetectorConfig cfg_;
+    size_t min_samples_;
+};
+
+// Window mean minus the expected value (reference) moving by more than
+// threshold since the last report
+struct MeanDriftStat {
+    MeanDriftStat(size_t window, const DetectorConfig& cfg)
+        : cfg_(cfg), min_samples_(std::max<size_t>(window * 3 / 10, 1)) {}
+
+    template <typename Emit>
+    void check(const RollingWindow& w, double timestamp, Emit& emit) {
+        if (w.size() < min_samples_) return;
+        const double bias = w.mean() - cfg_.reference;
+        if (first_run_) {
+            last_bias_ = bias;
+            first_run_ = false;
+            return;
+        }
+        const double drift = std::abs(bias - last_bias_);
+        if (drift > cfg_.threshold) {
+            emit(Anomaly{timestamp, cfg_.id, cfg_.severity, static_cast<float>(drift)});
+            last_bias_ = bias;
+        }
+    }
+
+private:
+    DetectorConfig cfg_;
+    size_t min_samples_;
+    double last_bias_ = 0.0;
+    bool first_run_ = true;
+};
+
+// Number of events (channel value 1) in the window reaching threshold
+struct EventCountStat {
+    EventCountStat(size_t, const DetectorConfig& cfg) : cfg_(cfg) {}
+
+    template <typename Emit>
+    void check(const RollingWindow& w, double timestamp, Emit& emit) {
+        const double events = std::round(w.mean() * w.size());
+        if (events >= cfg_.threshold) {
+            emit(Anomaly{timestamp, cfg_.id, cfg_.severity, static_cast<float>(events)});
+        }
+    }
+
+private:
+    DetectorConfig cfg_;
+};
+
+// One detector: a channel, its rolling window and a statistic. The channel
+// and statistic are compile-time parameters so a detector set expands into
+// one straight-line update per row; all state lives in the instance.
+template <typename Channel, typename Stat>
+class WindowKernel {
+public:
+    WindowKernel(size_t window, const DetectorConfig& cfg) : window_(window), stat_(window, cfg) {}
+
+    // Pushes row i; runs the check once the engine is armed
+    template <typename Emit>
+    void update(const SampleBlock& b, size_t i, bool armed, Emit& emit) {
+        window_.push(channel_.read(b, i));
+        if (armed) stat_.check(window_, b.timestamp[i], emit);
+    }
+
+private:
+    Channel channel_;
+    RollingWindow window_;
+    Stat stat_;
+};
+
+template <std::vector<double> SampleBlock::*Column>
+using RmsTrendKernel = WindowKernel<ColumnChannel<Column>, RmsTrendStat>;
+
+template <std::vector<double> SampleBlock::*Column>
+using MeanDriftKernel = WindowKernel<ColumnChannel<Column>, MeanDriftStat>;
+
+using GnssFixLossKernel = WindowKernel<GnssFixLossChannel, EventCountStat>;
+
+}  // namespace astvdp
@@ -1,31 +1,67 @@
 #pragma once
 #include "astvdp/types.h"
+#include "detector_kernels.h"
+#include "spectral_analyzer.h"
+#include <optional>
+#include <tuple>
 #include <vector>
-#include <deque>
 
 namespace astvdp {
 
 class DiagnosticEngine {
 public:
+    // Rolling window length in samples (100 ≈ 1 sec at 100Hz)
+    static constexpr size_t kDefaultWindowSize = 100;
+
+    explicit DiagnosticEngine(size_t window_size = kDefaultWindowSize);
+
     void process(const TimestampedSample& sample);
     std::vector<Anomaly> getNewAnomalies();
 
+    // Runs the detectors over a whole block, appending anomalies in row order
+    void processBlock(const SampleBlock& block, std::vector<BlockAnomaly>& out);
+
+    // Adds bias drift detectors on imu_ax/ay and imu_gx/gy/gz. Off by default:
+    // these channels move with every manoeuvre. They report after the
+    // default detectors and before the spectral stage.
+    void enableAxisDrift();
+
+    // Adds the Welch PSD stage on vib_x/y/z; it reports after the window detectors
+    void enableSpectral(const SpectralConfig& config = {});
+    const SpectralAnalyzer* spectral() const { return spectral_ ? &*spectral_ : nullptr; }
+
 private:
-    // Rolling windows (size = 100 samples ≈ 1 sec at 100Hz)
-    static constexpr size_t WINDOW_SIZE = 100;
+    // Registered detectors, updated in this order for every row: trend on
+    // each vibration axis, bias drift on imu_az, GNSS health
+    using Detectors = std::tuple<
+        RmsTrendKernel<&SampleBlock::vib_x>,
+        RmsTrendKernel<&SampleBlock::vib_y>,
+        RmsTrendKernel<&SampleBlock::vib_z>,
+        MeanDriftKernel<&SampleBlock::imu_az>,
+        GnssFixLossKernel>;
+
+    // Opt-in bias drift on the remaining accel and gyro axes
+    using AxisDriftDetectors = std::tuple<
+        MeanDriftKernel<&SampleBlock::imu_ax>,
+        MeanDriftKernel<&SampleBlock::imu_ay>,
+        MeanDriftKernel<&SampleBlock::imu_gx>,
+        MeanDriftKernel<&SampleBlock::imu_gy>,
+        MeanDriftKernel<&SampleBlock::imu_gz>>;
 
-    std::deque<double> vib_z_window_;
-    std::deque<double> imu_az_window_;
-    std::deque<double> timestamps_;
+    template <typename Emit>
+    void processRow(const SampleBlock& block, size_t row, Emit& emit);
 
-    double last_imu_az_bias_ = 0.0;
-    bool first_run_ = true;
+    Detectors detectors_;
+    std::optional<AxisDriftDetectors> axis_drift_;
+    size_t window_size_;
+    size_t min_samples_;  // rows seen before any detector reports
+    size_t seen_ = 0;
 
-    void checkVibrationTrend();
-    void checkImuBiasDrift();
-    void checkGnssStability();
+    std::optional<SpectralAnalyzer> spectral_;
+    std::vector<Anomaly> spectral_out_;
 
+    SampleBlock row_block_{1};  // single-row staging for process()
     std::vector<Anomaly> pending_anomalies_;
 };
 
-}  // namespace astvdp
\ No newline at end of file
+}  // namespace astvdp
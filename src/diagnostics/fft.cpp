@@ -0,0 +1,55 @@
+#include "fft.h"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace astvdp {
+
+FftPlan::FftPlan(size_t size) : size_(size) {
+    if (size < 2 || (size & (size - 1)) != 0) {
+        throw std::invalid_argument("FftPlan: size must be a power of two >= 2");
+    }
+
+    size_t bits = 0;
+    while ((size_t{1} << bits) < size_) ++bits;
+    bit_reverse_.resize(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            if (i & (size_t{1} << b)) r |= size_t{1} << (bits - 1 - b);
+        }
+        bit_reverse_[i] = r;
+    }
+
+    const double pi = std::acos(-1.0);
+    twiddles_.resize(size_ / 2);
+    for (size_t k = 0; k < size_ / 2; ++k) {
+        const double angle = -2.0 * pi * static_cast<double>(k) / static_cast<double>(size_);
+        twiddles_[k] = {std::cos(angle), std::sin(angle)};
+    }
+}
+
+void FftPlan::forward(std::complex<double>* data) const {
+    for (size_t i = 0; i < size_; ++i) {
+        const size_t r = bit_reverse_[i];
+        if (i < r) std::swap(data[i], data[r]);
+    }
+
+    // Iterative Cooley-Tukey butterflies; stage span doubles each pass
+    for (size_t span = 1; span < size_; span <<= 1) {
+        const size_t stride = size_ / (span * 2);  // twiddle step for this stage
+        for (size_t start = 0; start < size_; start += span * 2) {
+            for (size_t k = 0; k < span; ++k) {
+                // Plain complex multiply; operator* adds NaN/Inf recovery we don't need
+                const std::complex<double>& w = twiddles_[k * stride];
+                const std::complex<double>& b = data[start + k + span];
+                const std::complex<double> t(w.real() * b.real() - w.imag() * b.imag(),
+                                             w.real() * b.imag() + w.imag() * b.real());
+                data[start + k + span] = data[start + k] - t;
+                data[start + k] += t;
+            }
+        }
+    }
+}
+
+}  // namespace astvdp
@@ -0,0 +1,26 @@
+#pragma once
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace astvdp {
+
+// Precomputed radix-2 FFT of one fixed power-of-two size. Bit-reversal order
+// and twiddles are built once; forward() then runs in place with no
+// allocation, so one plan serves every segment of a stream.
+class FftPlan {
+public:
+    explicit FftPlan(size_t size);
+
+    size_t size() const { return size_; }
+
+    // In-place forward transform of size() points
+    void forward(std::complex<double>* data) const;
+
+private:
+    size_t size_;
+    std::vector<size_t> bit_reverse_;
+    std::vector<std::complex<double>> twiddles_;  // e^{-2πik/N}, k < N/2
+};
+
+}  // namespace astvdp
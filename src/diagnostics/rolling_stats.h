@@ -0,0 +1,94 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace astvdp {
+
+// Neumaier-compensated running sum. Values leaving a window are removed by
+// adding their negation, so long streams do not accumulate cancellation error.
+class CompensatedSum {
+public:
+    void add(double x) {
+        const double t = sum_ + x;
+        if (std::abs(sum_) >= std::abs(x)) {
+            comp_ += (sum_ - t) + x;
+        } else {
+            comp_ += (x - t) + sum_;
+        }
+        sum_ = t;
+    }
+
+    double value() const { return sum_ + comp_; }
+    void reset() { sum_ = 0.0; comp_ = 0.0; }
+
+private:
+    double sum_ = 0.0;
+    double comp_ = 0.0;
+};
+
+// Fixed-capacity sliding window over one channel with O(1) updates. Keeps the
+// running sum and the sum of squares of each half (oldest size/2 samples and
+// the rest), so mean and split-half RMS never rescan the window. Storage is
+// allocated once at construction; capacity is at least 2.
+class RollingWindow {
+public:
+    explicit RollingWindow(size_t capacity) : buf_(std::max<size_t>(capacity, 2)) {}
+
+    void push(double x) {
+        if (count_ == buf_.size()) {
+            // Evict the oldest sample; it always belongs to the first half
+            const double old = buf_[head_];
+            sum_.add(-old);
+            first_sq_.add(-old * old);
+            --first_;
+            head_ = wrap(head_ + 1);
+            --count_;
+        }
+        buf_[wrap(head_ + count_)] = x;
+        ++count_;
+        sum_.add(x);
+        second_sq_.add(x * x);
+
+        // Slide the half boundary so the first half holds size/2 samples
+        while (first_ < count_ / 2) {
+            const double v = buf_[wrap(head_ + first_)];
+            first_sq_.add(v * v);
+            second_sq_.add(-v * v);
+            ++first_;
+        }
+    }
+
+    size_t size() const { return count_; }
+    size_t capacity() const { return buf_.size(); }
+
+    double mean() const { return count_ ? sum_.value() / count_ : 0.0; }
+    double firstHalfRms() const { return rms(first_sq_, first_); }
+    double secondHalfRms() const { return rms(second_sq_, count_ - first_); }
+
+    void clear() {
+        head_ = count_ = first_ = 0;
+        sum_.reset();
+        first_sq_.reset();
+        second_sq_.reset();
+    }
+
+private:
+    size_t wrap(size_t i) const { return i >= buf_.size() ? i - buf_.size() : i; }
+
+    static double rms(const CompensatedSum& sq, size_t n) {
+        // Clamp tiny negative residue left after removing the last large values
+        return n ? std::sqrt(std::max(sq.value(), 0.0) / n) : 0.0;
+    }
+
+    std::vector<double> buf_;
+    size_t head_ = 0;   // index of the oldest sample
+    size_t count_ = 0;
+    size_t first_ = 0;  // samples in the first half
+    CompensatedSum sum_;
+    CompensatedSum first_sq_;
+    CompensatedSum second_sq_;
+};
+
+}  // namespace astvdp
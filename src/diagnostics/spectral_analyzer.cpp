@@ -0,0 +1,148 @@
+#include "spectral_analyzer.h"
+#include "astvdp/anomaly_registry.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace astvdp {
+
+namespace {
+const char* const kAxisNames[SpectralAnalyzer::kAxes] = {"vib_x", "vib_y", "vib_z"};
+}  // namespace
+
+SpectralAnalyzer::SpectralAnalyzer(const SpectralConfig& config)
+    : config_(config),
+      plan_(config.segment),
+      bins_(config.segment / 2 + 1),
+      hop_(config.segment / 2) {
+    config_.averages = std::max<size_t>(config_.averages, 1);
+
+    const size_t n = config_.segment;
+    const double pi = std::acos(-1.0);
+    window_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        window_[i] = 0.5 - 0.5 * std::cos(2.0 * pi * static_cast<double>(i) / static_cast<double>(n));
+        window_power_ += window_[i] * window_[i];
+    }
+    scratch_.resize(n);
+
+    for (auto& axis : axes_) {
+        axis.samples.assign(n, 0.0);
+        axis.periodograms.assign(config_.averages * bins_, 0.0);
+    }
+}
+
+void SpectralAnalyzer::update(const SampleBlock& block, size_t row, std::vector<Anomaly>& out) {
+    const double t = block.timestamp[row];
+    if (seen_++ == 0) first_timestamp_ = t;
+
+    axes_[0].samples[write_pos_] = block.vib_x[row];
+    axes_[1].samples[write_pos_] = block.vib_y[row];
+    axes_[2].samples[write_pos_] = block.vib_z[row];
+    if (++write_pos_ == config_.segment) write_pos_ = 0;
+    if (filled_ < config_.segment) ++filled_;
+
+    if (++since_analysis_ < hop_ || filled_ < config_.segment) return;
+    since_analysis_ = 0;
+
+    if (!configured_) configure(t);
+
+    const size_t stored = std::min(periodogram_count_ + 1, config_.averages);
+    for (auto& axis : axes_) analyze(axis, stored, t, out);
+
+    periodogram_slot_ = (periodogram_slot_ + 1) % config_.averages;
+    periodogram_count_ = stored;
+    if (stored == config_.averages) ++estimates_;
+}
+
+void SpectralAnalyzer::configure(double last_timestamp) {
+    sample_rate_ = config_.sample_rate_hz;
+    if (sample_rate_ <= 0.0) {
+        const double span = last_timestamp - first_timestamp_;
+        sample_rate_ = span > 0.0 ? static_cast<double>(config_.segment - 1) / span : 1.0;
+    }
+
+    bands_ = config_.bands;
+    if (bands_.empty()) {
+        const double nyquist = sample_rate_ / 2.0;
+        for (int b = 0; b < 4; ++b) bands_.push_back({nyquist * b / 4.0, nyquist * (b + 1) / 4.0});
+    }
+
+    for (size_t a = 0; a < kAxes; ++a) {
+        Axis& axis = axes_[a];
+        axis.band_power.assign(bands_.size(), 0.0);
+        axis.baseline.assign(bands_.size(), 0.0);
+        axis.band_ids.clear();
+        for (const auto& band : bands_) {
+            std::ostringstream details;
+            details << "Band " << band.first << "-" << band.second << " Hz energy rising";
+            axis.band_ids.push_back(
+                AnomalyRegistry::intern("vibration_band_energy", kAxisNames[a], details.str()));
+        }
+    }
+    configured_ = true;
+}
+
+void SpectralAnalyzer::analyze(Axis& axis, size_t stored, double timestamp, std::vector<Anomaly>& out) {
+    const size_t n = config_.segment;
+
+    // Oldest sample first; remove the segment mean so DC and slow drift don't
+    // leak into the low bands
+    double mean = 0.0;
+    for (double v : axis.samples) mean += v;
+    mean /= static_cast<double>(n);
+    for (size_t i = 0, idx = write_pos_; i < n; ++i) {
+        scratch_[i] = {(axis.samples[idx] - mean) * window_[i], 0.0};
+        if (++idx == n) idx = 0;
+    }
+    plan_.forward(scratch_.data());
+
+    // One-sided PSD density of this segment
+    double* periodogram = &axis.periodograms[periodogram_slot_ * bins_];
+    const double scale = 1.0 / (sample_rate_ * window_power_);
+    for (size_t k = 0; k < bins_; ++k) {
+        double p = std::norm(scratch_[k]) * scale;
+        if (k > 0 && k < n / 2) p *= 2.0;
+        periodogram[k] = p;
+    }
+
+    // Welch estimate: mean of the stored periodograms, integrated per band
+    const double df = sample_rate_ / static_cast<double>(n);
+    std::fill(axis.band_power.begin(), axis.band_power.end(), 0.0);
+    double peak_power = -1.0;
+    for (size_t k = 1; k < bins_; ++k) {
+        double psd = 0.0;
+        for (size_t s = 0; s < stored; ++s) psd += axis.periodograms[s * bins_ + k];
+        psd /= static_cast<double>(stored);
+
+        const double f = static_cast<double>(k) * df;
+        if (psd > peak_power) {
+            peak_power = psd;
+            axis.peak_hz = f;
+        }
+        for (size_t b = 0; b < bands_.size(); ++b) {
+            const bool last = b + 1 == bands_.size();
+            if (f >= bands_[b].first && (f < bands_[b].second || (last && f == bands_[b].second))) {
+                axis.band_power[b] += psd * df;
+            }
+        }
+    }
+
+    if (stored < config_.averages) return;  // wait for a full Welch average
+
+    for (size_t b = 0; b < bands_.size(); ++b) {
+        const double power = axis.band_power[b];
+        double& baseline = axis.baseline[b];
+        if (estimates_ == 0) {
+            baseline = power;
+            continue;
+        }
+        if (baseline > config_.min_power && power > baseline * config_.rise_ratio) {
+            out.push_back({timestamp, axis.band_ids[b], Severity::Major,
+                           static_cast<float>(power / baseline)});
+        }
+        baseline += config_.baseline_alpha * (power - baseline);
+    }
+}
+
+}  // namespace astvdp
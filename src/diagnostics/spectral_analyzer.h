@@ -0,0 +1,78 @@
+#pragma once
+#include "astvdp/types.h"
+#include "fft.h"
+#include <array>
+#include <complex>
+#include <utility>
+#include <vector>
+
+namespace astvdp {
+
+struct SpectralConfig {
+    size_t segment = 256;          // FFT length (power of two); hop is segment/2
+    size_t averages = 8;           // periodograms averaged per Welch estimate
+    double sample_rate_hz = 0.0;   // 0: estimated from the first segment's timestamps
+    // Bands in Hz, [low, high); the last band is [low, high], so the default
+    // top band keeps the Nyquist bin. Empty: four equal bands up to Nyquist
+    std::vector<std::pair<double, double>> bands;
+    double rise_ratio = 3.0;       // flag band power above ratio x baseline
+    double baseline_alpha = 0.05;  // EMA weight of each new estimate in the baseline
+    double min_power = 1e-6;       // ignore bands whose baseline is below this
+};
+
+// Streaming Welch PSD over vib_x/y/z. Every hop (50% overlap) the latest
+// segment is detrended, Hann-windowed and transformed with a shared FFT plan;
+// the last `averages` periodograms form the PSD estimate. Band powers are
+// compared with a slow per-band baseline and a rise raises a
+// vibration_band_energy anomaly. All buffers are allocated up front.
+class SpectralAnalyzer {
+public:
+    static constexpr size_t kAxes = 3;
+
+    explicit SpectralAnalyzer(const SpectralConfig& config = {});
+
+    // Feeds row `row` of the block; appends anomalies raised on this row
+    void update(const SampleBlock& block, size_t row, std::vector<Anomaly>& out);
+
+    // Latest Welch estimate; zero until the first segment completes
+    double peakFrequency(size_t axis) const { return axes_[axis].peak_hz; }
+    double bandPower(size_t axis, size_t band) const { return axes_[axis].band_power[band]; }
+    const std::vector<std::pair<double, double>>& bands() const { return bands_; }
+    double sampleRate() const { return sample_rate_; }
+
+private:
+    struct Axis {
+        std::vector<double> samples;            // circular, segment long
+        std::vector<double> periodograms;       // averages x bins, one row per segment
+        std::vector<double> band_power;
+        std::vector<double> baseline;
+        std::vector<AnomalyId> band_ids;
+        double peak_hz = 0.0;
+    };
+
+    void configure(double last_timestamp);
+    void analyze(Axis& axis, size_t stored, double timestamp, std::vector<Anomaly>& out);
+
+    SpectralConfig config_;
+    FftPlan plan_;
+    size_t bins_;
+    size_t hop_;
+    std::vector<double> window_;                // Hann coefficients
+    double window_power_ = 0.0;                 // sum of squared coefficients
+    std::vector<std::complex<double>> scratch_;
+    std::array<Axis, kAxes> axes_;
+    std::vector<std::pair<double, double>> bands_;
+
+    size_t write_pos_ = 0;        // next slot in each axis' sample ring
+    size_t since_analysis_ = 0;
+    size_t filled_ = 0;           // samples seen, saturating at segment
+    size_t seen_ = 0;
+    size_t periodogram_slot_ = 0;
+    size_t periodogram_count_ = 0;
+    size_t estimates_ = 0;        // Welch estimates folded into the baselines
+    double first_timestamp_ = 0.0;
+    double sample_rate_ = 0.0;
+    bool configured_ = false;
+};
+
+}  // namespace astvdp
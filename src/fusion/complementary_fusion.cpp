@@ -42,4 +42,39 @@ void ComplementaryFusion::process(const TimestampedSample& raw, FusedState& fuse
     prev_timestamp_ = raw.timestamp;
 }
 
-}  // namespace astvdp
\ No newline at end of file
+void ComplementaryFusion::processBlock(const SampleBlock& raw, FusedBlock& fused) {
+    const size_t n = raw.size;
+    if (fused.capacity() < n) fused.reserve(n);
+    fused.size = n;
+
+    // Pass 1: per-row gyro increments (zero while there is no previous
+    // timestamp), written into the roll/pitch columns
+    double prev_t = prev_timestamp_;
+    for (size_t i = 0; i < n; ++i) {
+        const double t = raw.timestamp[i];
+        const double dt = t - prev_t;
+        const bool integrate = prev_t > 0;
+        fused.roll[i] = integrate ? raw.imu_gx[i] * dt : 0.0;
+        fused.pitch[i] = integrate ? raw.imu_gy[i] * dt : 0.0;
+        prev_t = t;
+    }
+
+    // Pass 2: prefix sum -> integrated gyro angles, in the same order as process()
+    double roll_gyro = roll_gyro_;
+    double pitch_gyro = pitch_gyro_;
+    for (size_t i = 0; i < n; ++i) {
+        roll_gyro += fused.roll[i];
+        pitch_gyro += fused.pitch[i];
+        fused.roll[i] = roll_gyro;
+        fused.pitch[i] = pitch_gyro;
+    }
+
+    // Pass 3: accelerometer attitude blend, yaw, q_dyn (SIMD kernel)
+    kernel_(raw, fused, n);
+
+    prev_timestamp_ = prev_t;
+    roll_gyro_ = roll_gyro;
+    pitch_gyro_ = pitch_gyro;
+}
+
+}  // namespace astvdp
@@ -1,5 +1,6 @@
 #pragma once
 #include "astvdp/interfaces.h"
+#include "fusion_kernels.h"
 
 namespace astvdp {
 
@@ -7,7 +8,15 @@ class ComplementaryFusion : public SensorFusion {
 public:
     void process(const TimestampedSample& raw, FusedState& fused) override;
 
+    // Block path: gyro integration as a prefix sum, then a SIMD kernel with
+    // fastAtan2; attitude matches process() to within kFastAtan2MaxError and
+    // every other output exactly
+    void processBlock(const SampleBlock& raw, FusedBlock& fused) override;
+
+    void setSimdLevel(SimdLevel level) { kernel_ = attitudeKernel(level); }
+
 private:
+    AttitudeKernel kernel_ = attitudeKernel(detectSimdLevel());
     double prev_timestamp_ = 0.0;
     double roll_gyro_ = 0.0;
     double pitch_gyro_ = 0.0;
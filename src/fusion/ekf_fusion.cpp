@@ -0,0 +1,337 @@
+#include "ekf_fusion.h"
+#include <algorithm>
+#include <cmath>
+
+namespace astvdp {
+
+namespace {
+
+constexpr size_t kAtt = 0;   // attitude error, NED frame (3)
+constexpr size_t kVel = 3;   // velocity error, NED (3)
+constexpr size_t kAlt = 6;
+constexpr size_t kBias = 7;
+
+constexpr double kGravity = 9.81;
+constexpr double kMaxPredictStep = 1.0;  // s; longer gaps skip the prediction
+
+// Standard-atmosphere pressure altitude (m) from static pressure (Pa)
+double baroAltitude(double pressure) {
+    return 44330.0 * (1.0 - std::pow(pressure / 101325.0, 1.0 / 5.255));
+}
+
+bool gnssValid(const TimestampedSample& s) {
+    return s.gps_lat != 0.0 || s.gps_lon != 0.0;
+}
+
+double wrapAngle(double a) {
+    constexpr double pi = 3.14159265358979323846;
+    while (a > pi) a -= 2.0 * pi;
+    while (a < -pi) a += 2.0 * pi;
+    return a;
+}
+
+void normalize(double q[4]) {
+    const double n = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int i = 0; i < 4; ++i) q[i] /= n;
+}
+
+// out = a ⊗ b (Hamilton product)
+void multiply(const double a[4], const double b[4], double out[4]) {
+    out[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+    out[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+    out[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+    out[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+}
+
+}  // namespace
+
+EkfFusion::EkfFusion(const EkfConfig& config) : config_(config) {
+    refreshRotation();
+}
+
+void EkfFusion::process(const TimestampedSample& raw, FusedState& fused) {
+    step(raw);
+    output(raw.timestamp, fused);
+}
+
+void EkfFusion::processBlock(const SampleBlock& raw, FusedBlock& fused) {
+    if (fused.capacity() < raw.size) fused.reserve(raw.size);
+    for (size_t i = 0; i < raw.size; ++i) {
+        const TimestampedSample s = raw.get(i);
+        step(s);
+        FusedState f;
+        output(s.timestamp, f);
+        fused.set(i, f);
+    }
+    fused.size = raw.size;
+}
+
+void EkfFusion::step(const TimestampedSample& s) {
+    if (!initialized_) {
+        initialize(s);
+        prev_timestamp_ = s.timestamp;
+        return;
+    }
+
+    const double dt = s.timestamp - prev_timestamp_;
+    if (dt > 0.0 && dt <= kMaxPredictStep) predict(s, dt);
+    correct(s);
+    inject();
+    prev_timestamp_ = s.timestamp;
+}
+
+void EkfFusion::initialize(const TimestampedSample& s) {
+    // Attitude from the accelerometer (as ComplementaryFusion), heading from track
+    const double roll = std::atan2(s.imu_ay, s.imu_az);
+    const double pitch = std::atan2(-s.imu_ax, std::sqrt(s.imu_ay * s.imu_ay + s.imu_az * s.imu_az));
+    const double speed = std::sqrt(s.gps_vx * s.gps_vx + s.gps_vy * s.gps_vy);
+    const double yaw = speed > config_.min_track_speed ? std::atan2(s.gps_vy, s.gps_vx) : 0.0;
+
+    const double cr = std::cos(roll / 2), sr = std::sin(roll / 2);
+    const double cp = std::cos(pitch / 2), sp = std::sin(pitch / 2);
+    const double cy = std::cos(yaw / 2), sy = std::sin(yaw / 2);
+    q_[0] = cr * cp * cy + sr * sp * sy;
+    q_[1] = sr * cp * cy - cr * sp * sy;
+    q_[2] = cr * sp * cy + sr * cp * sy;
+    q_[3] = cr * cp * sy - sr * sp * cy;
+    refreshRotation();
+
+    vel_[0] = s.gps_vx;
+    vel_[1] = s.gps_vy;
+    vel_[2] = 0.0;
+
+    const bool have_baro = s.static_pressure > 0.0;
+    const double baro_alt = have_baro ? baroAltitude(s.static_pressure) : 0.0;
+    if (gnssValid(s)) {
+        alt_ = s.gps_alt;
+        baro_bias_ = have_baro ? baro_alt - s.gps_alt : 0.0;
+    } else {
+        alt_ = baro_alt;
+        baro_bias_ = 0.0;
+    }
+
+    cov_ = Covariance();
+    for (size_t i = 0; i < 3; ++i) cov_(kAtt + i, kAtt + i) = 0.1 * 0.1;
+    for (size_t i = 0; i < 3; ++i) cov_(kVel + i, kVel + i) = 1.0;
+    cov_(kAlt, kAlt) = 10.0 * 10.0;
+    cov_(kBias, kBias) = 10.0 * 10.0;
+    dx_ = StateVector();
+    initialized_ = true;
+}
+
+void EkfFusion::predict(const TimestampedSample& s, double dt) {
+    // Specific force in body FRD; the input reports +g on z when level
+    const double f[3] = {-s.imu_ax, -s.imu_ay, -s.imu_az};
+    double acc[3];
+    for (size_t r = 0; r < 3; ++r) {
+        acc[r] = rot_(r, 0) * f[0] + rot_(r, 1) * f[1] + rot_(r, 2) * f[2];
+    }
+
+    alt_ -= vel_[2] * dt;
+    vel_[0] += acc[0] * dt;
+    vel_[1] += acc[1] * dt;
+    vel_[2] += (acc[2] + kGravity) * dt;
+
+    // Body-rate increment, first order, then renormalize
+    const double dq[4] = {1.0, 0.5 * s.imu_gx * dt, 0.5 * s.imu_gy * dt, 0.5 * s.imu_gz * dt};
+    double q[4];
+    multiply(q_, dq, q);
+    normalize(q);
+    std::copy(q, q + 4, q_);
+
+    // Error-state transition F = I + A with dv' = -[a]x dθ and dh' = -dv_down.
+    // A only touches the velocity and altitude rows, so F P F^T is applied as
+    // two sparse passes (rows, then columns) instead of dense 8x8 products.
+    const Matrix<3, 3> fv = skew(acc[0], acc[1], acc[2]) * -dt;
+    auto applyRows = [&](Covariance& m) {
+        // Altitude first: it reads the not-yet-updated down-velocity row
+        for (size_t c = 0; c < kStates; ++c) m(kAlt, c) -= dt * m(kVel + 2, c);
+        for (size_t c = 0; c < kStates; ++c) {
+            const double a0 = m(kAtt, c), a1 = m(kAtt + 1, c), a2 = m(kAtt + 2, c);
+            for (size_t r = 0; r < 3; ++r) {
+                m(kVel + r, c) += fv(r, 0) * a0 + fv(r, 1) * a1 + fv(r, 2) * a2;
+            }
+        }
+    };
+    applyRows(cov_);                  // F P
+    cov_ = cov_.transposed();
+    applyRows(cov_);                  // F (F P)^T = (F P F^T)^T, symmetric
+    for (size_t i = 0; i < 3; ++i) {
+        cov_(kAtt + i, kAtt + i) += config_.gyro_noise * config_.gyro_noise * dt;
+        cov_(kVel + i, kVel + i) += config_.accel_noise * config_.accel_noise * dt;
+    }
+    cov_(kBias, kBias) += config_.baro_bias_walk * config_.baro_bias_walk * dt;
+
+    refreshRotation();
+}
+
+void EkfFusion::correct(const TimestampedSample& s) {
+    const bool gnss = gnssValid(s);
+    const bool baro = s.static_pressure > 0.0;
+    const double baro_alt = baro ? baroAltitude(s.static_pressure) : 0.0;
+    const double vel_var = config_.gnss_vel_sigma * config_.gnss_vel_sigma;
+    const double alt_var = config_.gnss_alt_sigma * config_.gnss_alt_sigma;
+
+    // A step the filter keeps rejecting (e.g. a jump in the recorded track)
+    // re-seeds that part of the state from GNSS rather than diverging on it
+    if (gnss && vel_rejects_ >= config_.reset_after) {
+        resetState(kVel + 0, vel_var);
+        resetState(kVel + 1, vel_var);
+        resetState(kVel + 2, vel_var);
+        vel_[0] = s.gps_vx;
+        vel_[1] = s.gps_vy;
+        vel_[2] = 0.0;
+        vel_rejects_ = 0;
+    }
+    if (gnss && alt_rejects_ >= config_.reset_after) {
+        resetState(kAlt, alt_var);
+        resetState(kBias, alt_var);
+        resetState(kVel + 2, vel_var);
+        alt_ = s.gps_alt;
+        baro_bias_ = baro ? baro_alt - s.gps_alt : 0.0;
+        vel_[2] = 0.0;
+        alt_rejects_ = 0;
+    }
+
+    bool alt_ok = true;
+    if (baro) {
+        StateVector h;
+        h[kAlt] = 1.0;
+        h[kBias] = 1.0;
+        alt_ok = update(h, baro_alt - (alt_ + baro_bias_),
+                        config_.baro_alt_sigma * config_.baro_alt_sigma, true);
+    }
+
+    if (gnss) {
+        bool vel_ok = updateState(kVel + 0, s.gps_vx - vel_[0], vel_var, true);
+        vel_ok = updateState(kVel + 1, s.gps_vy - vel_[1], vel_var, true) && vel_ok;
+        alt_ok = updateState(kAlt, s.gps_alt - alt_, alt_var, true) && alt_ok;
+        vel_rejects_ = vel_ok ? 0 : vel_rejects_ + 1;
+        alt_rejects_ = alt_ok ? 0 : alt_rejects_ + 1;
+    }
+
+    // Gravity direction: expected body specific force is R^T (0, 0, -g).
+    // Skipped while the measured magnitude shows real acceleration.
+    const double f[3] = {-s.imu_ax, -s.imu_ay, -s.imu_az};
+    const double f_norm = std::sqrt(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+    if (std::abs(f_norm - kGravity) < 2.0) {
+        const Matrix<3, 3> jac = rot_.transposed() * skew(0.0, 0.0, -kGravity);
+        const double var = config_.gravity_sigma * config_.gravity_sigma;
+        for (size_t k = 0; k < 3; ++k) {
+            StateVector h;
+            for (size_t c = 0; c < 3; ++c) h[kAtt + c] = jac(k, c);
+            update(h, f[k] + kGravity * rot_(2, k), var);
+        }
+    }
+
+    // Heading from the ground track while moving
+    const double speed = std::sqrt(s.gps_vx * s.gps_vx + s.gps_vy * s.gps_vy);
+    const double d = rot_(0, 0) * rot_(0, 0) + rot_(1, 0) * rot_(1, 0);
+    if (gnss && speed > config_.min_track_speed && d > 1e-6) {
+        StateVector h;
+        h[kAtt + 0] = -rot_(0, 0) * rot_(2, 0) / d;
+        h[kAtt + 1] = -rot_(1, 0) * rot_(2, 0) / d;
+        h[kAtt + 2] = 1.0;
+        const double yaw = std::atan2(rot_(1, 0), rot_(0, 0));
+        update(h, wrapAngle(std::atan2(s.gps_vy, s.gps_vx) - yaw),
+               config_.track_sigma * config_.track_sigma);
+    }
+}
+
+bool EkfFusion::update(const StateVector& h, double innovation, double variance, bool gated) {
+    double residual = innovation;
+    for (size_t i = 0; i < kStates; ++i) residual -= h[i] * dx_[i];
+
+    // h has at most a few non-zero entries; skip the rest
+    StateVector pht;
+    double s = variance;
+    for (size_t k = 0; k < kStates; ++k) {
+        if (h[k] == 0.0) continue;
+        for (size_t r = 0; r < kStates; ++r) pht[r] += cov_(r, k) * h[k];
+    }
+    for (size_t i = 0; i < kStates; ++i) s += h[i] * pht[i];
+    return applyGain(pht, residual, s, gated);
+}
+
+bool EkfFusion::updateState(size_t index, double innovation, double variance, bool gated) {
+    // h is a unit vector: P h^T is a column of P
+    StateVector pht;
+    for (size_t r = 0; r < kStates; ++r) pht[r] = cov_(r, index);
+    return applyGain(pht, innovation - dx_[index], cov_(index, index) + variance, gated);
+}
+
+bool EkfFusion::applyGain(const StateVector& pht, double residual, double s, bool gated) {
+    if (s <= 0.0) return false;
+    if (gated && residual * residual > config_.innovation_gate * config_.innovation_gate * s) {
+        return false;
+    }
+    for (size_t r = 0; r < kStates; ++r) {
+        const double k = pht[r] / s;
+        dx_[r] += k * residual;
+        for (size_t c = 0; c < kStates; ++c) cov_(r, c) -= k * pht[c];
+    }
+    return true;
+}
+
+void EkfFusion::resetState(size_t index, double variance) {
+    for (size_t i = 0; i < kStates; ++i) {
+        cov_(index, i) = 0.0;
+        cov_(i, index) = 0.0;
+    }
+    cov_(index, index) = variance;
+    dx_[index] = 0.0;
+}
+
+void EkfFusion::inject() {
+    // Attitude error is in the NED frame: q <- δq ⊗ q
+    const double dq[4] = {1.0, 0.5 * dx_[kAtt], 0.5 * dx_[kAtt + 1], 0.5 * dx_[kAtt + 2]};
+    double q[4];
+    multiply(dq, q_, q);
+    normalize(q);
+    std::copy(q, q + 4, q_);
+
+    for (size_t i = 0; i < 3; ++i) vel_[i] += dx_[kVel + i];
+    alt_ += dx_[kAlt];
+    baro_bias_ += dx_[kBias];
+    dx_ = StateVector();
+
+    // Keep the covariance symmetric against rounding in the updates
+    for (size_t r = 0; r < kStates; ++r) {
+        for (size_t c = r + 1; c < kStates; ++c) {
+            const double m = 0.5 * (cov_(r, c) + cov_(c, r));
+            cov_(r, c) = m;
+            cov_(c, r) = m;
+        }
+    }
+    refreshRotation();
+}
+
+void EkfFusion::refreshRotation() {
+    const double w = q_[0], x = q_[1], y = q_[2], z = q_[3];
+    rot_(0, 0) = 1 - 2 * (y * y + z * z);
+    rot_(0, 1) = 2 * (x * y - w * z);
+    rot_(0, 2) = 2 * (x * z + w * y);
+    rot_(1, 0) = 2 * (x * y + w * z);
+    rot_(1, 1) = 1 - 2 * (x * x + z * z);
+    rot_(1, 2) = 2 * (y * z - w * x);
+    rot_(2, 0) = 2 * (x * z - w * y);
+    rot_(2, 1) = 2 * (y * z + w * x);
+    rot_(2, 2) = 1 - 2 * (x * x + y * y);
+}
+
+void EkfFusion::output(double timestamp, FusedState& fused) const {
+    fused.timestamp = timestamp;
+    fused.roll = std::atan2(rot_(2, 1), rot_(2, 2));
+    fused.pitch = -std::asin(std::clamp(rot_(2, 0), -1.0, 1.0));
+    fused.yaw = std::atan2(rot_(1, 0), rot_(0, 0));
+    fused.alt_msl = alt_;
+    fused.vn = vel_[0];
+    fused.ve = vel_[1];
+    fused.vd = vel_[2];
+
+    // Dynamic pressure: q = 0.5 * rho * V^2 (rho = 1.225 kg/m³ at sea level)
+    const double v2 = vel_[0] * vel_[0] + vel_[1] * vel_[1] + vel_[2] * vel_[2];
+    fused.q_dyn = 0.5 * 1.225 * v2;
+}
+
+}  // namespace astvdp
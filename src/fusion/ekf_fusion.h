@@ -0,0 +1,76 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include "small_matrix.h"
+
+namespace astvdp {
+
+// Noise settings (1-sigma) for EkfFusion
+struct EkfConfig {
+    double gyro_noise = 0.05;        // rad/s, attitude process noise
+    double accel_noise = 0.5;        // m/s², velocity process noise
+    double baro_bias_walk = 0.1;     // m/√s, baro-vs-GNSS altitude offset drift
+    double gnss_vel_sigma = 0.5;     // m/s
+    double gnss_alt_sigma = 5.0;     // m
+    double baro_alt_sigma = 2.0;     // m
+    double gravity_sigma = 0.5;      // m/s², accelerometer as a tilt reference
+    double track_sigma = 0.05;       // rad, heading from GNSS ground track
+    double min_track_speed = 1.0;    // m/s, below this the track is not used
+    double innovation_gate = 5.0;    // sigmas; GNSS/baro residuals beyond this are rejected
+    size_t reset_after = 10;         // consecutive rejections before re-seeding from GNSS
+};
+
+// Error-state EKF: quaternion attitude (body -> NED), NED velocity, altitude
+// and a baro altitude bias. Gyro rates and accelerometer specific force drive
+// the prediction; GNSS velocity/altitude, baro altitude from static_pressure,
+// the accelerometer gravity direction and the GNSS ground track correct it.
+// All filter state is fixed-size and lives inside the object, so process()
+// never allocates.
+class EkfFusion : public SensorFusion {
+public:
+    // Error state: attitude (3, NED frame), velocity (3), altitude, baro bias
+    static constexpr size_t kStates = 8;
+
+    explicit EkfFusion(const EkfConfig& config = {});
+
+    void process(const TimestampedSample& raw, FusedState& fused) override;
+    void processBlock(const SampleBlock& raw, FusedBlock& fused) override;
+
+private:
+    using StateVector = Vector<kStates>;
+    using Covariance = Matrix<kStates, kStates>;
+
+    void step(const TimestampedSample& s);
+    void initialize(const TimestampedSample& s);
+    void predict(const TimestampedSample& s, double dt);
+    void correct(const TimestampedSample& s);
+
+    // Sequential scalar updates; `innovation` is against the nominal state.
+    // With `gated`, a residual beyond the innovation gate is rejected and
+    // false is returned.
+    bool update(const StateVector& h, double innovation, double variance, bool gated = false);
+    bool updateState(size_t index, double innovation, double variance, bool gated = false);
+    bool applyGain(const StateVector& pht, double residual, double s, bool gated);
+    // Forgets one state's correlations and restarts it at `variance`
+    void resetState(size_t index, double variance);
+    void inject();
+    void refreshRotation();
+    void output(double timestamp, FusedState& fused) const;
+
+    EkfConfig config_;
+
+    double q_[4] = {1.0, 0.0, 0.0, 0.0};  // w, x, y, z
+    Matrix<3, 3> rot_;                    // body -> NED, from q_
+    double vel_[3] = {0.0, 0.0, 0.0};     // north, east, down
+    double alt_ = 0.0;
+    double baro_bias_ = 0.0;              // baro altitude minus true altitude
+
+    Covariance cov_;
+    StateVector dx_;                      // error accumulated by this sample's updates
+
+    size_t vel_rejects_ = 0;
+    size_t alt_rejects_ = 0;
+    double prev_timestamp_ = 0.0;
+    bool initialized_ = false;
+};
+
+}  // namespace astvdp
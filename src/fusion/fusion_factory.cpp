@@ -0,0 +1,13 @@
+#include "fusion_factory.h"
+#include "complementary_fusion.h"
+#include "ekf_fusion.h"
+
+namespace astvdp {
+
+std::unique_ptr<SensorFusion> createFusion(const std::string& name) {
+    if (name.empty() || name == "complementary") return std::make_unique<ComplementaryFusion>();
+    if (name == "ekf") return std::make_unique<EkfFusion>();
+    return nullptr;
+}
+
+}  // namespace astvdp
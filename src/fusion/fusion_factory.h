@@ -0,0 +1,12 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include <memory>
+#include <string>
+
+namespace astvdp {
+
+// Fusion engines selectable with --fusion: "complementary" (default) or "ekf".
+// Returns nullptr for an unknown name.
+std::unique_ptr<SensorFusion> createFusion(const std::string& name);
+
+}  // namespace astvdp
@@ -0,0 +1,220 @@
+#include "fusion_kernels.h"
+#include <cmath>
+
+#ifdef ASTVDP_X86
+#include <immintrin.h>
+#endif
+
+namespace astvdp {
+
+namespace {
+
+constexpr double kAlpha = 0.97;  // complementary blend: 97% gyro, 3% accelerometer
+constexpr double kQScale = 0.5 * 1.225;  // q = 0.5 * rho * V^2, rho at sea level
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kPi2 = kPi / 2;
+constexpr double kPi4 = kPi / 4;
+constexpr double kTanPi8 = 0.41421356237309504880;
+
+// atan(t) for |t| <= tan(pi/8); max error 8.1e-9 rad
+constexpr double kAtanC1 = -3.33329491539e-1;
+constexpr double kAtanC2 = 1.99777106478e-1;
+constexpr double kAtanC3 = -1.38776856032e-1;
+constexpr double kAtanC4 = 8.05374449538e-2;
+
+void attitudeRows(const SampleBlock& raw, FusedBlock& fused, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        const double ay = raw.imu_ay[i];
+        const double az = raw.imu_az[i];
+        const double roll_acc = fastAtan2(ay, az);
+        const double pitch_acc = fastAtan2(-raw.imu_ax[i], std::sqrt(ay * ay + az * az));
+
+        const double vx = raw.gps_vx[i];
+        const double vy = raw.gps_vy[i];
+        const double speed = std::sqrt(vx * vx + vy * vy);
+
+        fused.timestamp[i] = raw.timestamp[i];
+        fused.roll[i] = kAlpha * fused.roll[i] + (1.0 - kAlpha) * roll_acc;
+        fused.pitch[i] = kAlpha * fused.pitch[i] + (1.0 - kAlpha) * pitch_acc;
+        fused.yaw[i] = (speed > 1.0) ? fastAtan2(vy, vx) : 0.0;
+        fused.alt_msl[i] = raw.gps_alt[i];
+        fused.vn[i] = vx;
+        fused.ve[i] = vy;
+        fused.vd[i] = 0.0;
+        fused.q_dyn[i] = kQScale * speed * speed;
+    }
+}
+
+void attitudeScalar(const SampleBlock& raw, FusedBlock& fused, size_t n) {
+    attitudeRows(raw, fused, 0, n);
+}
+
+#ifdef ASTVDP_X86
+
+// The vector atan2 mirrors fastAtan2 step for step; blends select between
+// values both branches computed, so results match the scalar code exactly.
+
+__m128d atan2Sse2(__m128d y, __m128d x) {
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d zero = _mm_setzero_pd();
+    auto select = [](__m128d mask, __m128d a, __m128d b) {  // mask ? a : b
+        return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+    };
+
+    const __m128d ax = _mm_andnot_pd(sign, x);
+    const __m128d ay = _mm_andnot_pd(sign, y);
+    const __m128d mx = _mm_max_pd(ax, ay);
+    const __m128d mn = _mm_min_pd(ax, ay);
+    const __m128d a = _mm_and_pd(_mm_cmpgt_pd(mx, zero), _mm_div_pd(mn, mx));
+
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d big = _mm_cmpgt_pd(a, _mm_set1_pd(kTanPi8));
+    const __m128d t = select(big, _mm_div_pd(_mm_sub_pd(a, one), _mm_add_pd(a, one)), a);
+    const __m128d z = _mm_mul_pd(t, t);
+    __m128d p = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(kAtanC4), z), _mm_set1_pd(kAtanC3));
+    p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(kAtanC2));
+    p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(kAtanC1));
+    p = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(p, z), t), t);
+
+    __m128d r = _mm_add_pd(p, _mm_and_pd(big, _mm_set1_pd(kPi4)));
+    r = select(_mm_cmpgt_pd(ay, ax), _mm_sub_pd(_mm_set1_pd(kPi2), r), r);
+    r = select(_mm_cmplt_pd(x, zero), _mm_sub_pd(_mm_set1_pd(kPi), r), r);
+    return select(_mm_cmplt_pd(y, zero), _mm_xor_pd(r, sign), r);
+}
+
+void attitudeSse2(const SampleBlock& raw, FusedBlock& fused, size_t n) {
+    const __m128d alpha = _mm_set1_pd(kAlpha);
+    const __m128d beta = _mm_set1_pd(1.0 - kAlpha);
+    const __m128d q_scale = _mm_set1_pd(kQScale);
+    const __m128d min_speed = _mm_set1_pd(1.0);
+    const __m128d sign = _mm_set1_pd(-0.0);
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d ay = _mm_loadu_pd(&raw.imu_ay[i]);
+        const __m128d az = _mm_loadu_pd(&raw.imu_az[i]);
+        const __m128d neg_ax = _mm_xor_pd(_mm_loadu_pd(&raw.imu_ax[i]), sign);
+        const __m128d roll_acc = atan2Sse2(ay, az);
+        const __m128d pitch_acc = atan2Sse2(
+            neg_ax, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(ay, ay), _mm_mul_pd(az, az))));
+
+        const __m128d vx = _mm_loadu_pd(&raw.gps_vx[i]);
+        const __m128d vy = _mm_loadu_pd(&raw.gps_vy[i]);
+        const __m128d speed = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(vx, vx), _mm_mul_pd(vy, vy)));
+
+        _mm_storeu_pd(&fused.timestamp[i], _mm_loadu_pd(&raw.timestamp[i]));
+        _mm_storeu_pd(&fused.roll[i], _mm_add_pd(_mm_mul_pd(alpha, _mm_loadu_pd(&fused.roll[i])),
+                                                 _mm_mul_pd(beta, roll_acc)));
+        _mm_storeu_pd(&fused.pitch[i], _mm_add_pd(_mm_mul_pd(alpha, _mm_loadu_pd(&fused.pitch[i])),
+                                                  _mm_mul_pd(beta, pitch_acc)));
+        _mm_storeu_pd(&fused.yaw[i], _mm_and_pd(_mm_cmpgt_pd(speed, min_speed), atan2Sse2(vy, vx)));
+        _mm_storeu_pd(&fused.alt_msl[i], _mm_loadu_pd(&raw.gps_alt[i]));
+        _mm_storeu_pd(&fused.vn[i], vx);
+        _mm_storeu_pd(&fused.ve[i], vy);
+        _mm_storeu_pd(&fused.vd[i], _mm_setzero_pd());
+        _mm_storeu_pd(&fused.q_dyn[i], _mm_mul_pd(_mm_mul_pd(q_scale, speed), speed));
+    }
+    attitudeRows(raw, fused, i, n);
+}
+
+ASTVDP_TARGET_AVX2
+inline __m256d atan2Avx2(__m256d y, __m256d x) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d zero = _mm256_setzero_pd();
+
+    const __m256d ax = _mm256_andnot_pd(sign, x);
+    const __m256d ay = _mm256_andnot_pd(sign, y);
+    const __m256d mx = _mm256_max_pd(ax, ay);
+    const __m256d mn = _mm256_min_pd(ax, ay);
+    const __m256d a = _mm256_and_pd(_mm256_cmp_pd(mx, zero, _CMP_GT_OQ), _mm256_div_pd(mn, mx));
+
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d big = _mm256_cmp_pd(a, _mm256_set1_pd(kTanPi8), _CMP_GT_OQ);
+    const __m256d t = _mm256_blendv_pd(
+        a, _mm256_div_pd(_mm256_sub_pd(a, one), _mm256_add_pd(a, one)), big);
+    const __m256d z = _mm256_mul_pd(t, t);
+    __m256d p = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(kAtanC4), z), _mm256_set1_pd(kAtanC3));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(kAtanC2));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(kAtanC1));
+    p = _mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(p, z), t), t);
+
+    __m256d r = _mm256_add_pd(p, _mm256_and_pd(big, _mm256_set1_pd(kPi4)));
+    r = _mm256_blendv_pd(r, _mm256_sub_pd(_mm256_set1_pd(kPi2), r), _mm256_cmp_pd(ay, ax, _CMP_GT_OQ));
+    r = _mm256_blendv_pd(r, _mm256_sub_pd(_mm256_set1_pd(kPi), r), _mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+    return _mm256_blendv_pd(r, _mm256_xor_pd(r, sign), _mm256_cmp_pd(y, zero, _CMP_LT_OQ));
+}
+
+ASTVDP_TARGET_AVX2
+void attitudeAvx2(const SampleBlock& raw, FusedBlock& fused, size_t n) {
+    const __m256d alpha = _mm256_set1_pd(kAlpha);
+    const __m256d beta = _mm256_set1_pd(1.0 - kAlpha);
+    const __m256d q_scale = _mm256_set1_pd(kQScale);
+    const __m256d min_speed = _mm256_set1_pd(1.0);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d ay = _mm256_loadu_pd(&raw.imu_ay[i]);
+        const __m256d az = _mm256_loadu_pd(&raw.imu_az[i]);
+        const __m256d neg_ax = _mm256_xor_pd(_mm256_loadu_pd(&raw.imu_ax[i]), sign);
+        const __m256d roll_acc = atan2Avx2(ay, az);
+        const __m256d pitch_acc = atan2Avx2(
+            neg_ax, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(ay, ay), _mm256_mul_pd(az, az))));
+
+        const __m256d vx = _mm256_loadu_pd(&raw.gps_vx[i]);
+        const __m256d vy = _mm256_loadu_pd(&raw.gps_vy[i]);
+        const __m256d speed =
+            _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(vx, vx), _mm256_mul_pd(vy, vy)));
+
+        _mm256_storeu_pd(&fused.timestamp[i], _mm256_loadu_pd(&raw.timestamp[i]));
+        _mm256_storeu_pd(&fused.roll[i],
+                         _mm256_add_pd(_mm256_mul_pd(alpha, _mm256_loadu_pd(&fused.roll[i])),
+                                       _mm256_mul_pd(beta, roll_acc)));
+        _mm256_storeu_pd(&fused.pitch[i],
+                         _mm256_add_pd(_mm256_mul_pd(alpha, _mm256_loadu_pd(&fused.pitch[i])),
+                                       _mm256_mul_pd(beta, pitch_acc)));
+        _mm256_storeu_pd(&fused.yaw[i], _mm256_and_pd(_mm256_cmp_pd(speed, min_speed, _CMP_GT_OQ),
+                                                      atan2Avx2(vy, vx)));
+        _mm256_storeu_pd(&fused.alt_msl[i], _mm256_loadu_pd(&raw.gps_alt[i]));
+        _mm256_storeu_pd(&fused.vn[i], vx);
+        _mm256_storeu_pd(&fused.ve[i], vy);
+        _mm256_storeu_pd(&fused.vd[i], _mm256_setzero_pd());
+        _mm256_storeu_pd(&fused.q_dyn[i], _mm256_mul_pd(_mm256_mul_pd(q_scale, speed), speed));
+    }
+    attitudeRows(raw, fused, i, n);
+}
+
+#endif  // ASTVDP_X86
+
+}  // namespace
+
+double fastAtan2(double y, double x) {
+    const double ax = std::abs(x);
+    const double ay = std::abs(y);
+    const double mx = ax > ay ? ax : ay;
+    const double mn = ax > ay ? ay : ax;
+    const double a = mx > 0.0 ? mn / mx : 0.0;
+
+    // Reduce [0, 1] to |t| <= tan(pi/8): atan(a) = pi/4 + atan((a - 1) / (a + 1))
+    const bool big = a > kTanPi8;
+    const double t = big ? (a - 1.0) / (a + 1.0) : a;
+    const double z = t * t;
+    const double p = (((kAtanC4 * z + kAtanC3) * z + kAtanC2) * z + kAtanC1) * z * t + t;
+
+    double r = p + (big ? kPi4 : 0.0);
+    if (ay > ax) r = kPi2 - r;
+    if (x < 0.0) r = kPi - r;
+    return y < 0.0 ? -r : r;
+}
+
+AttitudeKernel attitudeKernel(SimdLevel level) {
+#ifdef ASTVDP_X86
+    if (level == SimdLevel::Avx2 && detectSimdLevel() == SimdLevel::Avx2) return attitudeAvx2;
+    if (level != SimdLevel::Scalar) return attitudeSse2;
+#else
+    (void)level;
+#endif
+    return attitudeScalar;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,23 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include "core/cpu_features.h"
+#include <cstddef>
+
+namespace astvdp {
+
+// Polynomial atan2 used by the block fusion kernels: octant reduction to
+// |t| <= tan(pi/8) and a degree-9 odd minimax polynomial. Maximum absolute
+// error against std::atan2 is below kFastAtan2MaxError for finite inputs;
+// signed zeros are not distinguished (fastAtan2(+0, -0) is 0, not pi).
+constexpr double kFastAtan2MaxError = 1e-8;  // rad
+double fastAtan2(double y, double x);
+
+// Finishes rows [0, n) of a fused block. On entry fused.roll/pitch hold the
+// integrated gyro angles; the kernel blends them with the accelerometer
+// attitude and writes yaw, altitude, velocities and q_dyn. Every kernel is
+// bit-identical to the scalar one (same operation order, IEEE sqrt, no FMA).
+using AttitudeKernel = void (*)(const SampleBlock& raw, FusedBlock& fused, size_t n);
+
+AttitudeKernel attitudeKernel(SimdLevel level);  // falls back if unsupported
+
+}  // namespace astvdp
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+namespace astvdp {
+
+// Fixed-size row-major matrix stored inline (no heap). Sizes are template
+// parameters, so loops fully unroll for the small filters that use it.
+template <size_t R, size_t C>
+struct Matrix {
+    std::array<double, R * C> data{};
+
+    static constexpr size_t rows() { return R; }
+    static constexpr size_t cols() { return C; }
+
+    double& operator()(size_t r, size_t c) { return data[r * C + c]; }
+    double operator()(size_t r, size_t c) const { return data[r * C + c]; }
+
+    // Column vectors index by row
+    double& operator[](size_t i) { return data[i]; }
+    double operator[](size_t i) const { return data[i]; }
+
+    static Matrix identity() {
+        static_assert(R == C, "identity() needs a square matrix");
+        Matrix m;
+        for (size_t i = 0; i < R; ++i) m(i, i) = 1.0;
+        return m;
+    }
+
+    Matrix<C, R> transposed() const {
+        Matrix<C, R> t;
+        for (size_t r = 0; r < R; ++r)
+            for (size_t c = 0; c < C; ++c) t(c, r) = (*this)(r, c);
+        return t;
+    }
+
+    Matrix& operator+=(const Matrix& o) {
+        for (size_t i = 0; i < R * C; ++i) data[i] += o.data[i];
+        return *this;
+    }
+    Matrix& operator-=(const Matrix& o) {
+        for (size_t i = 0; i < R * C; ++i) data[i] -= o.data[i];
+        return *this;
+    }
+    Matrix& operator*=(double s) {
+        for (auto& v : data) v *= s;
+        return *this;
+    }
+};
+
+template <size_t N>
+using Vector = Matrix<N, 1>;
+
+template <size_t R, size_t K, size_t C>
+Matrix<R, C> operator*(const Matrix<R, K>& a, const Matrix<K, C>& b) {
+    Matrix<R, C> out;
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t k = 0; k < K; ++k) {
+            const double ark = a(r, k);
+            for (size_t c = 0; c < C; ++c) out(r, c) += ark * b(k, c);
+        }
+    }
+    return out;
+}
+
+template <size_t R, size_t C>
+Matrix<R, C> operator+(Matrix<R, C> a, const Matrix<R, C>& b) { return a += b; }
+
+template <size_t R, size_t C>
+Matrix<R, C> operator-(Matrix<R, C> a, const Matrix<R, C>& b) { return a -= b; }
+
+template <size_t R, size_t C>
+Matrix<R, C> operator*(Matrix<R, C> a, double s) { return a *= s; }
+
+// 3x3 cross-product matrix: skew(a) * b == a x b
+inline Matrix<3, 3> skew(double x, double y, double z) {
+    Matrix<3, 3> m;
+    m(0, 1) = -z; m(0, 2) = y;
+    m(1, 0) = z;  m(1, 2) = -x;
+    m(2, 0) = -y; m(2, 1) = x;
+    return m;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,103 @@
+#include "archive_ingest.h"
+#include "core/profiler.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace astvdp {
+
+bool ArchiveIngest::isArchive(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof archive::kHeaderMagic] = {};
+    return file.read(magic, sizeof magic) &&
+           std::memcmp(magic, archive::kHeaderMagic, sizeof magic) == 0;
+}
+
+bool ArchiveIngest::open(const std::string& path) {
+    close();
+    if (!file_.open(path)) return false;
+    if (!readArchiveIndex(file_.data(), file_.size(), chunks_)) {
+        file_.close();
+        return false;
+    }
+    return true;
+}
+
+bool ArchiveIngest::loadChunk() {
+    const ArchiveChunkInfo& info = chunks_[next_chunk_++];
+    if (staged_.capacity() < info.rows) staged_.reserve(info.rows);
+    staged_pos_ = 0;
+    if (!decodeArchiveChunk(file_.data(), file_.size(), info, staged_)) {
+        staged_.clear();
+        next_chunk_ = chunks_.size();  // stop at a corrupt chunk
+        return false;
+    }
+    Profiler::count(Profiler::kBytesParsed, info.bytes);
+    return true;
+}
+
+bool ArchiveIngest::readNext(TimestampedSample& out) {
+    while (staged_pos_ >= staged_.size) {
+        if (next_chunk_ >= chunks_.size() || !loadChunk()) return false;
+    }
+    out = staged_.get(staged_pos_++);
+    return true;
+}
+
+size_t ArchiveIngest::readBatch(SampleBlock& out) {
+    out.clear();
+    while (!out.full()) {
+        if (staged_pos_ < staged_.size) {
+            // Rows left over from a chunk larger than the caller's block
+            const size_t n = std::min(staged_.size - staged_pos_, out.capacity() - out.size);
+            const auto src = archive::channels(static_cast<const SampleBlock&>(staged_));
+            const auto dst = archive::channels(out);
+            for (size_t c = 0; c < archive::kChannelCount; ++c) {
+                std::memcpy(dst[c]->data() + out.size, src[c]->data() + staged_pos_, n * sizeof(double));
+            }
+            out.size += n;
+            staged_pos_ += n;
+            continue;
+        }
+        if (next_chunk_ >= chunks_.size()) break;
+        const ArchiveChunkInfo& info = chunks_[next_chunk_];
+        if (out.size == 0 && info.rows <= out.capacity()) {
+            // Whole chunk fits: decode in place, no staging copy
+            ++next_chunk_;
+            if (!decodeArchiveChunk(file_.data(), file_.size(), info, out)) {
+                out.clear();
+                next_chunk_ = chunks_.size();
+                break;
+            }
+            Profiler::count(Profiler::kBytesParsed, info.bytes);
+            break;
+        }
+        if (!loadChunk()) break;
+    }
+    return out.size;
+}
+
+bool ArchiveIngest::seek(double timestamp) {
+    if (!file_.isOpen()) return false;
+    const auto it = std::partition_point(chunks_.begin(), chunks_.end(), [timestamp](const ArchiveChunkInfo& c) {
+        return c.last_time < timestamp;
+    });
+    next_chunk_ = static_cast<size_t>(it - chunks_.begin());
+    staged_.clear();
+    staged_pos_ = 0;
+    if (next_chunk_ < chunks_.size() && loadChunk()) {
+        const double* t = staged_.timestamp.data();
+        staged_pos_ = static_cast<size_t>(std::lower_bound(t, t + staged_.size, timestamp) - t);
+    }
+    return true;
+}
+
+void ArchiveIngest::close() {
+    file_.close();
+    chunks_.clear();
+    next_chunk_ = 0;
+    staged_.clear();
+    staged_pos_ = 0;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,38 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include "archive/archive_format.h"
+#include "core/mapped_file.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+// Reads a columnar session archive through a memory mapping. readBatch()
+// decodes chunks straight into the caller's block when it has room for a
+// whole chunk, so re-analysing an archive skips text parsing entirely.
+class ArchiveIngest : public DataIngest {
+public:
+    // True if `path` starts with the archive magic
+    static bool isArchive(const std::string& path);
+
+    bool open(const std::string& path) override;
+    bool readNext(TimestampedSample& out) override;
+    size_t readBatch(SampleBlock& out) override;
+    void close() override;
+    // Finds the chunk through the footer index and decodes only that chunk
+    bool seek(double timestamp) override;
+
+    const std::vector<ArchiveChunkInfo>& chunks() const { return chunks_; }
+
+private:
+    bool loadChunk();  // decodes chunks_[next_chunk_] into staged_
+
+    MappedFile file_;
+    std::vector<ArchiveChunkInfo> chunks_;
+    size_t next_chunk_ = 0;
+    SampleBlock staged_{0};  // decoded chunk being handed out row by row
+    size_t staged_pos_ = 0;
+};
+
+}  // namespace astvdp
@@ -1,54 +1,70 @@
 #include "csv_ingest.h"
-#include <sstream>
+#include "csv_row_parser.h"
+#include "core/mapped_file.h"
+#include "core/profiler.h"
 #include <string>
 
 namespace astvdp {
 
 bool CsvIngest::open(const std::string& path) {
+    close();
+    file_.clear();
     file_.open(path);
     if (!file_.is_open()) return false;
+    path_ = path;
+    index_loaded_ = false;
+    failed_ = false;
+    resetBatch();
     std::getline(file_, header_);
+    schema_ = CsvSchema::fromHeader(header_);
+    if (!schema_.valid()) {
+        file_.close();
+        return false;
+    }
     return true;
 }
 
 bool CsvIngest::readNext(TimestampedSample& out) {
-    if (!file_.good()) return false;
-    std::string line;
-    if (!std::getline(file_, line)) return false;
+    if (failed_ || !file_.good()) return false;
+    if (!std::getline(file_, line_)) return false;
+    Profiler::count(Profiler::kBytesParsed, line_.size() + 1);
+    failed_ = !schema_.parseRow(line_.data(), line_.data() + line_.size(), out);
+    return !failed_;
+}
 
-    std::stringstream ss(line);
-    std::string cell;
-    std::vector<double> vals;
-    while (std::getline(ss, cell, ',')) {
-        cell.erase(0, cell.find_first_not_of(" \t"));
-        cell.erase(cell.find_last_not_of(" \t") + 1);
-        if (cell.empty()) {
-            vals.push_back(0.0);
-            continue;
-        }
-        try {
-            vals.push_back(std::stod(cell));
-        } catch (...) {
-            return false;
-        }
+bool CsvIngest::seek(double timestamp) {
+    if (!file_.is_open()) return false;
+    if (!index_loaded_) {
+        if (!index_.load(path_)) return false;
+        index_loaded_ = true;
+    }
+    file_.clear();
+    failed_ = false;
+    file_.seekg(static_cast<std::streamoff>(index_.scanStart(timestamp)));
+    std::string line;
+    std::streampos at = file_.tellg();
+    for (; std::getline(file_, line); at = file_.tellg()) {
+        double t;
+        if (!schema_.parseTimestamp(line.data(), line.data() + line.size(), t) || t >= timestamp) break;
     }
-    if (vals.size() < 12) return false;
+    file_.clear();
+    file_.seekg(at);
 
-    out.timestamp = vals[0];
-    out.imu_ax = vals[1]; out.imu_ay = vals[2]; out.imu_az = vals[3];
-    out.imu_gx = vals[4]; out.imu_gy = vals[5]; out.imu_gz = vals[6];
-    out.gps_lat = vals[7]; out.gps_lon = vals[8]; out.gps_alt = vals[9];
-    out.gps_vx = vals[10]; out.gps_vy = vals[11];
-    if (vals.size() > 12) out.static_pressure = vals[12];
-    if (vals.size() > 13) out.temperature = vals[13];
-    if (vals.size() > 16) {
-        out.vib_x = vals[14]; out.vib_y = vals[15]; out.vib_z = vals[16];
+    // Carried columns come from the rows before the new position; this
+    // stream reader maps the file once per seek to find them
+    TimestampedSample carry{};
+    MappedFile mapped;
+    if (at != std::streampos(-1) && mapped.open(path_)) {
+        schema_.carryBefore(mapped.data(), index_.dataOffset(), static_cast<size_t>(at), carry);
     }
+    resetBatch(carry);
     return true;
 }
 
 void CsvIngest::close() {
     if (file_.is_open()) file_.close();
+    failed_ = false;
+    resetBatch();
 }
 
 }  // namespace astvdp
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include "astvdp/interfaces.h"
+#include "csv_row_parser.h"
+#include "csv_time_index.h"
 #include <string>
 #include <fstream>
 
@@ -10,10 +12,17 @@ public:
     bool open(const std::string& path) override;
     bool readNext(TimestampedSample& out) override;
     void close() override;
+    bool seek(double timestamp) override;
 
 private:
     std::ifstream file_;
+    std::string path_;
+    CsvTimeIndex index_;
+    bool index_loaded_ = false;
     std::string header_;
+    CsvSchema schema_;
+    std::string line_;
+    bool failed_ = false;  // a bad row ended the input
 };
 
 }  // namespace astvdp
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "csv_row_parser.h"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <system_error>
+
+namespace astvdp {
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+bool isTrim(char c) {
+    return c == ' ' || c == '\t';
+}
+}  // namespace
+
+bool parseCsvNumber(const char* p, const char* end, double& out) {
+    while (p != end && isSpace(*p)) ++p;
+
+    bool negative = false;
+    if (p != end && (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        ++p;
+        // from_chars accepts its own '-', which strtod would reject after a sign
+        if (p != end && (*p == '+' || *p == '-')) return false;
+    }
+
+    std::from_chars_result res;
+    if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        res = std::from_chars(p + 2, end, out, std::chars_format::hex);
+        if (res.ec == std::errc::invalid_argument) {
+            // "0x" without hex digits: strtod converts the leading "0"
+            out = 0.0;
+            res.ec = std::errc();
+        }
+    } else {
+        res = std::from_chars(p, end, out);
+    }
+    if (res.ec != std::errc()) return false;
+
+    if (negative) out = -out;
+    return true;
+}
+
+namespace {
+
+constexpr const char* kFieldNames[CsvSchema::kFieldCount] = {
+    "timestamp", "imu_ax", "imu_ay", "imu_az", "imu_gx", "imu_gy", "imu_gz",
+    "gps_lat", "gps_lon", "gps_alt", "gps_vx", "gps_vy",
+    "static_pressure", "temperature", "vib_x", "vib_y", "vib_z"};
+
+constexpr double TimestampedSample::*kMembers[CsvSchema::kFieldCount] = {
+    &TimestampedSample::timestamp, &TimestampedSample::imu_ax, &TimestampedSample::imu_ay,
+    &TimestampedSample::imu_az, &TimestampedSample::imu_gx, &TimestampedSample::imu_gy,
+    &TimestampedSample::imu_gz, &TimestampedSample::gps_lat, &TimestampedSample::gps_lon,
+    &TimestampedSample::gps_alt, &TimestampedSample::gps_vx, &TimestampedSample::gps_vy,
+    &TimestampedSample::static_pressure, &TimestampedSample::temperature,
+    &TimestampedSample::vib_x, &TimestampedSample::vib_y, &TimestampedSample::vib_z};
+
+const char* cellEnd(const char* p, const char* end) {
+    while (p != end && *p != ',') ++p;
+    return p;
+}
+
+// Header cell name: trimmed of spaces, tabs, CR and double quotes, lowercased
+std::string headerName(const char* b, const char* e) {
+    auto strip = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '"'; };
+    while (b != e && strip(*b)) ++b;
+    while (e != b && strip(e[-1])) --e;
+    std::string name(b, e);
+    for (char& c : name) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return name;
+}
+
+}  // namespace
+
+CsvSchema::CsvSchema() {
+    fields_.resize(kFieldCount);
+    for (uint8_t f = 0; f < kFieldCount; ++f) fields_[f] = f;
+    finish();
+}
+
+CsvSchema CsvSchema::fromHeader(const char* p, const char* end) {
+    CsvSchema schema;
+    if (end - p >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;  // UTF-8 BOM
+    std::vector<uint8_t> fields;
+    bool named = false;
+    bool in_place = true;  // every known name at its positional index
+    while (p != end) {
+        const char* cell_end = cellEnd(p, end);
+        const std::string name = headerName(p, cell_end);
+        uint8_t field = kSkip;
+        for (uint8_t f = 0; f < kFieldCount; ++f) {
+            if (name == kFieldNames[f]) {
+                field = f;
+                break;
+            }
+        }
+        // A repeated name keeps its first column
+        for (uint8_t earlier : fields) {
+            if (earlier == field) field = kSkip;
+        }
+        named = named || field != kSkip;
+        in_place = in_place && (field == kSkip || field == fields.size());
+        fields.push_back(field);
+        p = (cell_end == end) ? end : cell_end + 1;
+    }
+    if (!named) return schema;
+
+    std::string missing;
+    for (uint8_t f = kTimestamp; f <= kGpsVy; ++f) {
+        if (std::find(fields.begin(), fields.end(), f) == fields.end()) {
+            missing += missing.empty() ? kFieldNames[f] : std::string(", ") + kFieldNames[f];
+        }
+    }
+    if (!missing.empty() && in_place) return schema;
+
+    // Trailing skipped columns need no table entries
+    while (!fields.empty() && fields.back() == kSkip) fields.pop_back();
+    schema.fields_ = std::move(fields);
+    schema.positional_ = false;
+    schema.finish();
+    if (!missing.empty()) schema.error_ = "CSV header has no column for " + missing;
+    return schema;
+}
+
+const char* CsvSchema::fieldName(Field field) {
+    return kFieldNames[field];
+}
+
+void CsvSchema::finish() {
+    for (int& c : column_) c = -1;
+    for (size_t i = 0; i < fields_.size(); ++i) {
+        if (fields_[i] < kFieldCount) column_[fields_[i]] = static_cast<int>(i);
+    }
+    auto endOf = [this](std::initializer_list<Field> group) {
+        size_t end = 0;
+        for (Field f : group) {
+            if (column_[f] >= 0) end = std::max(end, static_cast<size_t>(column_[f]) + 1);
+        }
+        return end;
+    };
+    min_columns_ = endOf({kTimestamp, kImuAx, kImuAy, kImuAz, kImuGx, kImuGy, kImuGz,
+                          kGpsLat, kGpsLon, kGpsAlt, kGpsVx, kGpsVy});
+    pressure_end_ = endOf({kStaticPressure});
+    temperature_end_ = endOf({kTemperature});
+    vibration_end_ = endOf({kVibX, kVibY, kVibZ});
+}
+
+bool CsvSchema::parseRow(const char* p, const char* end, TimestampedSample& out,
+                         unsigned* optional_set) const {
+    double vals[kFieldCount];
+    const uint8_t unmapped = positional_ ? kDiscard : kSkip;
+    size_t count = 0;
+
+    while (p != end) {
+        const char* cell_end = cellEnd(p, end);
+        const uint8_t field = count < fields_.size() ? fields_[count] : unmapped;
+        if (field != kSkip) {
+            const char* b = p;
+            const char* e = cell_end;
+            while (b != e && isTrim(*b)) ++b;
+            while (e != b && isTrim(e[-1])) --e;
+
+            double v = 0.0;
+            if (b != e && !parseCsvNumber(b, e, v)) return false;
+            if (field < kFieldCount) vals[field] = v;
+        }
+        ++count;
+
+        // A trailing ',' does not open another cell (std::getline semantics)
+        p = (cell_end == end) ? end : cell_end + 1;
+    }
+    if (count < min_columns_ || count == 0) return false;
+
+    for (uint8_t f = kTimestamp; f <= kGpsVy; ++f) {
+        if (column_[f] >= 0) out.*kMembers[f] = vals[f];
+    }
+    unsigned set = 0;
+    if (pressure_end_ && count >= pressure_end_) {
+        out.static_pressure = vals[kStaticPressure];
+        set |= kSetsPressure;
+    }
+    if (temperature_end_ && count >= temperature_end_) {
+        out.temperature = vals[kTemperature];
+        set |= kSetsTemperature;
+    }
+    if (vibration_end_ && count >= vibration_end_) {
+        for (uint8_t f = kVibX; f <= kVibZ; ++f) {
+            if (column_[f] >= 0) out.*kMembers[f] = vals[f];
+        }
+        set |= kSetsVibration;
+    }
+    if (optional_set) *optional_set = set;
+    return true;
+}
+
+bool CsvSchema::parseTimestamp(const char* p, const char* end, double& out) const {
+    for (int skip = column_[kTimestamp]; skip > 0; --skip) {
+        const char* cell_end = cellEnd(p, end);
+        if (cell_end == end) return false;
+        p = cell_end + 1;
+    }
+    const char* e = cellEnd(p, end);
+    while (p != e && isTrim(*p)) ++p;
+    while (e != p && isTrim(e[-1])) --e;
+    out = 0.0;
+    return p == e || parseCsvNumber(p, e, out);
+}
+
+void CsvSchema::carryBefore(const char* data, size_t data_begin, size_t offset,
+                            TimestampedSample& out) const {
+    out.static_pressure = 0.0;
+    out.temperature = 0.0;
+    out.vib_x = out.vib_y = out.vib_z = 0.0;
+    unsigned missing = (pressure_end_ ? kSetsPressure : 0u) | (temperature_end_ ? kSetsTemperature : 0u) |
+                       (vibration_end_ ? kSetsVibration : 0u);
+
+    // Rows end at the '\n' before the next one; only the last row of the
+    // file may lack it
+    size_t end = offset;
+    while (missing && end > data_begin) {
+        const size_t line_end = data[end - 1] == '\n' ? end - 1 : end;
+        size_t begin = line_end;
+        while (begin > data_begin && data[begin - 1] != '\n') --begin;
+        TimestampedSample row{};
+        unsigned set = 0;
+        if (parseRow(data + begin, data + line_end, row, &set) && (set & missing)) {
+            if (set & missing & kSetsPressure) out.static_pressure = row.static_pressure;
+            if (set & missing & kSetsTemperature) out.temperature = row.temperature;
+            if (set & missing & kSetsVibration) {
+                out.vib_x = row.vib_x;
+                out.vib_y = row.vib_y;
+                out.vib_z = row.vib_z;
+            }
+            missing &= ~set;
+        }
+        end = begin;
+    }
+}
+
+bool parseCsvRow(const char* begin, const char* end, TimestampedSample& out) {
+    static const CsvSchema positional;
+    return positional.parseRow(begin, end, out);
+}
+
+}  // namespace astvdp
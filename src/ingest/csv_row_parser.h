@@ -0,0 +1,99 @@
+#pragma once
+#include "astvdp/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+// Allocation-free CSV row parsing with the same semantics as CsvIngest:
+// cells are split on ',', trimmed of spaces/tabs, empty cells read as 0.0 and
+// any converted cell that std::stod would reject makes the whole row invalid.
+
+// Parses one numeric cell the way std::stod does (leading whitespace, optional
+// sign, inf/nan, hex floats, trailing characters ignored).
+bool parseCsvNumber(const char* begin, const char* end, double& out);
+
+// Column -> field dispatch table, compiled once from a CSV header.
+//
+// Header cells are matched to the TimestampedSample field names (timestamp,
+// imu_ax, ..., vib_z), ignoring case, spaces and quotes, so columns may come
+// in any order. Columns with other names are skipped by the row parser and
+// never converted. A header without any known name keeps the positional
+// layout: columns are the fields in declaration order, and every cell is
+// converted, as the original fixed-layout reader did.
+//
+// A named header must name timestamp and every imu_* and gps_* column. If it
+// does not, but each name it does know sits at its positional index (e.g.
+// "timestamp,ax,ay,..."), the positional layout is kept. Otherwise the schema
+// is invalid and error() lists the missing columns.
+//
+// A row is valid once it reaches the last mapped column among timestamp,
+// imu_* and gps_* (12 columns in the positional layout). static_pressure,
+// temperature and vib_x/y/z (as one group) are set only by rows long enough
+// to hold them. Shorter rows leave those fields untouched, so they carry
+// over from the previous row.
+class CsvSchema {
+public:
+    enum Field : uint8_t {
+        kTimestamp, kImuAx, kImuAy, kImuAz, kImuGx, kImuGy, kImuGz,
+        kGpsLat, kGpsLon, kGpsAlt, kGpsVx, kGpsVy,
+        kStaticPressure, kTemperature, kVibX, kVibY, kVibZ,
+        kFieldCount
+    };
+    // Bits reported by parseRow() for the optional fields a row set
+    enum : unsigned { kSetsPressure = 1, kSetsTemperature = 2, kSetsVibration = 4 };
+
+    CsvSchema();  // positional layout
+
+    static CsvSchema fromHeader(const char* begin, const char* end);
+    static CsvSchema fromHeader(const std::string& header) {
+        return fromHeader(header.data(), header.data() + header.size());
+    }
+
+    static const char* fieldName(Field field);
+
+    // False for a named header that lacks required columns; error() says which
+    bool valid() const { return error_.empty(); }
+    const std::string& error() const { return error_; }
+    bool positional() const { return positional_; }
+    int column(Field field) const { return column_[field]; }  // -1 if absent
+
+    // Parses one data row, excluding its '\n' terminator. Leaves `out`
+    // unchanged if the row is invalid.
+    bool parseRow(const char* begin, const char* end, TimestampedSample& out,
+                  unsigned* optional_set = nullptr) const;
+
+    // Parses only the timestamp cell of a data row, for scanning rows
+    // without decoding them. Validates nothing beyond that cell.
+    bool parseTimestamp(const char* begin, const char* end, double& out) const;
+
+    // Sets in `out` the optional fields that rows before `offset` carry over
+    // to the row starting there, as reading from `data_begin` would: each
+    // group takes its values from the last valid row that sets it, or 0 if
+    // none does. Scans backwards and stops once every group the layout holds
+    // is found, so a group that short rows never set costs a scan back to
+    // `data_begin`.
+    void carryBefore(const char* data, size_t data_begin, size_t offset, TimestampedSample& out) const;
+
+private:
+    static constexpr uint8_t kSkip = 0xFF;     // named layout: not converted
+    static constexpr uint8_t kDiscard = 0xFE;  // positional layout: converted, unused
+
+    void finish();
+
+    std::vector<uint8_t> fields_;  // per column: Field, kSkip or kDiscard
+    int column_[kFieldCount];
+    size_t min_columns_ = 0;     // row length that holds every required field
+    size_t pressure_end_ = 0;    // row length that holds static_pressure (0: never)
+    size_t temperature_end_ = 0;
+    size_t vibration_end_ = 0;
+    bool positional_ = true;
+    std::string error_;
+};
+
+// Parses one data row with the positional layout
+bool parseCsvRow(const char* begin, const char* end, TimestampedSample& out);
+
+}  // namespace astvdp
@@ -0,0 +1,142 @@
+#include "csv_time_index.h"
+#include "csv_row_parser.h"
+#include "core/mapped_file.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace astvdp {
+
+namespace {
+
+// Sidecar layout, little-endian: magic, u32 version, u32 stride, u64 CSV
+// size, i64 CSV mtime, u64 data offset, u64 entry count, entries
+constexpr char kMagic[8] = {'A', 'S', 'T', 'V', 'D', 'P', 'I', '\1'};
+constexpr uint32_t kVersion = 1;
+
+struct SidecarHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t stride;
+    uint64_t csv_size;
+    int64_t csv_mtime;
+    uint64_t data_offset;
+    uint64_t count;
+};
+static_assert(sizeof(SidecarHeader) == 48, "SidecarHeader is written to disk as-is");
+static_assert(sizeof(CsvTimeIndex::Entry) == 16, "Entry is written to disk as-is");
+
+}  // namespace
+
+std::string CsvTimeIndex::sidecarPath(const std::string& csv_path) {
+    return csv_path + ".tidx";
+}
+
+bool CsvTimeIndex::load(const std::string& csv_path) {
+    std::error_code ec;
+    const auto csv_size = static_cast<uint64_t>(std::filesystem::file_size(csv_path, ec));
+    if (ec) return false;
+    const auto csv_mtime =
+        static_cast<int64_t>(std::filesystem::last_write_time(csv_path, ec).time_since_epoch().count());
+    if (ec) return false;
+
+    const std::string sidecar = sidecarPath(csv_path);
+    if (readSidecar(sidecar, csv_size, csv_mtime)) return true;
+
+    MappedFile file;
+    if (!file.open(csv_path) || !build(file.data(), file.size())) return false;
+    writeSidecar(sidecar, csv_size, csv_mtime);
+    return true;
+}
+
+bool CsvTimeIndex::build(const char* data, size_t size) {
+    entries_.clear();
+    const char* nl = size ? static_cast<const char*>(std::memchr(data, '\n', size)) : nullptr;
+    data_offset_ = nl ? static_cast<uint64_t>(nl - data) + 1 : size;
+    const CsvSchema schema = CsvSchema::fromHeader(data, nl ? nl : data + size);
+
+    size_t pos = data_offset_;
+    for (uint64_t row = 0; pos < size; ++row) {
+        const char* begin = data + pos;
+        const char* end = static_cast<const char*>(std::memchr(begin, '\n', size - pos));
+        if (!end) end = data + size;
+        double t;
+        // Rows whose timestamp does not parse end the readers, so they are
+        // never a useful seek target
+        if (row % kStride == 0 && schema.parseTimestamp(begin, end, t)) entries_.push_back({t, pos});
+        pos = static_cast<size_t>(end - data) + 1;
+    }
+    return true;
+}
+
+uint64_t CsvTimeIndex::scanStart(double t) const {
+    // First entry not before t; the one preceding it is the last before t
+    const auto it = std::partition_point(entries_.begin(), entries_.end(),
+                                         [t](const Entry& e) { return e.timestamp < t; });
+    return it == entries_.begin() ? data_offset_ : std::prev(it)->offset;
+}
+
+size_t CsvTimeIndex::seekOffset(const char* data, size_t size, double t) const {
+    const char* nl = size ? static_cast<const char*>(std::memchr(data, '\n', size)) : nullptr;
+    const CsvSchema schema = CsvSchema::fromHeader(data, nl ? nl : data + size);
+    size_t pos = std::min<size_t>(scanStart(t), size);
+    while (pos < size) {
+        const char* begin = data + pos;
+        const char* end = static_cast<const char*>(std::memchr(begin, '\n', size - pos));
+        if (!end) end = data + size;
+        double row_time;
+        if (!schema.parseTimestamp(begin, end, row_time) || row_time >= t) break;
+        pos = static_cast<size_t>(end - data) + 1;
+    }
+    return std::min(pos, size);
+}
+
+bool CsvTimeIndex::readSidecar(const std::string& path, uint64_t csv_size, int64_t csv_mtime) {
+    std::ifstream in(path, std::ios::binary);
+    SidecarHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof header)) return false;
+    if (std::memcmp(header.magic, kMagic, sizeof kMagic) != 0 || header.version != kVersion ||
+        header.stride != kStride || header.csv_size != csv_size || header.csv_mtime != csv_mtime ||
+        header.data_offset > csv_size || header.count > csv_size / 2 + 1) {
+        return false;
+    }
+    entries_.resize(header.count);
+    if (header.count &&
+        !in.read(reinterpret_cast<char*>(entries_.data()),
+                 static_cast<std::streamsize>(header.count * sizeof(Entry)))) {
+        entries_.clear();
+        return false;
+    }
+    data_offset_ = header.data_offset;
+    return true;
+}
+
+void CsvTimeIndex::writeSidecar(const std::string& path, uint64_t csv_size, int64_t csv_mtime) const {
+    SidecarHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof kMagic);
+    header.version = kVersion;
+    header.stride = kStride;
+    header.csv_size = csv_size;
+    header.csv_mtime = csv_mtime;
+    header.data_offset = data_offset_;
+    header.count = entries_.size();
+
+    // Write under a temporary name so a concurrent reader never sees half a file
+    const std::string tmp = path + ".tmp";
+    bool written;
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof header);
+        out.write(reinterpret_cast<const char*>(entries_.data()),
+                  static_cast<std::streamsize>(entries_.size() * sizeof(Entry)));
+        out.close();
+        written = !out.fail();
+    }
+    std::error_code ec;
+    if (written) std::filesystem::rename(tmp, path, ec);
+    if (!written || ec) std::filesystem::remove(tmp, ec);
+}
+
+}  // namespace astvdp
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+// Sparse timestamp -> byte offset index over the data rows of a CSV file,
+// one entry every kStride rows. It is built by one newline scan that parses
+// only the sampled timestamps, and cached next to the CSV as "<file>.tidx".
+// The cache is rebuilt when the CSV's size or modification time changes.
+class CsvTimeIndex {
+public:
+    static constexpr uint32_t kStride = 1024;
+
+    struct Entry {
+        double timestamp;
+        uint64_t offset;  // start of the row in the CSV
+    };
+
+    static std::string sidecarPath(const std::string& csv_path);
+
+    // Loads the sidecar or builds the index and (re)writes the sidecar; a
+    // sidecar that cannot be written is not an error.
+    bool load(const std::string& csv_path);
+
+    // Where to start scanning for the first row with timestamp >= t: the last
+    // indexed row before t, or the first data row. Assumes timestamps do not
+    // decrease.
+    uint64_t scanStart(double t) const;
+
+    // Offset of the first row with timestamp >= t in the mapped CSV, found by
+    // scanning from scanStart(t) and parsing only timestamps. A row whose
+    // timestamp does not parse also stops the scan, so readers reject it.
+    size_t seekOffset(const char* data, size_t size, double t) const;
+
+    const std::vector<Entry>& entries() const { return entries_; }
+    uint64_t dataOffset() const { return data_offset_; }
+
+private:
+    bool build(const char* data, size_t size);
+    bool readSidecar(const std::string& path, uint64_t csv_size, int64_t csv_mtime);
+    void writeSidecar(const std::string& path, uint64_t csv_size, int64_t csv_mtime) const;
+
+    std::vector<Entry> entries_;
+    uint64_t data_offset_ = 0;  // first byte after the header line
+};
+
+}  // namespace astvdp
@@ -0,0 +1,58 @@
+#include "ingest_factory.h"
+#include "archive_ingest.h"
+#include "csv_ingest.h"
+#include "mmap_csv_ingest.h"
+#include "parallel_csv_ingest.h"
+#include "stream_ingest.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace astvdp {
+
+namespace {
+
+// Why no CSV reader opened `path`: its header's problem if it has one
+std::string csvOpenError(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::string header;
+    if (!in || !std::getline(in, header)) return "cannot read " + path;
+    const CsvSchema schema = CsvSchema::fromHeader(header);
+    return schema.valid() ? "cannot read " + path : schema.error();
+}
+
+}  // namespace
+
+std::unique_ptr<DataIngest> openIngest(const std::string& path, size_t parse_threads, std::string* error) {
+    std::unique_ptr<DataIngest> ingest;
+    // Before any sniffing: reading a pipe's magic would consume its data
+    if (StreamIngest::isStreamSource(path)) {
+        auto stream = std::make_unique<StreamIngest>();
+        if (stream->open(path)) return stream;
+        if (error) *error = stream->headerError().empty() ? "cannot read " + path : stream->headerError();
+        return nullptr;
+    }
+    if (ArchiveIngest::isArchive(path)) {
+        ingest = std::make_unique<ArchiveIngest>();
+        if (ingest->open(path)) return ingest;
+        if (error) *error = "damaged archive " + path;
+        return nullptr;
+    }
+    if (parse_threads == 0) {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path, ec);
+        parse_threads = (!ec && size >= kParallelParseMinBytes) ? std::thread::hardware_concurrency() : 1;
+    }
+    if (parse_threads > 1) {
+        ingest = std::make_unique<ParallelCsvIngest>(parse_threads);
+        if (ingest->open(path)) return ingest;
+    }
+    ingest = std::make_unique<MmapCsvIngest>();
+    if (ingest->open(path)) return ingest;
+    ingest = std::make_unique<CsvIngest>();
+    if (ingest->open(path)) return ingest;
+    if (error) *error = csvOpenError(path);
+    return nullptr;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,23 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace astvdp {
+
+// CSV files at least this large are parsed on every core when
+// openIngest() is left to choose
+constexpr size_t kParallelParseMinBytes = size_t{64} << 20;
+
+// Opens `path` with the reader that suits it: StreamIngest for stdin ("-"),
+// "unix:<socket>", FIFOs and devices, a columnar archive by its magic,
+// otherwise a memory-mapped CSV reader, falling back to CsvIngest for files
+// that cannot be mapped. CSVs are parsed on `parse_threads`
+// threads (ParallelCsvIngest) when that is above 1. With 0, files of
+// kParallelParseMinBytes or more use every hardware thread. Returns nullptr
+// if nothing can open the path, with the reason in `*error` when given.
+std::unique_ptr<DataIngest> openIngest(const std::string& path, size_t parse_threads = 1,
+                                       std::string* error = nullptr);
+
+}  // namespace astvdp
@@ -0,0 +1,39 @@
+#include "memory_ingest.h"
+#include <algorithm>
+#include <utility>
+
+namespace astvdp {
+
+MemoryIngest::MemoryIngest(std::vector<TimestampedSample> samples)
+    : samples_(std::move(samples)) {}
+
+bool MemoryIngest::open(const std::string&) {
+    pos_ = 0;
+    return true;
+}
+
+bool MemoryIngest::readNext(TimestampedSample& out) {
+    if (pos_ >= samples_.size()) return false;
+    out = samples_[pos_++];
+    return true;
+}
+
+size_t MemoryIngest::readBatch(SampleBlock& out) {
+    out.clear();
+    while (!out.full() && pos_ < samples_.size()) out.push(samples_[pos_++]);
+    return out.size;
+}
+
+bool MemoryIngest::seek(double timestamp) {
+    const auto it = std::partition_point(samples_.begin(), samples_.end(), [timestamp](const TimestampedSample& s) {
+        return s.timestamp < timestamp;
+    });
+    pos_ = static_cast<size_t>(it - samples_.begin());
+    return true;
+}
+
+void MemoryIngest::close() {
+    pos_ = samples_.size();
+}
+
+}  // namespace astvdp
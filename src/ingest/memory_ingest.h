@@ -0,0 +1,28 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+// Serves samples the caller already holds in memory, for embedding the
+// pipeline without a file round-trip. open() ignores its argument.
+class MemoryIngest : public DataIngest {
+public:
+    explicit MemoryIngest(std::vector<TimestampedSample> samples = {});
+
+    void append(const TimestampedSample& sample) { samples_.push_back(sample); }
+
+    bool open(const std::string& source) override;
+    bool readNext(TimestampedSample& out) override;
+    size_t readBatch(SampleBlock& out) override;
+    void close() override;
+    bool seek(double timestamp) override;
+
+private:
+    std::vector<TimestampedSample> samples_;
+    size_t pos_ = 0;
+};
+
+}  // namespace astvdp
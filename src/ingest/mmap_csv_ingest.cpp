@@ -0,0 +1,83 @@
+#include "mmap_csv_ingest.h"
+#include "csv_row_parser.h"
+#include "core/profiler.h"
+#include <cstring>
+
+namespace astvdp {
+
+bool MmapCsvIngest::open(const std::string& path) {
+    if (!file_.open(path)) return false;
+    pos_ = 0;
+    path_ = path;
+    index_loaded_ = false;
+    failed_ = false;
+    batch_row_ = TimestampedSample{};
+
+    const char* data = file_.data();
+    const size_t size = file_.size();
+    const char* nl = size ? static_cast<const char*>(std::memchr(data, '\n', size)) : nullptr;
+    const size_t header_len = nl ? static_cast<size_t>(nl - data) : size;
+    header_.assign(data ? data : "", header_len);
+    schema_ = CsvSchema::fromHeader(header_);
+    pos_ = nl ? header_len + 1 : size;
+    if (!schema_.valid()) {
+        file_.close();
+        return false;
+    }
+    return true;
+}
+
+bool MmapCsvIngest::nextLine(const char*& begin, const char*& end) {
+    const size_t size = file_.size();
+    if (pos_ >= size) return false;
+
+    begin = file_.data() + pos_;
+    const char* nl = static_cast<const char*>(std::memchr(begin, '\n', size - pos_));
+    end = nl ? nl : file_.data() + size;
+    pos_ = nl ? static_cast<size_t>(nl - file_.data()) + 1 : size;
+    return true;
+}
+
+bool MmapCsvIngest::readNext(TimestampedSample& out) {
+    const char* begin;
+    const char* end;
+    const size_t start = pos_;
+    if (failed_ || !nextLine(begin, end)) return false;
+    Profiler::count(Profiler::kBytesParsed, pos_ - start);
+    failed_ = !schema_.parseRow(begin, end, out);
+    return !failed_;
+}
+
+size_t MmapCsvIngest::readBatch(SampleBlock& out) {
+    out.clear();
+    const size_t start = pos_;
+    const char* begin;
+    const char* end;
+    while (!failed_ && !out.full() && nextLine(begin, end)) {
+        failed_ = !schema_.parseRow(begin, end, batch_row_);
+        if (!failed_) out.set(out.size++, batch_row_);
+    }
+    Profiler::count(Profiler::kBytesParsed, pos_ - start);
+    return out.size;
+}
+
+bool MmapCsvIngest::seek(double timestamp) {
+    if (!file_.isOpen()) return false;
+    if (!index_loaded_) {
+        if (!index_.load(path_)) return false;
+        index_loaded_ = true;
+    }
+    pos_ = index_.seekOffset(file_.data(), file_.size(), timestamp);
+    schema_.carryBefore(file_.data(), index_.dataOffset(), pos_, batch_row_);
+    failed_ = false;
+    return true;
+}
+
+void MmapCsvIngest::close() {
+    file_.close();
+    pos_ = 0;
+    batch_row_ = TimestampedSample{};
+    failed_ = false;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,37 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include "core/mapped_file.h"
+#include "csv_row_parser.h"
+#include "csv_time_index.h"
+#include <cstddef>
+#include <string>
+
+namespace astvdp {
+
+// Memory-mapped CSV reader. Rows are scanned in place and parsed without
+// per-row allocation through the header's CsvSchema; produces the same
+// samples as CsvIngest for any file.
+class MmapCsvIngest : public DataIngest {
+public:
+    bool open(const std::string& path) override;
+    bool readNext(TimestampedSample& out) override;
+    size_t readBatch(SampleBlock& out) override;
+    void close() override;
+    // Uses the sidecar time index (see CsvTimeIndex), built on first use
+    bool seek(double timestamp) override;
+
+private:
+    bool nextLine(const char*& begin, const char*& end);
+
+    MappedFile file_;
+    std::string path_;
+    CsvTimeIndex index_;
+    bool index_loaded_ = false;
+    std::string header_;
+    CsvSchema schema_;
+    size_t pos_ = 0;
+    TimestampedSample batch_row_{};  // carries unset columns across batched rows
+    bool failed_ = false;            // a bad row ended the input
+};
+
+}  // namespace astvdp
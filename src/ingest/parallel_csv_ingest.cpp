@@ -0,0 +1,218 @@
+#include "parallel_csv_ingest.h"
+#include "csv_row_parser.h"
+#include "core/profiler.h"
+#include "core/tracer.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace astvdp {
+
+namespace {
+
+constexpr size_t kNotSet = static_cast<size_t>(-1);
+
+size_t poolThreads(size_t threads) {
+    return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+}  // namespace
+
+ParallelCsvIngest::ParallelCsvIngest(size_t threads, size_t chunk_bytes)
+    : pool_(poolThreads(threads)),
+      chunk_bytes_(std::max<size_t>(chunk_bytes, 1)),
+      window_(2 * pool_.size()) {}
+
+ParallelCsvIngest::~ParallelCsvIngest() {
+    close();
+}
+
+bool ParallelCsvIngest::open(const std::string& path) {
+    close();
+    if (!file_.open(path)) return false;
+    path_ = path;
+    index_loaded_ = false;
+    failed_ = false;
+
+    const char* data = file_.data();
+    const size_t size = file_.size();
+    const char* nl = size ? static_cast<const char*>(std::memchr(data, '\n', size)) : nullptr;
+    schema_ = CsvSchema::fromHeader(data, data + (nl ? static_cast<size_t>(nl - data) : size));
+    if (!schema_.valid()) {
+        file_.close();
+        return false;
+    }
+    next_split_ = nl ? static_cast<size_t>(nl - data) + 1 : size;
+    fill();
+    return true;
+}
+
+void ParallelCsvIngest::parse(Chunk& chunk) const {
+    ScopedTrace span("csv_chunk", "ingest");
+    const char* data = file_.data();
+    const char* p = data + chunk.begin;
+    const char* const end = data + chunk.end;
+
+    // Low first guess at the row count; doubles below as rows arrive
+    const size_t guess = std::max<size_t>((chunk.end - chunk.begin) / 256, 64);
+    if (chunk.rows.capacity() < guess) chunk.rows.reserve(guess);
+    chunk.rows.clear();
+    chunk.bad.clear();
+    std::fill(std::begin(chunk.first_set), std::end(chunk.first_set), kNotSet);
+
+    TimestampedSample row{};
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* line_end = nl ? nl : end;
+        unsigned set;
+        if (schema_.parseRow(p, line_end, row, &set)) {
+            SampleBlock& rows = chunk.rows;
+            if (rows.full()) rows.reserve(rows.capacity() * 2);
+            if ((set & CsvSchema::kSetsPressure) && chunk.first_set[0] == kNotSet) chunk.first_set[0] = rows.size;
+            if ((set & CsvSchema::kSetsTemperature) && chunk.first_set[1] == kNotSet) chunk.first_set[1] = rows.size;
+            if ((set & CsvSchema::kSetsVibration) && chunk.first_set[2] == kNotSet) chunk.first_set[2] = rows.size;
+            rows.set(rows.size++, row);
+        } else {
+            chunk.bad.push_back(chunk.rows.size);
+        }
+        p = nl ? nl + 1 : end;
+    }
+}
+
+void ParallelCsvIngest::fill() {
+    const char* data = file_.data();
+    const size_t size = file_.size();
+    while (chunks_.size() < window_ && next_split_ < size) {
+        std::unique_ptr<Chunk> chunk;
+        if (spare_.empty()) {
+            chunk = std::make_unique<Chunk>();
+        } else {
+            chunk = std::move(spare_.back());
+            spare_.pop_back();
+        }
+        chunk->begin = next_split_;
+        size_t end = std::min(next_split_ + chunk_bytes_, size);
+        if (end < size) {
+            const char* nl = static_cast<const char*>(std::memchr(data + end, '\n', size - end));
+            end = nl ? static_cast<size_t>(nl - data) + 1 : size;
+        }
+        chunk->end = end;
+        chunk->ready = false;
+        chunk->started = false;
+        next_split_ = end;
+
+        Chunk* task = chunk.get();
+        chunks_.push_back(std::move(chunk));
+        pool_.submit([this, task] {
+            parse(*task);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                task->ready = true;
+            }
+            ready_cv_.notify_all();
+        });
+    }
+}
+
+void ParallelCsvIngest::discard() {
+    pool_.wait();
+    for (auto& chunk : chunks_) spare_.push_back(std::move(chunk));
+    chunks_.clear();
+    row_pos_ = 0;
+    bad_pos_ = 0;
+}
+
+ParallelCsvIngest::Chunk* ParallelCsvIngest::current() {
+    for (;;) {
+        if (chunks_.empty()) return nullptr;
+        Chunk& chunk = *chunks_.front();
+        if (!chunk.started) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_cv_.wait(lock, [&chunk] { return chunk.ready; });
+            }
+            // Rows before a chunk's first full-width row inherit the columns
+            // they leave unset from the rows before the chunk
+            SampleBlock& rows = chunk.rows;
+            const size_t pressure_end = std::min(chunk.first_set[0], rows.size);
+            const size_t temperature_end = std::min(chunk.first_set[1], rows.size);
+            const size_t vib_end = std::min(chunk.first_set[2], rows.size);
+            std::fill_n(rows.static_pressure.begin(), pressure_end, carry_.static_pressure);
+            std::fill_n(rows.temperature.begin(), temperature_end, carry_.temperature);
+            std::fill_n(rows.vib_x.begin(), vib_end, carry_.vib_x);
+            std::fill_n(rows.vib_y.begin(), vib_end, carry_.vib_y);
+            std::fill_n(rows.vib_z.begin(), vib_end, carry_.vib_z);
+            if (rows.size > 0) carry_ = rows.get(rows.size - 1);
+            chunk.started = true;
+            Profiler::count(Profiler::kBytesParsed, chunk.end - chunk.begin);
+        }
+        if (row_pos_ < chunk.rows.size || bad_pos_ < chunk.bad.size()) return &chunk;
+
+        spare_.push_back(std::move(chunks_.front()));
+        chunks_.pop_front();
+        row_pos_ = 0;
+        bad_pos_ = 0;
+        fill();
+    }
+}
+
+void ParallelCsvIngest::fail() {
+    failed_ = true;
+    discard();
+    next_split_ = file_.size();  // nothing more is parsed
+}
+
+bool ParallelCsvIngest::readNext(TimestampedSample& out) {
+    Chunk* chunk = failed_ ? nullptr : current();
+    if (!chunk) return false;
+    if (bad_pos_ < chunk->bad.size() && chunk->bad[bad_pos_] == row_pos_) {
+        fail();
+        return false;
+    }
+    out = chunk->rows.get(row_pos_++);
+    return true;
+}
+
+size_t ParallelCsvIngest::readBatch(SampleBlock& out) {
+    out.clear();
+    while (!failed_ && !out.full()) {
+        Chunk* chunk = current();
+        if (!chunk) break;
+        // A bad line ends the input, as in MmapCsvIngest
+        if (bad_pos_ < chunk->bad.size() && chunk->bad[bad_pos_] == row_pos_) {
+            fail();
+            break;
+        }
+        const size_t limit = bad_pos_ < chunk->bad.size() ? chunk->bad[bad_pos_] : chunk->rows.size;
+        const size_t n = std::min(limit - row_pos_, out.capacity() - out.size);
+        out.copyRows(out.size, chunk->rows, row_pos_, n);
+        out.size += n;
+        row_pos_ += n;
+    }
+    return out.size;
+}
+
+bool ParallelCsvIngest::seek(double timestamp) {
+    if (!file_.isOpen()) return false;
+    if (!index_loaded_) {
+        if (!index_.load(path_)) return false;
+        index_loaded_ = true;
+    }
+    discard();
+    next_split_ = index_.seekOffset(file_.data(), file_.size(), timestamp);
+    carry_ = TimestampedSample{};
+    schema_.carryBefore(file_.data(), index_.dataOffset(), next_split_, carry_);
+    failed_ = false;
+    fill();
+    return true;
+}
+
+void ParallelCsvIngest::close() {
+    discard();
+    file_.close();
+    next_split_ = 0;
+    carry_ = TimestampedSample{};
+    failed_ = false;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,81 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include "core/mapped_file.h"
+#include "core/work_stealing_pool.h"
+#include "csv_row_parser.h"
+#include "csv_time_index.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+// Memory-mapped CSV reader that parses on a thread pool. The file is cut into
+// newline-aligned chunks of about chunk_bytes. Each chunk is parsed into its
+// own SampleBlock on a worker, and chunks are handed out strictly in file
+// order. Columns that short rows leave unset are carried across chunk edges
+// when a chunk is handed out. Blocks, values and the bad row that ends the
+// input match MmapCsvIngest exactly. Only a window of 2 chunks per thread is
+// held in memory, so files of any size stream through.
+class ParallelCsvIngest : public DataIngest {
+public:
+    static constexpr size_t kDefaultChunkBytes = size_t{1} << 20;
+
+    // threads == 0 uses every hardware thread
+    explicit ParallelCsvIngest(size_t threads = 0, size_t chunk_bytes = kDefaultChunkBytes);
+    ~ParallelCsvIngest() override;
+
+    ParallelCsvIngest(const ParallelCsvIngest&) = delete;
+    ParallelCsvIngest& operator=(const ParallelCsvIngest&) = delete;
+
+    bool open(const std::string& path) override;
+    bool readNext(TimestampedSample& out) override;
+    size_t readBatch(SampleBlock& out) override;
+    void close() override;
+    bool seek(double timestamp) override;
+
+    size_t threads() const { return pool_.size(); }
+
+private:
+    struct Chunk {
+        size_t begin = 0;  // byte range in the file
+        size_t end = 0;
+        SampleBlock rows{0};
+        std::vector<size_t> bad;  // one entry per unparseable line: good rows before it
+        size_t first_set[3] = {};  // first row setting static_pressure, temperature, vib_*
+        bool ready = false;       // guarded by mutex_
+        bool started = false;     // carried columns filled in (reader thread only)
+    };
+
+    void parse(Chunk& chunk) const;
+    void fill();     // submits chunks until the window is full
+    void discard();  // waits for in-flight chunks and drops them
+    void fail();     // a bad row: drops everything after it
+    Chunk* current();
+
+    WorkStealingPool pool_;
+    size_t chunk_bytes_;
+    size_t window_;
+    MappedFile file_;
+    CsvSchema schema_;
+    std::string path_;
+    CsvTimeIndex index_;
+    bool index_loaded_ = false;
+    size_t next_split_ = 0;  // start of the next chunk to submit
+
+    std::deque<std::unique_ptr<Chunk>> chunks_;  // in file order
+    std::vector<std::unique_ptr<Chunk>> spare_;
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;
+
+    size_t row_pos_ = 0;  // in the front chunk
+    size_t bad_pos_ = 0;
+    TimestampedSample carry_{};  // last row handed out, for carried columns
+    bool failed_ = false;        // a bad row ended the input
+};
+
+}  // namespace astvdp
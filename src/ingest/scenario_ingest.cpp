@@ -0,0 +1,72 @@
+#include "scenario_ingest.h"
+#include "simulation/flight_simulator.h"
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+namespace astvdp {
+
+ScenarioIngest::ScenarioIngest(const Scenario& scenario, size_t threads, std::string csv_copy)
+    : sim_(scenario), csv_path_(std::move(csv_copy)) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads > 1) pool_ = std::make_unique<WorkStealingPool>(threads);
+}
+
+bool ScenarioIngest::open(const std::string&) {
+    close();
+    if (!csv_path_.empty()) {
+        csv_.open(csv_path_);
+        if (!csv_.is_open()) return false;
+        FlightSimulator::writeCsvHeader(csv_);
+    }
+    open_ = true;
+    return true;
+}
+
+bool ScenarioIngest::readNext(TimestampedSample& out) {
+    if (!open_ || pos_ >= sim_.size()) return false;
+    if (pos_ < rows_first_ || pos_ - rows_first_ >= rows_.size) {
+        rows_first_ = pos_ - pos_ % ScenarioSimulator::kNoiseTile;
+        rows_.size = static_cast<size_t>(
+            std::min<uint64_t>(ScenarioSimulator::kNoiseTile, sim_.size() - rows_first_));
+        sim_.generate(rows_first_, rows_.size, rows_);
+    }
+    out = rows_.get(static_cast<size_t>(pos_++ - rows_first_));
+    if (csv_.is_open()) FlightSimulator::writeCsvRow(csv_, out);
+    return true;
+}
+
+size_t ScenarioIngest::readBatch(SampleBlock& out) {
+    out.clear();
+    if (!open_ || pos_ >= sim_.size()) return 0;
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(out.capacity(), sim_.size() - pos_));
+    if (pool_) {
+        sim_.generate(pos_, n, out, 0, *pool_);
+    } else {
+        sim_.generate(pos_, n, out);
+    }
+    pos_ += n;
+    out.size = n;
+    if (csv_.is_open()) writeCsv(out);
+    return n;
+}
+
+void ScenarioIngest::writeCsv(const SampleBlock& block) {
+    for (size_t i = 0; i < block.size; ++i) FlightSimulator::writeCsvRow(csv_, block.get(i));
+}
+
+void ScenarioIngest::close() {
+    open_ = false;
+    pos_ = 0;
+    rows_.clear();
+    if (csv_.is_open()) csv_.close();
+    csv_.clear();
+}
+
+bool ScenarioIngest::seek(double timestamp) {
+    if (!open_) return false;
+    pos_ = sim_.indexAt(timestamp);
+    return true;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,45 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include "core/work_stealing_pool.h"
+#include "simulation/scenario_simulator.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace astvdp {
+
+// Feeds a scenario flight into the pipeline, generating each block in place
+// when it is read, split across `threads` (0: every hardware thread).
+// Blocks are identical for any thread count. Seeking is exact and free,
+// since sample times are known in closed form. With a non-empty `csv_copy`,
+// every sample handed out is also written there in the
+// FlightSimulator::saveToCsv() layout. open() ignores its argument.
+class ScenarioIngest : public DataIngest {
+public:
+    explicit ScenarioIngest(const Scenario& scenario, size_t threads = 0, std::string csv_copy = {});
+
+    bool open(const std::string& source) override;  // false if csv_copy cannot be created
+    bool readNext(TimestampedSample& out) override;
+    size_t readBatch(SampleBlock& out) override;
+    void close() override;
+    bool seek(double timestamp) override;
+
+    const ScenarioSimulator& simulator() const { return sim_; }
+
+private:
+    void writeCsv(const SampleBlock& block);
+
+    ScenarioSimulator sim_;
+    std::unique_ptr<WorkStealingPool> pool_;  // null when generating inline
+    std::string csv_path_;
+    std::ofstream csv_;
+    // readNext() staging: the aligned noise tile holding pos_, so rows read
+    // one at a time cost one tile per kNoiseTile rows
+    SampleBlock rows_{ScenarioSimulator::kNoiseTile};
+    uint64_t rows_first_ = 0;  // sample index of rows_ row 0
+    uint64_t pos_ = 0;
+    bool open_ = false;
+};
+
+}  // namespace astvdp
@@ -0,0 +1,42 @@
+#include "simulator_ingest.h"
+#include <utility>
+
+namespace astvdp {
+
+SimulatorIngest::SimulatorIngest(const FlightSimulator::Profile& profile, std::string csv_copy)
+    : profile_(profile), csv_path_(std::move(csv_copy)) {}
+
+bool SimulatorIngest::open(const std::string&) {
+    close();
+    if (!csv_path_.empty()) {
+        csv_.open(csv_path_);
+        if (!csv_.is_open()) return false;
+        FlightSimulator::writeCsvHeader(csv_);
+    }
+    stream_ = std::make_unique<FlightSimulator::Stream>(profile_);
+    return true;
+}
+
+bool SimulatorIngest::readNext(TimestampedSample& out) {
+    if (!stream_ || !stream_->next(out)) return false;
+    if (csv_.is_open()) FlightSimulator::writeCsvRow(csv_, out);
+    return true;
+}
+
+size_t SimulatorIngest::readBatch(SampleBlock& out) {
+    out.clear();
+    if (!stream_) return 0;
+    stream_->fill(out);
+    if (csv_.is_open()) {
+        for (size_t i = 0; i < out.size; ++i) FlightSimulator::writeCsvRow(csv_, out.get(i));
+    }
+    return out.size;
+}
+
+void SimulatorIngest::close() {
+    stream_.reset();
+    if (csv_.is_open()) csv_.close();
+    csv_.clear();
+}
+
+}  // namespace astvdp
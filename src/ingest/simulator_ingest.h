@@ -0,0 +1,31 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include "simulation/flight_simulator.h"
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace astvdp {
+
+// Feeds a simulated flight straight into the pipeline, generating each block
+// as it is read, so a flight of any length runs in constant memory. The
+// samples are exactly those FlightSimulator::generate() returns. With a
+// non-empty `csv_copy`, every sample handed out is also written there in
+// the saveToCsv() layout. open() ignores its argument.
+class SimulatorIngest : public DataIngest {
+public:
+    explicit SimulatorIngest(const FlightSimulator::Profile& profile, std::string csv_copy = {});
+
+    bool open(const std::string& source) override;  // false if csv_copy cannot be created
+    bool readNext(TimestampedSample& out) override;
+    size_t readBatch(SampleBlock& out) override;
+    void close() override;
+
+private:
+    FlightSimulator::Profile profile_;
+    std::string csv_path_;
+    std::unique_ptr<FlightSimulator::Stream> stream_;
+    std::ofstream csv_;
+};
+
+}  // namespace astvdp
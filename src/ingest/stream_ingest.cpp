@@ -0,0 +1,188 @@
+#include "stream_ingest.h"
+#include "core/profiler.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace astvdp {
+
+namespace {
+
+constexpr const char kUnixPrefix[] = "unix:";
+constexpr size_t kUnixPrefixLen = sizeof kUnixPrefix - 1;
+
+bool isStdin(const std::string& source) {
+    return source == "-" || source == "stdin";
+}
+
+int openSource(const std::string& source, bool& owned) {
+    owned = false;
+    if (isStdin(source)) {
+#ifdef _WIN32
+        _setmode(0, _O_BINARY);
+#endif
+        return 0;
+    }
+    owned = true;
+#ifdef _WIN32
+    if (source.compare(0, kUnixPrefixLen, kUnixPrefix) == 0) return -1;
+    return _open(source.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    if (source.compare(0, kUnixPrefixLen, kUnixPrefix) == 0) {
+        const std::string path = source.substr(kUnixPrefixLen);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof addr.sun_path) return -1;
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof addr) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+    return ::open(source.c_str(), O_RDONLY);
+#endif
+}
+
+long readSome(int fd, char* data, size_t size) {
+#ifdef _WIN32
+    return _read(fd, data, static_cast<unsigned>(size));
+#else
+    for (;;) {
+        const ssize_t n = ::read(fd, data, size);
+        if (n >= 0 || errno != EINTR) return static_cast<long>(n);
+    }
+#endif
+}
+
+void closeFd(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+}  // namespace
+
+StreamIngest::~StreamIngest() {
+    close();
+}
+
+bool StreamIngest::isStreamSource(const std::string& source) {
+    if (isStdin(source) || source.compare(0, kUnixPrefixLen, kUnixPrefix) == 0) return true;
+    std::error_code ec;
+    const auto type = std::filesystem::status(source, ec).type();
+    return !ec && (type == std::filesystem::file_type::fifo || type == std::filesystem::file_type::socket ||
+                   type == std::filesystem::file_type::character);
+}
+
+bool StreamIngest::open(const std::string& source) {
+    close();
+    skipped_ = 0;
+    fd_ = openSource(source, owns_fd_);
+    if (fd_ < 0) return false;
+    buffer_.resize(kReadSize);
+
+    const char* begin;
+    const char* end;
+    schema_ = nextLine(begin, end, true) ? CsvSchema::fromHeader(begin, end) : CsvSchema();
+    if (!schema_.valid()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool StreamIngest::fill() {
+    if (begin_ > 0) {
+        // Move the partial line to the front before reading more
+        std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+    if (end_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);  // line longer than the buffer
+    const long n = readSome(fd_, buffer_.data() + end_, buffer_.size() - end_);
+    if (n <= 0) return false;
+    end_ += static_cast<size_t>(n);
+    Profiler::count(Profiler::kBytesParsed, static_cast<uint64_t>(n));
+    return true;
+}
+
+bool StreamIngest::nextLine(const char*& begin, const char*& end, bool wait) {
+    for (;;) {
+        const char* data = buffer_.data();
+        const char* nl = static_cast<const char*>(
+            std::memchr(data + begin_ + scanned_, '\n', end_ - begin_ - scanned_));
+        if (nl) {
+            begin = data + begin_;
+            end = nl;
+            begin_ = static_cast<size_t>(nl - data) + 1;
+            scanned_ = 0;
+            return true;
+        }
+        scanned_ = end_ - begin_;
+        if (eof_) {
+            if (begin_ == end_) return false;
+            // Last line without a terminator
+            begin = data + begin_;
+            end = data + end_;
+            begin_ = end_;
+            scanned_ = 0;
+            return true;
+        }
+        if (!wait) return false;
+        if (!fill()) eof_ = true;
+    }
+}
+
+bool StreamIngest::readNext(TimestampedSample& out) {
+    if (fd_ < 0) return false;
+    const char* begin;
+    const char* end;
+    while (nextLine(begin, end, true)) {
+        if (schema_.parseRow(begin, end, out)) return true;
+        ++skipped_;
+    }
+    return false;
+}
+
+size_t StreamIngest::readBatch(SampleBlock& out) {
+    out.clear();
+    if (fd_ < 0) return 0;
+    const char* begin;
+    const char* end;
+    // Wait for data only while the batch is empty, so a skipped line never
+    // reads as the end of the stream
+    while (!out.full() && nextLine(begin, end, out.size == 0)) {
+        if (schema_.parseRow(begin, end, batch_row_)) {
+            out.set(out.size++, batch_row_);
+        } else {
+            ++skipped_;
+        }
+    }
+    return out.size;
+}
+
+void StreamIngest::close() {
+    if (fd_ >= 0 && owns_fd_) closeFd(fd_);
+    fd_ = -1;
+    owns_fd_ = false;
+    eof_ = false;
+    begin_ = end_ = scanned_ = 0;
+    batch_row_ = TimestampedSample{};
+}
+
+}  // namespace astvdp
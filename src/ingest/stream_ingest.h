@@ -0,0 +1,61 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include "csv_row_parser.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+// Incremental CSV reader for data that arrives over time. It reads stdin
+// ("-" or "stdin"), a FIFO or other readable path, or a UNIX domain socket
+// ("unix:<path>", connected as a client). Bytes are read as they arrive and
+// only complete lines are parsed; a partial line waits in the buffer for
+// the rest. readBatch() returns once it has parsed every line received so
+// far, and blocks only while it has no row at all. A slow live feed
+// therefore moves through the pipeline as it arrives instead of waiting
+// for a full block. Rows and the header are handled as in MmapCsvIngest,
+// so replaying a file gives the same session. A bad or blank line does not
+// end the input as it does in a file, since a live feed has no second
+// chance: it is skipped and counted, and only the end of the stream makes
+// readBatch() return 0.
+class StreamIngest : public DataIngest {
+public:
+    StreamIngest() = default;
+    ~StreamIngest() override;
+
+    StreamIngest(const StreamIngest&) = delete;
+    StreamIngest& operator=(const StreamIngest&) = delete;
+
+    // "-", "stdin", "unix:<path>", or a path that is a FIFO, socket or character device
+    static bool isStreamSource(const std::string& source);
+
+    bool open(const std::string& source) override;  // blocks until the header line arrives
+    bool readNext(TimestampedSample& out) override;
+    size_t readBatch(SampleBlock& out) override;
+    void close() override;
+
+    // Why the header was rejected; empty if open() failed for another reason
+    const std::string& headerError() const { return schema_.error(); }
+    // Lines skipped as unparseable since open(); kept after close()
+    size_t skippedLines() const { return skipped_; }
+
+private:
+    static constexpr size_t kReadSize = 64 * 1024;
+
+    bool fill();  // one blocking read; false at end of stream or on error
+    bool nextLine(const char*& begin, const char*& end, bool wait);
+
+    int fd_ = -1;
+    bool owns_fd_ = false;
+    bool eof_ = false;
+    std::vector<char> buffer_;
+    size_t begin_ = 0;    // first unparsed byte
+    size_t end_ = 0;      // end of received bytes
+    size_t scanned_ = 0;  // bytes from begin_ known to hold no '\n'
+    size_t skipped_ = 0;
+    CsvSchema schema_;
+    TimestampedSample batch_row_{};  // carries unset columns across rows
+};
+
+}  // namespace astvdp
@@ -0,0 +1,64 @@
+#include "time_range_ingest.h"
+
+namespace astvdp {
+
+TimeRangeIngest::TimeRangeIngest(DataIngest& source, double from, double to)
+    : source_(source), from_(from), to_(to) {}
+
+bool TimeRangeIngest::open(const std::string&) {
+    done_ = false;
+    skipping_ = from_ > kOpenStart && !source_.seek(from_);
+    return true;
+}
+
+bool TimeRangeIngest::seek(double timestamp) {
+    if (timestamp < from_) timestamp = from_;
+    done_ = timestamp > to_;
+    if (source_.seek(timestamp)) {
+        skipping_ = false;
+        return true;
+    }
+    return false;
+}
+
+bool TimeRangeIngest::readNext(TimestampedSample& out) {
+    while (!done_ && source_.readNext(out)) {
+        if (skipping_ && out.timestamp < from_) continue;
+        skipping_ = false;
+        if (out.timestamp > to_) break;
+        return true;
+    }
+    done_ = true;
+    return false;
+}
+
+size_t TimeRangeIngest::readBatch(SampleBlock& out) {
+    while (!done_ && source_.readBatch(out) > 0) {
+        size_t first = 0;
+        if (skipping_) {
+            while (first < out.size && out.timestamp[first] < from_) ++first;
+            if (first == out.size) continue;
+            skipping_ = false;
+            // Only the block that straddles `from` is compacted
+            for (size_t i = first; i < out.size; ++i) out.set(i - first, out.get(i));
+            out.size -= first;
+        }
+        size_t end = 0;
+        while (end < out.size && out.timestamp[end] <= to_) ++end;
+        if (end < out.size) {
+            out.size = end;
+            done_ = true;
+        }
+        if (out.size > 0) return out.size;
+    }
+    done_ = true;
+    out.clear();
+    return 0;
+}
+
+void TimeRangeIngest::close() {
+    source_.close();
+    done_ = true;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,34 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include <cstddef>
+#include <limits>
+#include <string>
+
+namespace astvdp {
+
+// Reads the rows of an already opened source whose timestamps lie in
+// [from, to]. open() seeks the source to `from`; sources that cannot seek
+// are scanned and the earlier rows dropped. Reading stops at the first row
+// after `to`, since timestamps are assumed not to decrease.
+class TimeRangeIngest : public DataIngest {
+public:
+    static constexpr double kOpenStart = -std::numeric_limits<double>::infinity();
+    static constexpr double kOpenEnd = std::numeric_limits<double>::infinity();
+
+    TimeRangeIngest(DataIngest& source, double from, double to);
+
+    bool open(const std::string& source) override;  // argument ignored
+    bool readNext(TimestampedSample& out) override;
+    size_t readBatch(SampleBlock& out) override;
+    void close() override;  // closes the source
+    bool seek(double timestamp) override;
+
+private:
+    DataIngest& source_;
+    double from_;
+    double to_;
+    bool skipping_ = false;  // source could not seek: drop rows before from_
+    bool done_ = false;
+};
+
+}  // namespace astvdp
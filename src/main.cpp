@@ -1,24 +1,82 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <memory>
 #include <filesystem>
 #include <system_error>
+#include <thread>
 #include "argh/argh.h"
 
 #include "astvdp/interfaces.h"
-#include "ingest/csv_ingest.h"
-#include "fusion/complementary_fusion.h"
+#include "archive/archive_writer.h"
+#include "ingest/ingest_factory.h"
+#include "ingest/stream_ingest.h"
+#include "ingest/scenario_ingest.h"
+#include "ingest/simulator_ingest.h"
+#include "ingest/time_range_ingest.h"
+#include "fusion/fusion_factory.h"
 #include "verification/safety_verifier.h"
 #include "diagnostics/diagnostic_engine.h"
 #include "core/database.h"
-#include "analysis/metrics_engine.h"
+#include "core/profiler.h"
+#include "core/tracer.h"
 #include "reporting/report_generator.h"
 #include "simulation/flight_simulator.h"
+#include "simulation/scenario.h"
+#include "pipeline/archive_sink.h"
+#include "pipeline/live_anomaly_sink.h"
+#include "pipeline/database_sink.h"
+#include "pipeline/session_runner.h"
+#include "batch/batch_manifest.h"
+#include "batch/batch_runner.h"
+
+namespace {
+
+// Reads an optional --from/--to value in the input's timestamp units
+bool parseTimeArg(const argh::parser& cmdl, const char* name, double& out) {
+    std::string text;
+    cmdl({name}, "") >> text;
+    if (text.empty()) return true;
+    try {
+        size_t used = 0;
+        out = std::stod(text, &used);
+        return used == text.size();
+    } catch (...) {
+        return false;
+    }
+}
+
+// Records a Chrome trace while in scope and writes it on every exit path
+class TraceSession {
+public:
+    explicit TraceSession(const std::string& path) : path_(path) {
+        if (path_.empty()) return;
+        astvdp::Tracer::start(path_);
+        astvdp::Tracer::setThreadName("main");
+    }
+    ~TraceSession() {
+        if (path_.empty()) return;
+        if (astvdp::Tracer::stop()) {
+            std::cout << "Trace: " << path_ << "\n";
+        } else {
+            std::cerr << "Failed to write trace: " << path_ << "\n";
+        }
+    }
+
+private:
+    std::string path_;
+};
+
+}  // namespace
 
 int main(int argc, char* argv[]) {
     argh::parser cmdl;
-    cmdl.add_params({"--input", "--mission", "--aircraft", "--output-dir", "--db-path"});
+    cmdl.add_params({"--input", "--mission", "--aircraft", "--output-dir", "--db-path", "--threads", "--batch", "--diag-window",
+                     "--fusion", "--trace", "--archive", "--from", "--to", "--parse-threads",
+                     "--sim-duration", "--sim-rate", "--scenario", "--sim-threads"});
     cmdl.parse(argc, argv);
     std::string input_path;
     std::string mission_id = "TEST-001";
@@ -27,32 +85,113 @@ int main(int argc, char* argv[]) {
     std::string db_path;
     bool simulate = false;
     bool generate_pdf = false;
+    size_t threads = std::min(4u, std::max(1u, std::thread::hardware_concurrency()));
+    size_t diag_window = astvdp::DiagnosticEngine::kDefaultWindowSize;
 
     if (cmdl["--help"]) {
-        std::cout << "Usage: astvdp [--input <file.csv>] [--simulate] "
+        std::cout << "Usage: astvdp [--input <file.csv|file.astvdp|-|fifo|unix:socket>] "
+                  << "[--simulate [--sim-duration <s>] [--sim-rate <hz>] [--save-sim]] "
+                  << "[--scenario <file.json> [--sim-threads <n>] [--save-sim]] "
+                  << "[--batch <manifest.json>] "
                   << "[--mission <id>] [--aircraft <type>] "
-                  << "[--output-dir <dir>] [--db-path <file.db>] [--pdf]\n";
+                  << "[--output-dir <dir>] [--db-path <file.db>] [--wal] [--pdf] "
+                  << "[--threads <n>] [--serial] [--raw-anomalies] [--diag-window <samples>] "
+                  << "[--spectral] [--axis-drift] "
+                  << "[--fusion complementary|ekf] [--profile] [--trace <trace.json>] "
+                  << "[--archive <file.astvdp>] [--from <seconds>] [--to <seconds>] "
+                  << "[--parse-threads <n>] [--live]\n";
         return 0;
     }
 
+    const bool profile = cmdl["--profile"];
+    const auto wall_start = std::chrono::steady_clock::now();
+    astvdp::Profiler::enable(profile);
+    std::string trace_path;
+    cmdl({"--trace"}, "") >> trace_path;
+    TraceSession trace(trace_path);
+
     if (cmdl["--simulate"]) simulate = true;
+    std::string scenario_path;
+    cmdl({"--scenario"}, "") >> scenario_path;
+    if (!scenario_path.empty()) simulate = true;
     cmdl({"--input"}, "") >> input_path;
+    if (input_path.empty() && cmdl["--input"] && cmdl["-"]) input_path = "-";  // argh takes a lone "-" as a flag
+
+    std::string fusion_name = "complementary";
+    cmdl({"--fusion"}, fusion_name) >> fusion_name;
+    if (!astvdp::createFusion(fusion_name)) {
+        std::cerr << "Error: unknown --fusion '" << fusion_name << "' (use complementary or ekf)\n";
+        return 1;
+    }
+
+    std::string batch_path;
+    cmdl({"--batch"}, "") >> batch_path;
+    if (!batch_path.empty()) {
+        if (simulate || !input_path.empty() || cmdl({"--from"}) || cmdl({"--to"})) {
+            std::cerr << "Error: --batch cannot be combined with --simulate, --scenario, --input, --from or --to\n";
+            return 1;
+        }
+        astvdp::BatchManifest manifest;
+        std::string manifest_error;
+        if (!astvdp::loadBatchManifest(batch_path, manifest, manifest_error)) {
+            std::cerr << "Invalid batch manifest: " << manifest_error << "\n";
+            return 1;
+        }
+        astvdp::BatchOptions batch_opts;
+        cmdl({"--output-dir"}, batch_opts.output_dir) >> batch_opts.output_dir;
+        cmdl({"--db-path"}, "") >> batch_opts.db_path;
+        cmdl({"--threads"}, 0) >> batch_opts.threads;
+        cmdl({"--diag-window"}, batch_opts.diag_window) >> batch_opts.diag_window;
+        batch_opts.spectral = cmdl["--spectral"];
+        batch_opts.axis_drift = cmdl["--axis-drift"];
+        batch_opts.fusion = fusion_name;
+        batch_opts.profile = profile;
+        batch_opts.wal = cmdl["--wal"];
+        return astvdp::runBatch(manifest, batch_opts);
+    }
 
     if (simulate && !input_path.empty()) {
-        std::cerr << "Error: Use either --simulate or --input, not both\n";
+        std::cerr << "Error: Use either --simulate/--scenario or --input, not both\n";
         return 1;
     }
 
     if (!simulate && input_path.empty()) {
-        std::cerr << "Error: Specify --input or --simulate\n";
+        std::cerr << "Error: Specify --input, --simulate or --scenario\n";
         return 1;
     }
 
+    astvdp::Scenario scenario;
+    if (!scenario_path.empty()) {
+        if (cmdl({"--sim-duration"}) || cmdl({"--sim-rate"})) {
+            std::cerr << "Error: --sim-duration and --sim-rate do not apply to --scenario (set them in the file)\n";
+            return 1;
+        }
+        std::string scenario_error;
+        if (!astvdp::loadScenario(scenario_path, scenario, scenario_error)) {
+            std::cerr << "Invalid scenario: " << scenario_error << "\n";
+            return 1;
+        }
+    }
+
     cmdl({"--mission"}, mission_id) >> mission_id;
     cmdl({"--aircraft"}, aircraft) >> aircraft;
     cmdl({"--output-dir"}, output_dir) >> output_dir;
     cmdl({"--db-path"}, "") >> db_path;
     if (cmdl["--pdf"]) generate_pdf = true;
+    const bool raw_anomalies = cmdl["--raw-anomalies"];
+    cmdl({"--threads"}, threads) >> threads;
+    if (cmdl["--serial"] || threads == 0) threads = 1;
+    cmdl({"--diag-window"}, diag_window) >> diag_window;
+
+    double range_from = astvdp::TimeRangeIngest::kOpenStart;
+    double range_to = astvdp::TimeRangeIngest::kOpenEnd;
+    if (!parseTimeArg(cmdl, "--from", range_from) || !parseTimeArg(cmdl, "--to", range_to) ||
+        !(range_from <= range_to)) {
+        std::cerr << "Error: --from/--to must be numbers with --from <= --to\n";
+        return 1;
+    }
+    const bool ranged = range_from > astvdp::TimeRangeIngest::kOpenStart ||
+                        range_to < astvdp::TimeRangeIngest::kOpenEnd;
 
     if (db_path.empty()) {
         db_path = (std::filesystem::path(output_dir) / "test.db").string();
@@ -67,99 +206,134 @@ int main(int argc, char* argv[]) {
 
     // Initialize DB
     astvdp::Database db(db_path);
+    astvdp::Database::WriteOptions write_opts;
+    write_opts.wal = cmdl["--wal"];
+    db.setWriteOptions(write_opts);
     if (!db.open()) {
         std::cerr << "Failed to open database: " << db_path << "\n";
         return 1;
     }
 
-    // Generate simulated data if needed
-    if (simulate) {
+    // Ingest, by source:
+    // - scenario: generated block by block on --sim-threads
+    // - --simulate: generated block by block
+    // - stdin, FIFO or socket: read incrementally as lines arrive
+    // - .astvdp: columnar archive
+    // - CSV: memory-mapped, parsed on every core when large or per --parse-threads
+    // Simulated flights are copied to CSV only with --save-sim.
+    std::unique_ptr<astvdp::DataIngest> ingest;
+    if (!scenario_path.empty()) {
+        // Same budget as the pipeline unless asked otherwise
+        size_t sim_threads = threads;
+        cmdl({"--sim-threads"}, sim_threads) >> sim_threads;
+        std::string sim_path;
+        if (cmdl["--save-sim"]) sim_path = (std::filesystem::path(output_dir) / "sim_flight.csv").string();
+        ingest = std::make_unique<astvdp::ScenarioIngest>(scenario, sim_threads, sim_path);
+        if (!ingest->open(sim_path)) {
+            std::cerr << "Failed to write simulated CSV: " << sim_path << "\n";
+            return 1;
+        }
+    } else if (simulate) {
         astvdp::FlightSimulator::Profile prof;
         prof.duration_sec = 120.0;
         prof.inject_vibration_fault = true;
         prof.inject_gnss_dropout = true;
-        auto sim_data = astvdp::FlightSimulator::generate(prof);
-        const std::string sim_path = (std::filesystem::path(output_dir) / "sim_flight.csv").string();
-        if (!astvdp::FlightSimulator::saveToCsv(sim_data, sim_path)) {
+        cmdl({"--sim-duration"}, prof.duration_sec) >> prof.duration_sec;
+        cmdl({"--sim-rate"}, prof.sample_rate_hz) >> prof.sample_rate_hz;
+        if (!(prof.duration_sec > 0.0) || !(prof.sample_rate_hz > 0.0)) {
+            std::cerr << "Error: --sim-duration and --sim-rate must be positive\n";
+            return 1;
+        }
+        std::string sim_path;
+        if (cmdl["--save-sim"]) sim_path = (std::filesystem::path(output_dir) / "sim_flight.csv").string();
+        ingest = std::make_unique<astvdp::SimulatorIngest>(prof, sim_path);
+        if (!ingest->open(sim_path)) {
             std::cerr << "Failed to write simulated CSV: " << sim_path << "\n";
             return 1;
         }
-        input_path = sim_path;
-    }
-
-    // Ingest
-    astvdp::CsvIngest ingest;
-    if (!ingest.open(input_path)) {
-        std::cerr << "Failed to open input: " << input_path << "\n";
-        return 1;
+    } else {
+        size_t parse_threads = 0;
+        cmdl({"--parse-threads"}, parse_threads) >> parse_threads;
+        std::string open_error;
+        ingest = astvdp::openIngest(input_path, parse_threads, &open_error);
+        if (!ingest) {
+            std::cerr << "Failed to open input: " << input_path << " (" << open_error << ")\n";
+            return 1;
+        }
     }
 
-    // Modules
-    astvdp::ComplementaryFusion fusion;
-    astvdp::SafetyVerifierImpl verifier;
-    verifier.loadLimitsFromDb(db_path);  // falls back to defaults if table is empty/missing
-    astvdp::DiagnosticEngine diagnostics;
-    std::vector<astvdp::Anomaly> all_anomalies;
-    size_t sample_count = 0;
-    double first_time = -1, last_time = -1;
+    // Optional time slice: sources seek to --from through their time index
+    // and reading stops after --to
+    astvdp::TimeRangeIngest range(*ingest, range_from, range_to);
+    astvdp::DataIngest& source = ranged ? static_cast<astvdp::DataIngest&>(range) : *ingest;
+    if (ranged) range.open(input_path);
 
-    // Start session
-    int64_t session_id = db.startSession(mission_id, aircraft);
-    if (session_id < 0) {
-        std::cerr << "DB session failed\n";
+    // Optional columnar copy of the raw samples for fast re-analysis
+    std::string archive_path;
+    cmdl({"--archive"}, "") >> archive_path;
+    astvdp::ArchiveWriter archive;
+    if (!archive_path.empty() && !archive.open(archive_path)) {
+        std::cerr << "Failed to create archive: " << archive_path << "\n";
         return 1;
     }
 
-    // Process loop
-    astvdp::TimestampedSample raw;
-    while (ingest.readNext(raw)) {
-        if (first_time < 0) first_time = raw.timestamp;
-        last_time = raw.timestamp;
-
-        // Store raw data
-        db.insertFlightData(session_id, raw);
+    astvdp::SafetyVerifierImpl limits;
+    limits.loadLimitsFromDb(db_path);  // falls back to defaults if table is empty/missing
 
-        // Fuse
-        astvdp::FusedState fused;
-        fusion.process(raw, fused);
+    astvdp::SessionConfig session_config;
+    session_config.mission_id = mission_id;
+    session_config.aircraft = aircraft;
+    session_config.fusion = fusion_name;
+    session_config.diag_window = diag_window;
+    session_config.spectral = cmdl["--spectral"];
+    session_config.axis_drift = cmdl["--axis-drift"];
+    session_config.raw_anomalies = raw_anomalies;
+    session_config.threads = threads;
+    session_config.limits = &limits;
 
-        // Verify
-        auto verif_anomalies = verifier.check(fused, raw);
-        for (const auto& a : verif_anomalies) {
-            db.insertAnomaly(session_id, a);
-            all_anomalies.push_back(a);
+    // Process loop: ingest -> fusion -> verify/diagnose -> persist, one SoA
+    // block at a time; persistence runs on its own writer thread unless --serial
+    astvdp::DatabaseSink db_sink(db);
+    astvdp::ArchiveSink archive_sink(archive, &db_sink);
+    astvdp::SessionSink* sink = archive.isOpen() ? static_cast<astvdp::SessionSink*>(&archive_sink) : &db_sink;
+    // Alerts as anomalies start, on by default for streamed input
+    const bool live = cmdl["--live"] || astvdp::StreamIngest::isStreamSource(input_path);
+    astvdp::LiveAnomalySink live_sink(std::cout, sink);
+    if (live) sink = &live_sink;
+    const astvdp::SessionResult session = astvdp::SessionRunner(session_config).run(source, sink);
+    if (const auto* stream = dynamic_cast<const astvdp::StreamIngest*>(ingest.get())) {
+        if (stream->skippedLines() > 0) {
+            std::cerr << "Skipped " << stream->skippedLines() << " unparseable lines from: " << input_path << "\n";
         }
-
-        // Diagnose
-        diagnostics.process(raw);
-        auto diag_anomalies = diagnostics.getNewAnomalies();
-        for (const auto& a : diag_anomalies) {
-            db.insertAnomaly(session_id, a);
-            all_anomalies.push_back(a);
+    }
+    ingest->close();
+    if (archive.isOpen()) {
+        if (archive.close()) {
+            std::cout << "Archive: " << archive_path << "\n";
+        } else {
+            std::cerr << "Failed to write archive: " << archive_path << "\n";
         }
-
-        sample_count++;
     }
-    ingest.close();
 
-    if (sample_count == 0) {
-        std::cerr << "No valid samples were processed from: " << input_path << "\n";
-        db.endSession(session_id, 0.0);
+    if (session.status == astvdp::SessionResult::kSessionFailed) {
+        std::cerr << "DB session failed\n";
         return 1;
     }
-
-    db.endSession(session_id, last_time);
-
-    // Compute metrics
-    auto metrics = astvdp::computeMetrics(all_anomalies, sample_count);
-    db.saveSessionMetrics(session_id, metrics.stability_index, metrics.sensor_reliability,
-                          metrics.mission_compliance, metrics.risk_classification);
+    if (session.status == astvdp::SessionResult::kNoSamples) {
+        std::cerr << "No valid samples were processed from: " << (simulate ? "simulation" : input_path) << "\n";
+        return 1;
+    }
+    const int64_t session_id = session.session_id;
 
     // Generate report
     std::cout << "Generating report...\n";
-    bool html_ok = astvdp::ReportGenerator::generateHtmlReport(
-        output_dir, mission_id, aircraft, last_time - first_time, metrics, all_anomalies
-    );
+    bool html_ok;
+    {
+        astvdp::ScopedStageTimer timer(astvdp::Profiler::kReport);
+        html_ok = astvdp::ReportGenerator::generateHtmlReport(
+            output_dir, mission_id, aircraft, session.duration(), session.metrics, session.anomalies
+        );
+    }
 
     if (html_ok) {
         const std::string html_path = (std::filesystem::path(output_dir) / "report.html").string();
@@ -167,7 +341,12 @@ int main(int argc, char* argv[]) {
 
         if (generate_pdf) {
             const std::string pdf_path = (std::filesystem::path(output_dir) / "report.pdf").string();
-            if (astvdp::ReportGenerator::convertHtmlToPdf(html_path, pdf_path)) {
+            bool pdf_ok;
+            {
+                astvdp::ScopedStageTimer timer(astvdp::Profiler::kPdf);
+                pdf_ok = astvdp::ReportGenerator::convertHtmlToPdf(html_path, pdf_path);
+            }
+            if (pdf_ok) {
                 std::cout << "PDF: " << pdf_path << "\n";
             } else {
                 std::cerr << "PDF generation failed. Ensure wkhtmltopdf is installed and in PATH.\n";
@@ -178,6 +357,18 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    if (profile) {
+        const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wall_start;
+        const auto report = astvdp::Profiler::collect(wall.count());
+        astvdp::Profiler::print(report, std::cout);
+        const std::string profile_path = (std::filesystem::path(output_dir) / "profile.json").string();
+        if (astvdp::Profiler::writeJson(report, profile_path)) {
+            std::cout << "Profile: " << profile_path << "\n";
+        } else {
+            std::cerr << "Failed to write profile: " << profile_path << "\n";
+        }
+    }
+
     std::cout << "Done. Session ID: " << session_id << "\n";
     return 0;
 }
@@ -0,0 +1,34 @@
+#include "archive_sink.h"
+
+namespace astvdp {
+
+int64_t ArchiveSink::beginSession(const std::string& mission_id, const std::string& aircraft) {
+    return next_ ? next_->beginSession(mission_id, aircraft) : 0;
+}
+
+void ArchiveSink::writeSamples(const SampleBlock& samples) {
+    writer_.append(samples);
+    if (next_) next_->writeSamples(samples);
+}
+
+void ArchiveSink::writeAnomaly(const Anomaly& anomaly) {
+    if (next_) next_->writeAnomaly(anomaly);
+}
+
+void ArchiveSink::writeEpisode(const AnomalyEpisode& episode) {
+    if (next_) next_->writeEpisode(episode);
+}
+
+void ArchiveSink::anomalyDetected(uint64_t sample_index, const Anomaly& anomaly) {
+    if (next_) next_->anomalyDetected(sample_index, anomaly);
+}
+
+bool ArchiveSink::finishWrites() {
+    return next_ ? next_->finishWrites() : true;
+}
+
+void ArchiveSink::endSession(const SessionResult& result) {
+    if (next_) next_->endSession(result);
+}
+
+}  // namespace astvdp
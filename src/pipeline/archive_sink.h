@@ -0,0 +1,26 @@
+#pragma once
+#include "archive/archive_writer.h"
+#include "pipeline/session_runner.h"
+
+namespace astvdp {
+
+// Copies every sample block of a session into an archive and forwards all
+// calls to `next` (may be null), e.g. a DatabaseSink.
+class ArchiveSink : public SessionSink {
+public:
+    ArchiveSink(ArchiveWriter& writer, SessionSink* next) : writer_(writer), next_(next) {}
+
+    int64_t beginSession(const std::string& mission_id, const std::string& aircraft) override;
+    void writeSamples(const SampleBlock& samples) override;
+    void writeAnomaly(const Anomaly& anomaly) override;
+    void writeEpisode(const AnomalyEpisode& episode) override;
+    void anomalyDetected(uint64_t sample_index, const Anomaly& anomaly) override;
+    bool finishWrites() override;
+    void endSession(const SessionResult& result) override;
+
+private:
+    ArchiveWriter& writer_;
+    SessionSink* next_;
+};
+
+}  // namespace astvdp
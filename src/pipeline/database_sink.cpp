@@ -0,0 +1,34 @@
+#include "database_sink.h"
+
+namespace astvdp {
+
+int64_t DatabaseSink::beginSession(const std::string& mission_id, const std::string& aircraft) {
+    session_id_ = db_.startSession(mission_id, aircraft);
+    write_failed_ = false;
+    return session_id_;
+}
+
+void DatabaseSink::writeSamples(const SampleBlock& samples) {
+    write_failed_ = write_failed_ || !db_.appendFlightData(session_id_, samples);
+}
+
+void DatabaseSink::writeAnomaly(const Anomaly& anomaly) {
+    write_failed_ = write_failed_ || !db_.insertAnomaly(session_id_, anomaly);
+}
+
+void DatabaseSink::writeEpisode(const AnomalyEpisode& episode) {
+    write_failed_ = write_failed_ || !db_.insertEpisode(session_id_, episode);
+}
+
+void DatabaseSink::endSession(const SessionResult& result) {
+    if (!result.ok()) {
+        db_.endSession(session_id_, 0.0);
+        return;
+    }
+    db_.endSession(session_id_, result.last_time);
+    const SessionMetrics& m = result.metrics;
+    db_.saveSessionMetrics(session_id_, m.stability_index, m.sensor_reliability,
+                           m.mission_compliance, m.risk_classification);
+}
+
+}  // namespace astvdp
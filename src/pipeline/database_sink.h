@@ -0,0 +1,27 @@
+#pragma once
+#include "core/database.h"
+#include "pipeline/session_runner.h"
+
+namespace astvdp {
+
+// Writes a session straight into a Database: batched flight_data rows,
+// anomalies or episodes, and the session's end time and metrics. After the
+// first failed write the rest of the session is not written.
+class DatabaseSink : public SessionSink {
+public:
+    explicit DatabaseSink(Database& db) : db_(db) {}
+
+    int64_t beginSession(const std::string& mission_id, const std::string& aircraft) override;
+    void writeSamples(const SampleBlock& samples) override;
+    void writeAnomaly(const Anomaly& anomaly) override;
+    void writeEpisode(const AnomalyEpisode& episode) override;
+    bool finishWrites() override { return !write_failed_; }
+    void endSession(const SessionResult& result) override;
+
+private:
+    Database& db_;
+    int64_t session_id_ = -1;
+    bool write_failed_ = false;  // later writes are dropped
+};
+
+}  // namespace astvdp
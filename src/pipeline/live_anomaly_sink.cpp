@@ -0,0 +1,61 @@
+#include "live_anomaly_sink.h"
+#include <cstdio>
+
+namespace astvdp {
+
+namespace {
+
+const char* severityName(Severity s) {
+    switch (s) {
+        case Severity::Critical: return "Critical";
+        case Severity::Major: return "Major";
+        case Severity::Minor: return "Minor";
+        default: return "Observation";
+    }
+}
+
+}  // namespace
+
+int64_t LiveAnomalySink::beginSession(const std::string& mission_id, const std::string& aircraft) {
+    last_seen_.clear();
+    alerts_ = 0;
+    return next_ ? next_->beginSession(mission_id, aircraft) : 0;
+}
+
+void LiveAnomalySink::writeSamples(const SampleBlock& samples) {
+    if (next_) next_->writeSamples(samples);
+}
+
+void LiveAnomalySink::writeAnomaly(const Anomaly& anomaly) {
+    if (next_) next_->writeAnomaly(anomaly);
+}
+
+void LiveAnomalySink::writeEpisode(const AnomalyEpisode& episode) {
+    if (next_) next_->writeEpisode(episode);
+}
+
+void LiveAnomalySink::anomalyDetected(uint64_t sample_index, const Anomaly& anomaly) {
+    const uint32_t key = (uint32_t{anomaly.id} << 8) | static_cast<uint32_t>(anomaly.severity);
+    const auto [it, inserted] = last_seen_.try_emplace(key, sample_index);
+    const bool continues = !inserted && it->second + 1 == sample_index;
+    it->second = sample_index;
+    if (!continues) {
+        const AnomalyDescriptor& d = anomaly.describe();
+        char time[32];
+        std::snprintf(time, sizeof time, "%.2f", anomaly.timestamp);
+        out_ << "LIVE t=" << time << ' ' << severityName(anomaly.severity) << ' ' << d.type << ' ' << d.param
+             << ": " << d.details << std::endl;
+        ++alerts_;
+    }
+    if (next_) next_->anomalyDetected(sample_index, anomaly);
+}
+
+bool LiveAnomalySink::finishWrites() {
+    return next_ ? next_->finishWrites() : true;
+}
+
+void LiveAnomalySink::endSession(const SessionResult& result) {
+    if (next_) next_->endSession(result);
+}
+
+}  // namespace astvdp
@@ -0,0 +1,37 @@
+#pragma once
+#include "pipeline/session_runner.h"
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+
+namespace astvdp {
+
+// Prints an alert line the moment an anomaly starts, then forwards all calls
+// to `next` (may be null), e.g. a DatabaseSink. Only the first sample of a
+// run of the same anomaly (same id and severity on consecutive samples) is
+// printed, so a sustained breach gives one line instead of one per sample.
+// Each line is flushed, so a monitor reading the output sees it right away:
+//
+//   LIVE t=123.45 Major limit_breach roll_rate: Rate out of bounds
+class LiveAnomalySink : public SessionSink {
+public:
+    LiveAnomalySink(std::ostream& out, SessionSink* next) : out_(out), next_(next) {}
+
+    int64_t beginSession(const std::string& mission_id, const std::string& aircraft) override;
+    void writeSamples(const SampleBlock& samples) override;
+    void writeAnomaly(const Anomaly& anomaly) override;
+    void writeEpisode(const AnomalyEpisode& episode) override;
+    void anomalyDetected(uint64_t sample_index, const Anomaly& anomaly) override;
+    bool finishWrites() override;
+    void endSession(const SessionResult& result) override;
+
+    uint64_t alerts() const { return alerts_; }
+
+private:
+    std::ostream& out_;
+    SessionSink* next_;
+    std::unordered_map<uint32_t, uint64_t> last_seen_;  // id and severity -> last sample index
+    uint64_t alerts_ = 0;
+};
+
+}  // namespace astvdp
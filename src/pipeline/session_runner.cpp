@@ -0,0 +1,91 @@
+#include "session_runner.h"
+#include "analysis/episode_tracker.h"
+#include "fusion/fusion_factory.h"
+#include "pipeline/staged_pipeline.h"
+#include "verification/safety_verifier.h"
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace astvdp {
+
+SessionRunner::SessionRunner(SessionConfig config) : config_(std::move(config)) {}
+
+SessionResult SessionRunner::run(DataIngest& ingest, SessionSink* sink) const {
+    SessionResult result;
+    std::unique_ptr<SensorFusion> fusion = createFusion(config_.fusion);
+    if (!fusion) {
+        result.status = SessionResult::kUnknownFusion;
+        return result;
+    }
+    SafetyVerifierImpl verifier = config_.limits ? *config_.limits : SafetyVerifierImpl{};
+    DiagnosticEngine diagnostics(config_.diag_window);
+    if (config_.axis_drift) diagnostics.enableAxisDrift();
+    if (config_.spectral) diagnostics.enableSpectral();
+    EpisodeTracker episode_tracker;
+
+    if (sink) {
+        result.session_id = sink->beginSession(config_.mission_id, config_.aircraft);
+        if (result.session_id < 0) {
+            result.status = SessionResult::kSessionFailed;
+            return result;
+        }
+    }
+
+    const bool raw = config_.raw_anomalies;
+    std::vector<AnomalyEpisode>& anomalies = result.anomalies;
+    StagedPipeline::Stages stages;
+    stages.ingest = &ingest;
+    stages.fusion = fusion.get();
+    stages.verifier = &verifier;
+    stages.diagnostics = &diagnostics;
+    if (!raw) stages.episodes = &episode_tracker;
+    stages.persist = [&](PipelineBatch& batch) {
+        if (sink) {
+            sink->writeSamples(batch.samples);
+            for (const auto& a : batch.anomalies) sink->anomalyDetected(batch.first_index + a.row, a.anomaly);
+        }
+        if (raw) {
+            for (const auto& a : batch.anomalies) {
+                if (sink) sink->writeAnomaly(a.anomaly);
+                anomalies.push_back(AnomalyEpisode::single(a.anomaly));
+            }
+        } else {
+            for (const auto& e : batch.episodes) {
+                if (sink) sink->writeEpisode(e);
+                anomalies.push_back(e);
+            }
+        }
+    };
+    StagedPipeline::Options pipeline_opts;
+    pipeline_opts.threads = std::max<size_t>(config_.threads, 1);
+    const auto run = StagedPipeline::run(stages, pipeline_opts);
+    result.sample_count = run.sample_count;
+    result.first_time = run.first_time;
+    result.last_time = run.last_time;
+
+    if (!raw) {
+        // Episodes still open at end of input, then timeline order
+        const size_t closed_count = anomalies.size();
+        episode_tracker.finish(anomalies);
+        if (sink) {
+            for (size_t i = closed_count; i < anomalies.size(); ++i) sink->writeEpisode(anomalies[i]);
+        }
+        std::stable_sort(anomalies.begin(), anomalies.end(),
+                         [](const AnomalyEpisode& a, const AnomalyEpisode& b) {
+                             return a.start_time < b.start_time;
+                         });
+    }
+
+    if (sink && !sink->finishWrites()) {
+        result.status = SessionResult::kSessionFailed;
+    } else if (result.sample_count == 0) {
+        result.status = SessionResult::kNoSamples;
+    } else {
+        result.metrics = computeMetrics(anomalies, result.sample_count);
+    }
+    if (sink) sink->endSession(result);
+    return result;
+}
+
+}  // namespace astvdp
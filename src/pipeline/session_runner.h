@@ -0,0 +1,84 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include "analysis/metrics_engine.h"
+#include "diagnostics/diagnostic_engine.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+class SafetyVerifierImpl;
+
+struct SessionConfig {
+    std::string mission_id = "TEST-001";
+    std::string aircraft = "UNKNOWN";
+    std::string fusion = "complementary";  // see createFusion()
+    size_t diag_window = DiagnosticEngine::kDefaultWindowSize;
+    bool spectral = false;       // Welch PSD band-energy diagnostics
+    bool axis_drift = false;     // bias drift on imu_ax/ay and the gyro axes
+    bool raw_anomalies = false;  // report every anomaly instead of coalesced episodes
+    size_t threads = 4;          // StagedPipeline threads; 1 = serial
+    // Verifier whose limits are copied into the session; defaults when null
+    const SafetyVerifierImpl* limits = nullptr;
+};
+
+struct SessionResult {
+    enum Status { kOk, kUnknownFusion, kSessionFailed, kNoSamples };
+
+    Status status = kOk;
+    int64_t session_id = -1;  // from SessionSink::beginSession
+    size_t sample_count = 0;
+    double first_time = -1.0;
+    double last_time = -1.0;
+    // Episodes in start-time order; with raw_anomalies one single-sample
+    // episode per anomaly, in detection order
+    std::vector<AnomalyEpisode> anomalies;
+    SessionMetrics metrics;
+
+    bool ok() const { return status == kOk; }
+    double duration() const { return last_time - first_time; }
+};
+
+// Persistence for a session. beginSession and endSession run on the caller's
+// thread; the write calls run on the pipeline's writer thread, one at a time,
+// in input order.
+class SessionSink {
+public:
+    virtual ~SessionSink() = default;
+
+    // Returns the session id, or a negative value to abort the session
+    virtual int64_t beginSession(const std::string& mission_id, const std::string& aircraft) = 0;
+    virtual void writeSamples(const SampleBlock& samples) = 0;
+    virtual void writeAnomaly(const Anomaly& anomaly) = 0;      // raw_anomalies only
+    virtual void writeEpisode(const AnomalyEpisode& episode) = 0;
+    // Every anomaly as soon as its batch is persisted, in both modes and
+    // before episode coalescing; `sample_index` counts from 0 at the start
+    // of input. For live monitoring, where episodes close too late.
+    virtual void anomalyDetected(uint64_t /*sample_index*/, const Anomaly& /*anomaly*/) {}
+    // Called on the caller's thread after the last write call, once every
+    // write has been applied; false if any failed, which ends the session
+    // as kSessionFailed
+    virtual bool finishWrites() { return true; }
+    // Called for every session that began, also when no samples were read
+    virtual void endSession(const SessionResult& result) = 0;
+};
+
+// Runs one flight session through the staged pipeline: ingest -> fusion ->
+// verify/diagnose -> episodes, with output handed to an optional sink and
+// returned together with the session metrics.
+class SessionRunner {
+public:
+    explicit SessionRunner(SessionConfig config = {});
+
+    const SessionConfig& config() const { return config_; }
+
+    // Reads `ingest` to the end; the caller opens and closes it
+    SessionResult run(DataIngest& ingest, SessionSink* sink = nullptr) const;
+
+private:
+    SessionConfig config_;
+};
+
+}  // namespace astvdp
@@ -0,0 +1,123 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace astvdp {
+
+// Bounded lock-free single-producer/single-consumer ring. Capacity is rounded
+// up to a power of two; one producer thread pushes, one consumer thread pops.
+// The blocking push() and pop() spin for a while, then sleep on a condition
+// variable, so an idle stage does not hold a core. The mutex is only taken
+// when a side is actually asleep.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        slots_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    bool tryPush(const T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) return false;
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        wake(consumer_asleep_);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return false;
+        }
+        out = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        wake(producer_asleep_);
+        return true;
+    }
+
+    // Blocking variants: spin briefly, yield a few times, then sleep until
+    // the other side makes room or publishes a value
+    void push(const T& value) {
+        for (unsigned spins = 0; !tryPush(value); ++spins) {
+            if (spins < kSpins) {
+                backoff(spins);
+            } else {
+                sleep(producer_asleep_, [this] {
+                    return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) <= mask_;
+                });
+            }
+        }
+    }
+
+    T pop() {
+        T out;
+        for (unsigned spins = 0; !tryPop(out); ++spins) {
+            if (spins < kSpins) {
+                backoff(spins);
+            } else {
+                sleep(consumer_asleep_, [this] {
+                    return head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_acquire);
+                });
+            }
+        }
+        return out;
+    }
+
+private:
+    static constexpr unsigned kSpins = 128;  // 64 busy spins, then 64 yields
+
+    static void backoff(unsigned spins) {
+        if (spins >= 64) std::this_thread::yield();
+    }
+
+    // The sleeper raises its flag before re-checking the ring; the other side
+    // publishes its index before reading the flag. With a full fence on each
+    // side, either the sleeper sees the new index or the waker sees the flag
+    // and notifies under the mutex the sleeper holds until it waits.
+    template <typename Ready>
+    void sleep(std::atomic<bool>& asleep, Ready ready) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        asleep.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cv_.wait(lock, ready);
+        asleep.store(false, std::memory_order_relaxed);
+    }
+
+    void wake(std::atomic<bool>& asleep) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (asleep.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_all();
+        }
+    }
+
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;  // consumer-side copy of tail_
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;  // producer-side copy of head_
+
+    alignas(64) std::atomic<bool> producer_asleep_{false};
+    std::atomic<bool> consumer_asleep_{false};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+}  // namespace astvdp
@@ -0,0 +1,171 @@
+#include "staged_pipeline.h"
+#include "spsc_ring.h"
+#include "core/profiler.h"
+#include "core/tracer.h"
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace astvdp {
+
+void mergeByRow(std::vector<BlockAnomaly>& verif, std::vector<BlockAnomaly>& diag,
+                std::vector<BlockAnomaly>& out) {
+    size_t v = 0, d = 0;
+    while (v < verif.size() || d < diag.size()) {
+        if (d == diag.size() || (v < verif.size() && verif[v].row <= diag[d].row)) {
+            out.push_back(verif[v++]);
+        } else {
+            out.push_back(diag[d++]);
+        }
+    }
+    verif.clear();
+    diag.clear();
+}
+
+namespace {
+
+enum Stage { kIngest, kFusion, kAnalyze, kPersist, kStageCount };
+
+struct StageRunner {
+    const StagedPipeline::Stages& stages;
+    StagedPipeline::Result& result;
+    uint64_t next_index = 0;  // touched by the ingest stage only
+
+    void run(Stage stage, PipelineBatch& b) {
+        switch (stage) {
+            case kIngest: {
+                ScopedStageTimer timer(Profiler::kIngest);
+                b.end_of_stream = (stages.ingest->readBatch(b.samples) == 0);
+                b.first_index = next_index;
+                next_index += b.samples.size;
+                break;
+            }
+            case kFusion: {
+                ScopedStageTimer timer(Profiler::kFusion);
+                stages.fusion->processBlock(b.samples, b.fused);
+                break;
+            }
+            case kAnalyze: {
+                b.anomalies.clear();
+                {
+                    ScopedStageTimer timer(Profiler::kVerify);
+                    stages.verifier->checkBlock(b.fused, b.samples, b.verifier_anomalies);
+                }
+                {
+                    ScopedStageTimer timer(Profiler::kDiagnose);
+                    stages.diagnostics->processBlock(b.samples, b.diagnostic_anomalies);
+                }
+                ScopedStageTimer timer(Profiler::kEpisodes);
+                mergeByRow(b.verifier_anomalies, b.diagnostic_anomalies, b.anomalies);
+                Profiler::count(Profiler::kAnomalies, b.anomalies.size());
+                b.episodes.clear();
+                if (stages.episodes) {
+                    for (const auto& a : b.anomalies) {
+                        stages.episodes->add(b.first_index + a.row, a.anomaly, b.episodes);
+                    }
+                    stages.episodes->advanceTo(b.first_index + b.samples.size, b.episodes);
+                }
+                break;
+            }
+            case kPersist: {
+                ScopedStageTimer timer(Profiler::kPersist);
+                if (result.first_time < 0) result.first_time = b.samples.timestamp[0];
+                result.last_time = b.samples.timestamp[b.samples.size - 1];
+                result.sample_count += b.samples.size;
+                Profiler::count(Profiler::kSamples, b.samples.size);
+                if (stages.persist) stages.persist(b);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+};
+
+const char* const kThreadNames[kStageCount] = {"pipeline-ingest", "pipeline-fusion",
+                                               "pipeline-analyze", "pipeline-writer"};
+
+// Consecutive stages handled by one thread, [first, last)
+struct StageGroup {
+    Stage first;
+    Stage last;
+};
+
+std::vector<StageGroup> groupStages(size_t threads) {
+    switch (std::min<size_t>(threads, 4)) {
+        case 2:
+            return {{kIngest, kPersist}, {kPersist, kStageCount}};
+        case 3:
+            return {{kIngest, kFusion}, {kFusion, kPersist}, {kPersist, kStageCount}};
+        default:
+            return {{kIngest, kFusion}, {kFusion, kAnalyze}, {kAnalyze, kPersist},
+                    {kPersist, kStageCount}};
+    }
+}
+
+}  // namespace
+
+StagedPipeline::Result StagedPipeline::run(const Stages& stages, const Options& options) {
+    Result result;
+    StageRunner runner{stages, result};
+
+    if (options.threads <= 1) {
+        PipelineBatch batch;
+        batch.samples.reserve(options.batch_rows);
+        batch.fused.reserve(options.batch_rows);
+        for (;;) {
+            runner.run(kIngest, batch);
+            if (batch.end_of_stream) break;
+            for (int s = kFusion; s < kStageCount; ++s) runner.run(static_cast<Stage>(s), batch);
+        }
+        return result;
+    }
+
+    // Fixed pool of batches cycles from the writer back to the reader, so
+    // nothing is allocated once the pipeline has warmed up.
+    const size_t depth = std::max<size_t>(options.queue_depth, 2);
+    std::vector<std::unique_ptr<PipelineBatch>> pool;
+    SpscRing<PipelineBatch*> free_ring(depth);
+    for (size_t i = 0; i < depth; ++i) {
+        pool.push_back(std::make_unique<PipelineBatch>());
+        pool.back()->samples.reserve(options.batch_rows);
+        pool.back()->fused.reserve(options.batch_rows);
+        free_ring.push(pool.back().get());
+    }
+
+    const std::vector<StageGroup> groups = groupStages(options.threads);
+    std::vector<std::unique_ptr<SpscRing<PipelineBatch*>>> links;
+    for (size_t i = 0; i + 1 < groups.size(); ++i) {
+        links.push_back(std::make_unique<SpscRing<PipelineBatch*>>(depth));
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        SpscRing<PipelineBatch*>& in = (g == 0) ? free_ring : *links[g - 1];
+        SpscRing<PipelineBatch*>& out = (g + 1 == groups.size()) ? free_ring : *links[g];
+        const StageGroup group = groups[g];
+        const bool is_writer = (g + 1 == groups.size());
+
+        threads.emplace_back([&runner, &in, &out, group, is_writer] {
+            Tracer::setThreadName(kThreadNames[group.first]);
+            for (;;) {
+                PipelineBatch* b = in.pop();
+                if (!b->end_of_stream || group.first == kIngest) {
+                    for (int s = group.first; s < group.last; ++s) {
+                        runner.run(static_cast<Stage>(s), *b);
+                        if (b->end_of_stream) break;
+                    }
+                }
+                const bool done = b->end_of_stream;
+                // The writer recycles batches; the end marker is not recycled
+                // because the reader has already stopped.
+                if (!(is_writer && done)) out.push(b);
+                if (done) return;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    return result;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,64 @@
+#pragma once
+#include "astvdp/interfaces.h"
+#include "analysis/episode_tracker.h"
+#include "diagnostics/diagnostic_engine.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace astvdp {
+
+// One unit of work flowing through the pipeline: a block of raw samples plus
+// everything the stages derive from it.
+struct PipelineBatch {
+    SampleBlock samples;
+    uint64_t first_index = 0;  // stream index of samples row 0
+    FusedBlock fused;
+    std::vector<BlockAnomaly> verifier_anomalies;
+    std::vector<BlockAnomaly> diagnostic_anomalies;
+    std::vector<BlockAnomaly> anomalies;   // merged, in per-sample order
+    std::vector<AnomalyEpisode> episodes;  // episodes that closed in this batch
+    bool end_of_stream = false;
+};
+
+// Ingest -> fusion -> verify/diagnose -> persist over SampleBlocks. With more
+// than one thread the stages run on their own threads, connected by bounded
+// SPSC rings; with one thread they run inline. Batches reach the persist
+// callback in input order either way, so output is identical.
+class StagedPipeline {
+public:
+    struct Stages {
+        DataIngest* ingest = nullptr;
+        SensorFusion* fusion = nullptr;
+        SafetyVerifier* verifier = nullptr;
+        DiagnosticEngine* diagnostics = nullptr;
+        // Optional: coalesces anomalies into PipelineBatch::episodes. Episodes
+        // still open at the end are left for the caller's finish() call.
+        EpisodeTracker* episodes = nullptr;
+        // Runs on the writer thread, one batch at a time, in input order
+        std::function<void(PipelineBatch&)> persist;
+    };
+
+    struct Options {
+        size_t threads = 4;       // 1 = serial; 2..4 = stage threads (writer always separate)
+        size_t batch_rows = SampleBlock::kDefaultCapacity;
+        size_t queue_depth = 8;   // batches in flight
+    };
+
+    struct Result {
+        size_t sample_count = 0;
+        double first_time = -1.0;
+        double last_time = -1.0;
+    };
+
+    static Result run(const Stages& stages, const Options& options);
+};
+
+// Merges row-ordered verifier and diagnostics output back into per-sample
+// order (verifier first within a row), matching the per-sample loop.
+void mergeByRow(std::vector<BlockAnomaly>& verifier_anomalies,
+                std::vector<BlockAnomaly>& diagnostic_anomalies,
+                std::vector<BlockAnomaly>& out);
+
+}  // namespace astvdp
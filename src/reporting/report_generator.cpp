@@ -50,23 +50,42 @@ static std::string verdictFromClass(const std::string& risk) {
     return "PASS";
 }
 
+std::string ReportGenerator::loadTemplate() {
+    const std::filesystem::path template_path = resolveTemplatePath();
+    if (template_path.empty()) return {};
+
+    std::ifstream ifs(template_path);
+    if (!ifs.is_open()) return {};
+
+    return std::string((std::istreambuf_iterator<char>(ifs)),
+                       std::istreambuf_iterator<char>());
+}
+
 bool ReportGenerator::generateHtmlReport(
     const std::string& output_dir,
     const std::string& mission_id,
     const std::string& aircraft,
     double duration_sec,
     const SessionMetrics& metrics,
-    const std::vector<Anomaly>& anomalies) {
+    const std::vector<AnomalyEpisode>& anomalies) {
 
-    const std::filesystem::path template_path = resolveTemplatePath();
-    if (template_path.empty()) return false;
+    const std::string report_template = loadTemplate();
+    if (report_template.empty()) return false;
+    return generateHtmlReport(report_template, output_dir, mission_id, aircraft,
+                              duration_sec, metrics, anomalies);
+}
 
-    std::ifstream ifs(template_path);
-    if (!ifs.is_open()) return false;
+bool ReportGenerator::generateHtmlReport(
+    const std::string& report_template,
+    const std::string& output_dir,
+    const std::string& mission_id,
+    const std::string& aircraft,
+    double duration_sec,
+    const SessionMetrics& metrics,
+    const std::vector<AnomalyEpisode>& anomalies) {
 
-    std::string content((std::istreambuf_iterator<char>(ifs)),
-                         std::istreambuf_iterator<char>());
-    ifs.close();
+    if (report_template.empty()) return false;
+    std::string content = report_template;
 
     // Replace placeholders
     auto replace = [&](const std::string& key, const std::string& value) {
@@ -96,12 +115,16 @@ bool ReportGenerator::generateHtmlReport(
     std::ostringstream rows;
     for (const auto& a : anomalies) {
         std::string sev_str = severityToString(a.severity);
+        const AnomalyDescriptor& desc = a.describe();
         std::string row = "<tr class=\"" + toLower(sev_str) + "\">"
-            "<td>" + std::to_string(a.timestamp) + "</td>"
-            "<td>" + a.type + "</td>"
-            "<td>" + a.param + "</td>"
+            "<td>" + std::to_string(a.start_time) + "</td>"
+            "<td>" + std::to_string(a.end_time) + "</td>"
+            "<td>" + std::to_string(a.count) + "</td>"
+            "<td>" + desc.type + "</td>"
+            "<td>" + desc.param + "</td>"
             "<td>" + sev_str + "</td>"
-            "<td>" + a.details + "</td>"
+            "<td>" + std::to_string(a.peak) + "</td>"
+            "<td>" + desc.details + "</td>"
             "</tr>\n";
         rows << row;
     }
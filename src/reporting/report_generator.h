@@ -9,13 +9,27 @@ struct SessionMetrics;
 
 class ReportGenerator {
 public:
+    // Reads the HTML template once; empty if it cannot be found or read
+    static std::string loadTemplate();
+
+    static bool generateHtmlReport(
+        const std::string& output_dir,
+        const std::string& mission_id,
+        const std::string& aircraft,
+        double duration_sec,
+        const SessionMetrics& metrics,
+        const std::vector<AnomalyEpisode>& anomalies
+    );
+
+    // Same as above with a template already loaded via loadTemplate()
     static bool generateHtmlReport(
+        const std::string& report_template,
         const std::string& output_dir,
         const std::string& mission_id,
         const std::string& aircraft,
         double duration_sec,
         const SessionMetrics& metrics,
-        const std::vector<Anomaly>& anomalies
+        const std::vector<AnomalyEpisode>& anomalies
     );
 
     static bool convertHtmlToPdf(const std::string& html_path, const std::string& pdf_path);
@@ -1,4 +1,7 @@
 #pragma once
+#include <cstddef>
+#include <ostream>
+#include <random>
 #include <string>
 #include <vector>
 #include "astvdp/types.h"
@@ -15,8 +18,39 @@ public:
         bool inject_imu_drift = false;
     };
 
+    // Generates a profile one sample at a time in constant memory. The
+    // samples are the ones generate() returns, in the same order.
+    class Stream {
+    public:
+        explicit Stream(const Profile& profile);
+
+        size_t size() const { return count_; }  // samples in the whole flight
+        size_t remaining() const { return count_ - index_; }
+
+        bool next(TimestampedSample& out);
+        // Appends samples until `out` is full or the flight ends; returns
+        // the number appended
+        size_t fill(SampleBlock& out);
+
+    private:
+        Profile profile_;
+        size_t count_;
+        size_t index_ = 0;
+        double dt_;
+        std::mt19937 rng_{12345};  // deterministic seed
+        std::normal_distribution<double> noise_{0.0, 0.05};
+        double t_ = 0.0;
+        double roll_ = 0.0;
+        double yaw_ = 0.0;
+        double imu_az_bias_ = 0.0;
+    };
+
     static std::vector<TimestampedSample> generate(const Profile& profile);
     static bool saveToCsv(const std::vector<TimestampedSample>& data, const std::string& path);
+
+    // The CSV layout saveToCsv() writes, for writing samples incrementally
+    static void writeCsvHeader(std::ostream& out);
+    static void writeCsvRow(std::ostream& out, const TimestampedSample& s);
 };
 
-}  // namespace astvdp
\ No newline at end of file
+}  // namespace astvdp
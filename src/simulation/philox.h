@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace astvdp {
+
+// Philox4x32-10 counter-based random generator (Salmon et al., "Parallel
+// Random Numbers: As Easy as 1, 2, 3", SC'11). Every (key, counter) pair
+// maps to four independent 32-bit words, so any element of a stream can be
+// computed directly, on any thread, without stepping through the ones
+// before it.
+class Philox4x32 {
+public:
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static Counter generate(Counter ctr, Key key) {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += kWeyl0;
+                key[1] += kWeyl1;
+            }
+            const uint64_t p0 = uint64_t{kMul0} * ctr[0];
+            const uint64_t p1 = uint64_t{kMul1} * ctr[2];
+            ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(p1),
+                   static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(p0)};
+        }
+        return ctr;
+    }
+
+    static Key key(uint64_t seed) {
+        return {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    }
+
+    // The four words of one block as uniforms in (0, 1)
+    static void uniforms(const Counter& ctr, const Key& key, double out[4]) {
+        constexpr double kScale = 1.0 / 4294967296.0;  // 2^-32
+        const Counter w = generate(ctr, key);
+        for (int i = 0; i < 4; ++i) out[i] = (w[i] + 0.5) * kScale;
+    }
+
+    // Standard normal deviate from a uniform in (0, 1) by the inverse CDF,
+    // after Wichura's AS 241 (PPND16), accurate to about 1e-16
+    static double inverseNormal(double p) {
+        const double q = p - 0.5;
+        return std::fabs(q) <= kCentral ? centralNormal(q) : tailNormal(p);
+    }
+
+    // inverseNormal() over an array. The central 85% of inputs needs only a
+    // rational polynomial, so that is run over every element first without
+    // branching (and vectorizes), and the tails are patched in a second pass.
+    static void inverseNormals(const double* p, double* x, size_t n) {
+        for (size_t i = 0; i < n; ++i) x[i] = centralNormal(p[i] - 0.5);
+        for (size_t i = 0; i < n; ++i) {
+            if (std::fabs(p[i] - 0.5) > kCentral) x[i] = tailNormal(p[i]);
+        }
+    }
+
+private:
+    static constexpr double kCentral = 0.425;
+
+    static double centralNormal(double q) {
+        const double r = 0.180625 - q * q;
+        return q *
+               (((((((2.5090809287301226727e+3 * r + 3.3430575583588128105e+4) * r +
+                     6.7265770927008700853e+4) * r + 4.5921953931549871457e+4) * r +
+                   1.3731693765509461125e+4) * r + 1.9715909503065514427e+3) * r +
+                 1.3314166789178437745e+2) * r + 3.3871328727963666080e+0) /
+               (((((((5.2264952788528545610e+3 * r + 2.8729085735721942674e+4) * r +
+                     3.9307895800092710610e+4) * r + 2.1213794301586595867e+4) * r +
+                   5.3941960214247511077e+3) * r + 6.8718700749205790830e+2) * r +
+                 4.2313330701600911252e+1) * r + 1.0);
+    }
+
+    static double tailNormal(double p) {
+        const double q = p - 0.5;
+        double r = std::sqrt(-std::log(q < 0.0 ? p : 1.0 - p));
+        double x;
+        if (r <= 5.0) {
+            r -= 1.6;
+            x = (((((((7.74545014278341407640e-4 * r + 2.27238449892691845833e-2) * r +
+                      2.41780725177450611770e-1) * r + 1.27045825245236838258e+0) * r +
+                    3.64784832476320460504e+0) * r + 5.76949722146069140550e+0) * r +
+                  4.63033784615654529590e+0) * r + 1.42343711074968357734e+0) /
+                (((((((1.05075007164441684324e-9 * r + 5.47593808499534494600e-4) * r +
+                      1.51986665636164571966e-2) * r + 1.48103976427480074590e-1) * r +
+                    6.89767334985100004550e-1) * r + 1.67638483018380384940e+0) * r +
+                  2.05319162663775882187e+0) * r + 1.0);
+        } else {
+            r -= 5.0;
+            x = (((((((2.01033439929228813265e-7 * r + 2.71155556874348757815e-5) * r +
+                      1.24266094738807843860e-3) * r + 2.65321895265761230930e-2) * r +
+                    2.96560571828504891230e-1) * r + 1.78482653991729133580e+0) * r +
+                  5.46378491116411436990e+0) * r + 6.65790464350110377720e+0) /
+                (((((((2.04426310338993978564e-15 * r + 1.42151175831644588870e-7) * r +
+                      1.84631831751005468180e-5) * r + 7.86869131145613259100e-4) * r +
+                    1.48753612908506148525e-2) * r + 1.36929880922735805310e-1) * r +
+                  5.99832206555887937690e-1) * r + 1.0);
+        }
+        return q < 0.0 ? -x : x;
+    }
+
+    static constexpr uint32_t kMul0 = 0xD2511F53;
+    static constexpr uint32_t kMul1 = 0xCD9E8D57;
+    static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+    static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+};
+
+}  // namespace astvdp
@@ -0,0 +1,136 @@
+#include "scenario.h"
+#include "core/json.h"
+#include <cmath>
+
+namespace astvdp {
+
+namespace {
+
+constexpr size_t kMaxRepeat = 10000;
+
+bool readFault(const JsonValue& item, Scenario::Fault& f, std::string& error) {
+    std::string type;
+    if (item.kind != JsonValue::Kind::Object || !readString(item, "type", type) ||
+        !readNumber(item, "start", f.start) || !readNumber(item, "end", f.end) ||
+        !readNumber(item, "rate", f.rate)) {
+        error = "malformed entry";
+        return false;
+    }
+    if (type == "vibration_ramp") {
+        f.type = Scenario::Fault::kVibrationRamp;
+    } else if (type == "gnss_dropout") {
+        f.type = Scenario::Fault::kGnssDropout;
+    } else if (type == "imu_drift") {
+        f.type = Scenario::Fault::kImuDrift;
+    } else {
+        error = "unknown type \"" + type + "\" (use vibration_ramp, gnss_dropout or imu_drift)";
+        return false;
+    }
+    if (!(f.start < f.end)) {
+        error = "\"start\" must be before \"end\"";
+        return false;
+    }
+    return true;
+}
+
+bool readScenario(const JsonValue& root, Scenario& out, std::string& error) {
+    if (root.kind != JsonValue::Kind::Object) {
+        error = "scenario must be a JSON object";
+        return false;
+    }
+    double seed = static_cast<double>(out.seed);
+    double repeat = static_cast<double>(out.repeat);
+    const JsonValue* origin = member(root, "origin");
+    const bool ok = readString(root, "name", out.name) && readNumber(root, "seed", seed) &&
+                    readNumber(root, "sample_rate_hz", out.sample_rate_hz) &&
+                    readNumber(root, "noise_std", out.noise_std) && readNumber(root, "repeat", repeat) &&
+                    (!origin || (origin->kind == JsonValue::Kind::Object &&
+                                 readNumber(*origin, "lat", out.origin_lat) &&
+                                 readNumber(*origin, "lon", out.origin_lon) &&
+                                 readNumber(*origin, "alt", out.origin_alt)));
+    if (!ok) {
+        error = "malformed scenario fields";
+        return false;
+    }
+    // Seeds above 2^53 do not survive JSON numbers
+    if (!(seed >= 0 && seed <= 9007199254740992.0 && seed == std::floor(seed))) {
+        error = "\"seed\" must be a non-negative integer";
+        return false;
+    }
+    out.seed = static_cast<uint64_t>(seed);
+    if (!(out.sample_rate_hz > 0 && std::isfinite(out.sample_rate_hz))) {
+        error = "\"sample_rate_hz\" must be positive";
+        return false;
+    }
+    if (!(out.noise_std >= 0 && std::isfinite(out.noise_std))) {
+        error = "\"noise_std\" must be non-negative";
+        return false;
+    }
+    if (!(repeat >= 1 && repeat <= kMaxRepeat && repeat == std::floor(repeat))) {
+        error = "\"repeat\" must be an integer from 1 to " + std::to_string(kMaxRepeat);
+        return false;
+    }
+    out.repeat = static_cast<size_t>(repeat);
+
+    const JsonValue* segments = member(root, "segments");
+    if (!segments || segments->kind != JsonValue::Kind::Array || segments->array.empty()) {
+        error = "scenario needs a non-empty \"segments\" array";
+        return false;
+    }
+    for (size_t i = 0; i < segments->array.size(); ++i) {
+        const JsonValue& item = segments->array[i];
+        Scenario::Segment s;
+        const bool seg_ok = item.kind == JsonValue::Kind::Object &&
+                            readNumber(item, "duration", s.duration_sec) &&
+                            readNumber(item, "climb_rate", s.climb_rate) && readNumber(item, "pitch", s.pitch) &&
+                            readNumber(item, "bank", s.bank) && readNumber(item, "turn_rate", s.turn_rate) &&
+                            readNumber(item, "speed", s.speed);
+        if (!seg_ok || !(s.duration_sec > 0 && std::isfinite(s.duration_sec))) {
+            error = "segment " + std::to_string(i) + ": needs a positive \"duration\" and numeric rates";
+            return false;
+        }
+        out.segments.push_back(s);
+    }
+
+    if (const JsonValue* faults = member(root, "faults")) {
+        if (faults->kind != JsonValue::Kind::Array) {
+            error = "\"faults\" must be an array";
+            return false;
+        }
+        for (size_t i = 0; i < faults->array.size(); ++i) {
+            Scenario::Fault f;
+            if (!readFault(faults->array[i], f, error)) {
+                error = "fault " + std::to_string(i) + ": " + error;
+                return false;
+            }
+            out.faults.push_back(f);
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+double Scenario::duration() const {
+    double total = 0.0;
+    for (const auto& s : segments) total += s.duration_sec;
+    return total * static_cast<double>(repeat);
+}
+
+uint64_t Scenario::sampleCount() const {
+    return static_cast<uint64_t>(duration() * sample_rate_hz);
+}
+
+bool parseScenario(const std::string& json, Scenario& out, std::string& error) {
+    JsonValue root;
+    out = Scenario{};
+    return parseJson(json, root, error) && readScenario(root, out, error);
+}
+
+bool loadScenario(const std::string& path, Scenario& out, std::string& error) {
+    JsonValue root;
+    out = Scenario{};
+    return loadJsonFile(path, root, error) && readScenario(root, out, error);
+}
+
+}  // namespace astvdp
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace astvdp {
+
+// A simulated flight described as data: a sequence of flight segments with
+// constant rates, fault injections over time windows, the sample rate and
+// the noise seed. Loaded from a JSON scenario file:
+//
+//   { "name": "...", "seed": 7, "sample_rate_hz": 100, "noise_std": 0.05,
+//     "origin": { "lat": 45.0, "lon": -75.0, "alt": 0 }, "repeat": 1,
+//     "segments": [ { "duration": 60, "climb_rate": 5, "pitch": 0.1,
+//                     "bank": 0, "turn_rate": 0, "speed": 80 }, ... ],
+//     "faults": [ { "type": "vibration_ramp", "start": 200, "end": 260,
+//                   "rate": 0.1 }, ... ] }
+//
+// Angles are radians, rates per second, distances metres. Everything but
+// "segments" is optional. "repeat" flies the segment list that many times
+// back to back, for long soak runs from a short file.
+struct Scenario {
+    struct Segment {
+        double duration_sec = 0.0;
+        double climb_rate = 0.0;  // m/s
+        double pitch = 0.0;       // rad
+        double bank = 0.0;        // rad
+        double turn_rate = 0.0;   // heading change, rad/s
+        double speed = 80.0;      // ground speed, m/s
+    };
+
+    struct Fault {
+        enum Type : uint8_t {
+            kVibrationRamp,  // vib_x/y/z rise by rate * (t - start)
+            kGnssDropout,    // gps_lat/lon read 0
+            kImuDrift,       // imu_az bias grows by rate * (t - start)
+        };
+        Type type = kVibrationRamp;
+        double start = 0.0;
+        double end = std::numeric_limits<double>::infinity();  // exclusive
+        double rate = 0.0;
+    };
+
+    std::string name;
+    uint64_t seed = 12345;
+    double sample_rate_hz = 100.0;
+    double noise_std = 0.05;
+    double origin_lat = 45.0;
+    double origin_lon = -75.0;
+    double origin_alt = 0.0;
+    size_t repeat = 1;
+    std::vector<Segment> segments;
+    std::vector<Fault> faults;
+
+    double duration() const;  // seconds, all repeats
+    uint64_t sampleCount() const;
+};
+
+bool parseScenario(const std::string& json, Scenario& out, std::string& error);
+bool loadScenario(const std::string& path, Scenario& out, std::string& error);
+
+}  // namespace astvdp
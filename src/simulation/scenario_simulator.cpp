@@ -0,0 +1,167 @@
+#include "scenario_simulator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace astvdp {
+
+namespace {
+
+constexpr double kMetresPerDegLat = 111320.0;
+constexpr double kGravity = 9.81;
+constexpr double kPi = 3.141592653589793;
+
+}  // namespace
+
+ScenarioSimulator::ScenarioSimulator(const Scenario& scenario)
+    : scenario_(scenario),
+      count_(scenario.sampleCount()),
+      key_(Philox4x32::key(scenario.seed)),
+      metres_per_deg_lon_(kMetresPerDegLat * std::cos(scenario.origin_lat * kPi / 180.0)) {
+    // Start state of every leg, integrated segment by segment in closed form
+    legs_.reserve(scenario_.segments.size() * scenario_.repeat);
+    Leg leg{0.0, scenario_.origin_alt, 0.0, 0.0, 0.0, 0};
+    for (size_t r = 0; r < scenario_.repeat; ++r) {
+        for (size_t si = 0; si < scenario_.segments.size(); ++si) {
+            const Scenario::Segment& s = scenario_.segments[si];
+            leg.segment = si;
+            legs_.push_back(leg);
+            const double d = s.duration_sec;
+            const double heading = leg.heading0 + s.turn_rate * d;
+            if (s.turn_rate != 0.0) {
+                leg.north0 += s.speed / s.turn_rate * (std::sin(heading) - std::sin(leg.heading0));
+                leg.east0 -= s.speed / s.turn_rate * (std::cos(heading) - std::cos(leg.heading0));
+            } else {
+                leg.north0 += s.speed * std::cos(leg.heading0) * d;
+                leg.east0 += s.speed * std::sin(leg.heading0) * d;
+            }
+            leg.t0 += d;
+            leg.alt0 += s.climb_rate * d;
+            leg.heading0 = heading;
+        }
+    }
+}
+
+size_t ScenarioSimulator::legAt(double t) const {
+    const auto it = std::upper_bound(legs_.begin(), legs_.end(), t,
+                                     [](double time, const Leg& leg) { return time < leg.t0; });
+    return it == legs_.begin() ? 0 : static_cast<size_t>(it - legs_.begin()) - 1;
+}
+
+void ScenarioSimulator::fillNoise(uint64_t tile, double* noise) const {
+    double uniform[kNoiseTile * kNoisePerSample];
+    for (size_t k = 0; k < kNoiseTile; ++k) {
+        const uint64_t i = tile + k;
+        for (uint32_t b = 0; b < kNoisePerSample / 4; ++b) {
+            Philox4x32::uniforms({static_cast<uint32_t>(i), static_cast<uint32_t>(i >> 32), b, 0}, key_,
+                                 uniform + k * kNoisePerSample + 4 * b);
+        }
+    }
+    Philox4x32::inverseNormals(uniform, noise, kNoiseTile * kNoisePerSample);
+}
+
+void ScenarioSimulator::generate(uint64_t first, size_t count, SampleBlock& out, size_t at) const {
+    const double rate = scenario_.sample_rate_hz;
+    const double sigma = scenario_.noise_std;
+    double noise[kNoiseTile * kNoisePerSample];
+    uint64_t tile = 0;
+    bool have_tile = false;
+    size_t leg_index = legAt(static_cast<double>(first) / rate);
+    size_t cached_leg = legs_.size();
+    double ay = 0.0;
+    double az = 0.0;
+    double sin_h0 = 0.0;
+    double cos_h0 = 0.0;
+
+    for (size_t k = 0; k < count; ++k) {
+        const uint64_t i = first + k;
+        const double t = static_cast<double>(i) / rate;
+        while (leg_index + 1 < legs_.size() && t >= legs_[leg_index + 1].t0) ++leg_index;
+        const Leg& leg = legs_[leg_index];
+        const Scenario::Segment& s = scenario_.segments[leg.segment];
+        if (leg_index != cached_leg) {
+            cached_leg = leg_index;
+            ay = kGravity * std::sin(s.bank);
+            az = kGravity * std::cos(s.bank) * std::cos(s.pitch);
+            sin_h0 = std::sin(leg.heading0);
+            cos_h0 = std::cos(leg.heading0);
+        }
+
+        // 12 deviates from three Philox blocks at counter (i, block),
+        // computed a tile at a time
+        if (!have_tile || i - tile >= kNoiseTile) {
+            tile = i - i % kNoiseTile;
+            have_tile = true;
+            fillNoise(tile, noise);
+        }
+        const double* n = noise + (i - tile) * kNoisePerSample;
+
+        const double dt = t - leg.t0;
+        const double alt = leg.alt0 + s.climb_rate * dt;
+        const double heading = leg.heading0 + s.turn_rate * dt;
+        const double cos_h = std::cos(heading);
+        const double sin_h = std::sin(heading);
+        double north;
+        double east;
+        if (s.turn_rate != 0.0) {
+            north = leg.north0 + s.speed / s.turn_rate * (sin_h - sin_h0);
+            east = leg.east0 - s.speed / s.turn_rate * (cos_h - cos_h0);
+        } else {
+            north = leg.north0 + s.speed * cos_h * dt;
+            east = leg.east0 + s.speed * sin_h * dt;
+        }
+
+        double vib = 1.0 + 0.5 * std::sin(t * 10.0);
+        double az_bias = 0.0;
+        bool dropout = false;
+        for (const auto& f : scenario_.faults) {
+            if (t < f.start || t >= f.end) continue;
+            switch (f.type) {
+                case Scenario::Fault::kVibrationRamp: vib += f.rate * (t - f.start); break;
+                case Scenario::Fault::kImuDrift: az_bias += f.rate * (t - f.start); break;
+                case Scenario::Fault::kGnssDropout: dropout = true; break;
+            }
+        }
+
+        const size_t row = at + k;
+        out.timestamp[row] = t;
+        out.gps_alt[row] = alt + sigma * n[0];
+        out.gps_vx[row] = s.speed * cos_h + sigma * n[1];
+        out.gps_vy[row] = s.speed * sin_h + sigma * n[2];
+        out.gps_lat[row] = dropout ? 0.0 : scenario_.origin_lat + north / kMetresPerDegLat;
+        out.gps_lon[row] = dropout ? 0.0 : scenario_.origin_lon + east / metres_per_deg_lon_;
+        out.imu_ax[row] = sigma * n[3];
+        out.imu_ay[row] = ay + sigma * n[4];
+        out.imu_az[row] = az + sigma * n[5] + az_bias;
+        out.imu_gx[row] = sigma * n[6];
+        out.imu_gy[row] = sigma * n[7];
+        out.imu_gz[row] = s.turn_rate + sigma * n[8];
+        out.static_pressure[row] = 101325.0 * std::pow(1.0 - alt / 44330.0, 5.255);
+        out.temperature[row] = 15.0 - 0.0065 * alt;
+        out.vib_x[row] = vib + sigma * n[9];
+        out.vib_y[row] = vib + sigma * n[10];
+        out.vib_z[row] = vib + sigma * n[11];
+    }
+}
+
+void ScenarioSimulator::generate(uint64_t first, size_t count, SampleBlock& out, size_t at,
+                                 WorkStealingPool& pool) const {
+    const size_t tasks = pool.size() * 4;
+    const size_t chunk = std::max(kMinChunk, (count + tasks - 1) / tasks);
+    for (size_t done = 0; done < count; done += chunk) {
+        const size_t n = std::min(chunk, count - done);
+        pool.submit([this, first, done, n, &out, at] { generate(first + done, n, out, at + done); });
+    }
+    pool.wait();
+}
+
+uint64_t ScenarioSimulator::indexAt(double timestamp) const {
+    if (!(timestamp > 0.0)) return 0;
+    const double rate = scenario_.sample_rate_hz;
+    auto i = static_cast<uint64_t>(std::min(std::ceil(timestamp * rate), static_cast<double>(count_)));
+    // Correct the rounding of timestamp * rate against the i / rate times
+    while (i > 0 && static_cast<double>(i - 1) / rate >= timestamp) --i;
+    while (i < count_ && static_cast<double>(i) / rate < timestamp) ++i;
+    return i;
+}
+
+}  // namespace astvdp
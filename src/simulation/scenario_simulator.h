@@ -0,0 +1,62 @@
+#pragma once
+#include "astvdp/types.h"
+#include "core/work_stealing_pool.h"
+#include "philox.h"
+#include "scenario.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace astvdp {
+
+// Generates a Scenario's samples straight into SampleBlock columns. Sample i
+// depends only on the scenario and i. Its time is i / sample_rate. Its
+// flight state comes in closed form from the segment that holds that time.
+// Its noise comes from a Philox stream keyed by the seed, with i as the
+// counter, and is computed in fixed tiles aligned to i. So any range of
+// samples can be generated on its own, on any thread, and the output is
+// bit-identical however the work is split.
+class ScenarioSimulator {
+public:
+    static constexpr size_t kNoiseTile = 64;  // samples per noise batch; ranges aligned to it cost least
+
+    explicit ScenarioSimulator(const Scenario& scenario);
+
+    uint64_t size() const { return count_; }
+    const Scenario& scenario() const { return scenario_; }
+
+    // Writes samples [first, first + count) to rows [at, at + count) of
+    // `out`, which must have that capacity. Does not change out.size.
+    void generate(uint64_t first, size_t count, SampleBlock& out, size_t at = 0) const;
+    // The same, split into chunks on `pool`; returns when all are written
+    void generate(uint64_t first, size_t count, SampleBlock& out, size_t at, WorkStealingPool& pool) const;
+
+    // Index of the first sample at or after `timestamp` (size() if none)
+    uint64_t indexAt(double timestamp) const;
+
+private:
+    static constexpr size_t kMinChunk = 1024;      // rows per pool task
+    static constexpr size_t kNoisePerSample = 12;  // deviates, 4 per Philox block
+
+    // One flown segment with the state it starts from
+    struct Leg {
+        double t0;
+        double alt0;
+        double heading0;
+        double north0;  // metres from the origin
+        double east0;
+        size_t segment;  // index into scenario_.segments
+    };
+
+    size_t legAt(double t) const;
+    // Deviates of samples [tile, tile + kNoiseTile), kNoisePerSample each
+    void fillNoise(uint64_t tile, double* noise) const;
+
+    Scenario scenario_;
+    uint64_t count_;
+    std::vector<Leg> legs_;
+    Philox4x32::Key key_;
+    double metres_per_deg_lon_;
+};
+
+}  // namespace astvdp
@@ -0,0 +1,184 @@
+#include "envelope_kernels.h"
+#include <cmath>
+
+#ifdef ASTVDP_X86
+#include <immintrin.h>
+#endif
+
+namespace astvdp {
+
+namespace {
+
+using B = SafetyVerifierImpl;
+
+size_t envelopeScalar(const EnvelopeColumns& c, const B::LimitTable& t, size_t n, uint16_t* mask) {
+    size_t flagged = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint16_t m = 0;
+        auto outside = [](double v, const B::LimitRange& r, uint16_t bit) {
+            return static_cast<uint16_t>((v < r.min || v > r.max) ? bit : 0);
+        };
+        m |= outside(c.gyro_x[i], t[B::kLimitRollRate], B::kRollRate);
+        m |= outside(c.gyro_y[i], t[B::kLimitPitchRate], B::kPitchRate);
+        m |= outside(c.gyro_z[i], t[B::kLimitYawRate], B::kYawRate);
+        m |= static_cast<uint16_t>((c.q_dyn[i] < t[B::kLimitDynPressure].min) ? B::kDynPressureLow : 0);
+        m |= static_cast<uint16_t>((c.q_dyn[i] > t[B::kLimitDynPressure].max) ? B::kDynPressureHigh : 0);
+        m |= outside(c.alt_msl[i], t[B::kLimitAltitude], B::kAltitude);
+        m |= outside(c.temperature[i], t[B::kLimitTemperature], B::kTemperature);
+        const double vx = c.vib_x[i], vy = c.vib_y[i], vz = c.vib_z[i];
+        double vib_rms = std::sqrt((vx*vx + vy*vy + vz*vz) / 3.0);
+        m |= static_cast<uint16_t>((vib_rms > t[B::kLimitVibrationRms].max) ? B::kVibration : 0);
+        mask[i] = m;
+        flagged += (m != 0);
+    }
+    return flagged;
+}
+
+#ifdef ASTVDP_X86
+
+EnvelopeColumns advance(EnvelopeColumns c, size_t rows) {
+    for (auto* p : {&c.gyro_x, &c.gyro_y, &c.gyro_z, &c.q_dyn, &c.alt_msl,
+                    &c.temperature, &c.vib_x, &c.vib_y, &c.vib_z}) {
+        *p += rows;
+    }
+    return c;
+}
+
+// Spreads per-condition lane masks (bit j = lane j) into per-row breach bits
+inline size_t scatterLanes(const int* lane_masks, const uint16_t* bits, int count,
+                           int lanes, uint16_t* mask) {
+    size_t flagged = 0;
+    for (int j = 0; j < lanes; ++j) {
+        uint16_t m = 0;
+        for (int k = 0; k < count; ++k) {
+            if (lane_masks[k] & (1 << j)) m |= bits[k];
+        }
+        mask[j] = m;
+        flagged += (m != 0);
+    }
+    return flagged;
+}
+
+constexpr uint16_t kConditionBits[] = {
+    B::kRollRate, B::kPitchRate, B::kYawRate, B::kDynPressureLow, B::kDynPressureHigh,
+    B::kAltitude, B::kTemperature, B::kVibration,
+};
+constexpr int kConditionCount = 8;
+
+size_t envelopeSse2(const EnvelopeColumns& c, const B::LimitTable& t, size_t n, uint16_t* mask) {
+    auto outside = [](__m128d v, const B::LimitRange& r) {
+        return _mm_or_pd(_mm_cmplt_pd(v, _mm_set1_pd(r.min)), _mm_cmpgt_pd(v, _mm_set1_pd(r.max)));
+    };
+    const __m128d three = _mm_set1_pd(3.0);
+    const __m128d q_min = _mm_set1_pd(t[B::kLimitDynPressure].min);
+    const __m128d q_max = _mm_set1_pd(t[B::kLimitDynPressure].max);
+    const __m128d vib_max = _mm_set1_pd(t[B::kLimitVibrationRms].max);
+
+    size_t flagged = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d vx = _mm_loadu_pd(c.vib_x + i);
+        const __m128d vy = _mm_loadu_pd(c.vib_y + i);
+        const __m128d vz = _mm_loadu_pd(c.vib_z + i);
+        const __m128d sum = _mm_add_pd(_mm_add_pd(_mm_mul_pd(vx, vx), _mm_mul_pd(vy, vy)),
+                                       _mm_mul_pd(vz, vz));
+        const __m128d rms = _mm_sqrt_pd(_mm_div_pd(sum, three));
+        const __m128d q = _mm_loadu_pd(c.q_dyn + i);
+
+        const int lanes[kConditionCount] = {
+            _mm_movemask_pd(outside(_mm_loadu_pd(c.gyro_x + i), t[B::kLimitRollRate])),
+            _mm_movemask_pd(outside(_mm_loadu_pd(c.gyro_y + i), t[B::kLimitPitchRate])),
+            _mm_movemask_pd(outside(_mm_loadu_pd(c.gyro_z + i), t[B::kLimitYawRate])),
+            _mm_movemask_pd(_mm_cmplt_pd(q, q_min)),
+            _mm_movemask_pd(_mm_cmpgt_pd(q, q_max)),
+            _mm_movemask_pd(outside(_mm_loadu_pd(c.alt_msl + i), t[B::kLimitAltitude])),
+            _mm_movemask_pd(outside(_mm_loadu_pd(c.temperature + i), t[B::kLimitTemperature])),
+            _mm_movemask_pd(_mm_cmpgt_pd(rms, vib_max)),
+        };
+        int any = 0;
+        for (int k : lanes) any |= k;
+        if (!any) {
+            mask[i] = mask[i + 1] = 0;
+            continue;
+        }
+        flagged += scatterLanes(lanes, kConditionBits, kConditionCount, 2, mask + i);
+    }
+
+    return flagged + envelopeScalar(advance(c, i), t, n - i, mask + i);
+}
+
+ASTVDP_TARGET_AVX2
+inline __m256d outside(__m256d v, __m256d lo, __m256d hi) {
+    return _mm256_or_pd(_mm256_cmp_pd(v, lo, _CMP_LT_OQ), _mm256_cmp_pd(v, hi, _CMP_GT_OQ));
+}
+
+ASTVDP_TARGET_AVX2
+size_t envelopeAvx2(const EnvelopeColumns& c, const B::LimitTable& t, size_t n, uint16_t* mask) {
+    const __m256d roll_lo = _mm256_set1_pd(t[B::kLimitRollRate].min);
+    const __m256d roll_hi = _mm256_set1_pd(t[B::kLimitRollRate].max);
+    const __m256d pitch_lo = _mm256_set1_pd(t[B::kLimitPitchRate].min);
+    const __m256d pitch_hi = _mm256_set1_pd(t[B::kLimitPitchRate].max);
+    const __m256d yaw_lo = _mm256_set1_pd(t[B::kLimitYawRate].min);
+    const __m256d yaw_hi = _mm256_set1_pd(t[B::kLimitYawRate].max);
+    const __m256d q_lo = _mm256_set1_pd(t[B::kLimitDynPressure].min);
+    const __m256d q_hi = _mm256_set1_pd(t[B::kLimitDynPressure].max);
+    const __m256d alt_lo = _mm256_set1_pd(t[B::kLimitAltitude].min);
+    const __m256d alt_hi = _mm256_set1_pd(t[B::kLimitAltitude].max);
+    const __m256d temp_lo = _mm256_set1_pd(t[B::kLimitTemperature].min);
+    const __m256d temp_hi = _mm256_set1_pd(t[B::kLimitTemperature].max);
+    const __m256d vib_hi = _mm256_set1_pd(t[B::kLimitVibrationRms].max);
+    const __m256d three = _mm256_set1_pd(3.0);
+
+    size_t flagged = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d vx = _mm256_loadu_pd(c.vib_x + i);
+        const __m256d vy = _mm256_loadu_pd(c.vib_y + i);
+        const __m256d vz = _mm256_loadu_pd(c.vib_z + i);
+        const __m256d sum = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vx, vx), _mm256_mul_pd(vy, vy)),
+                                          _mm256_mul_pd(vz, vz));
+        const __m256d rms = _mm256_sqrt_pd(_mm256_div_pd(sum, three));
+        const __m256d q = _mm256_loadu_pd(c.q_dyn + i);
+
+        const __m256d c_roll = outside(_mm256_loadu_pd(c.gyro_x + i), roll_lo, roll_hi);
+        const __m256d c_pitch = outside(_mm256_loadu_pd(c.gyro_y + i), pitch_lo, pitch_hi);
+        const __m256d c_yaw = outside(_mm256_loadu_pd(c.gyro_z + i), yaw_lo, yaw_hi);
+        const __m256d c_q_lo = _mm256_cmp_pd(q, q_lo, _CMP_LT_OQ);
+        const __m256d c_q_hi = _mm256_cmp_pd(q, q_hi, _CMP_GT_OQ);
+        const __m256d c_alt = outside(_mm256_loadu_pd(c.alt_msl + i), alt_lo, alt_hi);
+        const __m256d c_temp = outside(_mm256_loadu_pd(c.temperature + i), temp_lo, temp_hi);
+        const __m256d c_vib = _mm256_cmp_pd(rms, vib_hi, _CMP_GT_OQ);
+
+        // Nominal fast path: one OR-reduction decides the whole group
+        __m256d any = _mm256_or_pd(_mm256_or_pd(_mm256_or_pd(c_roll, c_pitch), _mm256_or_pd(c_yaw, c_q_lo)),
+                                   _mm256_or_pd(_mm256_or_pd(c_q_hi, c_alt), _mm256_or_pd(c_temp, c_vib)));
+        if (_mm256_movemask_pd(any) == 0) {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(mask + i), _mm_setzero_si128());
+            continue;
+        }
+        const int lanes[kConditionCount] = {
+            _mm256_movemask_pd(c_roll), _mm256_movemask_pd(c_pitch), _mm256_movemask_pd(c_yaw),
+            _mm256_movemask_pd(c_q_lo), _mm256_movemask_pd(c_q_hi), _mm256_movemask_pd(c_alt),
+            _mm256_movemask_pd(c_temp), _mm256_movemask_pd(c_vib),
+        };
+        flagged += scatterLanes(lanes, kConditionBits, kConditionCount, 4, mask + i);
+    }
+
+    return flagged + envelopeScalar(advance(c, i), t, n - i, mask + i);
+}
+
+#endif  // ASTVDP_X86
+
+}  // namespace
+
+EnvelopeKernel envelopeKernel(SimdLevel level) {
+#ifdef ASTVDP_X86
+    if (level == SimdLevel::Avx2 && detectSimdLevel() == SimdLevel::Avx2) return envelopeAvx2;
+    if (level != SimdLevel::Scalar) return envelopeSse2;
+#else
+    (void)level;
+#endif
+    return envelopeScalar;
+}
+
+}  // namespace astvdp
@@ -0,0 +1,32 @@
+#pragma once
+#include "core/cpu_features.h"
+#include "verification/safety_verifier.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace astvdp {
+
+// Column pointers for the per-row envelope checks of one block
+struct EnvelopeColumns {
+    const double* gyro_x;
+    const double* gyro_y;
+    const double* gyro_z;
+    const double* q_dyn;
+    const double* alt_msl;
+    const double* temperature;
+    const double* vib_x;
+    const double* vib_y;
+    const double* vib_z;
+};
+
+// Writes the envelope breach bits (all SafetyVerifierImpl::BreachBit values
+// except kGnssDropout) for rows [0, n) and returns the number of flagged rows.
+// Every kernel yields bit-identical masks: comparisons use the same operand
+// order and IEEE sqrt as the scalar code, and no FMA contraction is enabled.
+using EnvelopeKernel = size_t (*)(const EnvelopeColumns& cols,
+                                  const SafetyVerifierImpl::LimitTable& limits,
+                                  size_t n, uint16_t* mask);
+
+EnvelopeKernel envelopeKernel(SimdLevel level);  // falls back if unsupported
+
+}  // namespace astvdp
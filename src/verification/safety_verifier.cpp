@@ -1,34 +1,61 @@
 #include "safety_verifier.h"
+#include "envelope_kernels.h"
 #include "astvdp/sqlite_compat.h"
 #include <cmath>
+#include <cstring>
 #include <vector>
 #include <string>
 
 namespace astvdp {
 
 namespace {
-double getOr(const std::unordered_map<std::string, double>& values,
-             const std::string& key,
-             double fallback) {
-    auto it = values.find(key);
-    return (it != values.end()) ? it->second : fallback;
-}
+struct LimitName {
+    const char* name;
+    SafetyVerifierImpl::Limit limit;
+};
+
+constexpr LimitName kLimitNames[] = {
+    {"roll_rate", SafetyVerifierImpl::kLimitRollRate},
+    {"pitch_rate", SafetyVerifierImpl::kLimitPitchRate},
+    {"yaw_rate", SafetyVerifierImpl::kLimitYawRate},
+    {"q_dyn", SafetyVerifierImpl::kLimitDynPressure},
+    {"altitude", SafetyVerifierImpl::kLimitAltitude},
+    {"temperature", SafetyVerifierImpl::kLimitTemperature},
+    {"vibration_rms", SafetyVerifierImpl::kLimitVibrationRms},
+};
 }  // namespace
 
+// Each safety_limits row overrides the min/max pair of the parameter it
+// names; parameters without a row keep their defaults.
 static int limitCallback(void* data, int argc, char** argv, char** azColName) {
     (void)azColName;
-    auto* limits = static_cast<std::unordered_map<std::string, double>*>(data);
+    auto* limits = static_cast<SafetyVerifierImpl::LimitTable*>(data);
     if (argc >= 3 && argv[0] && argv[1] && argv[2]) {
-        std::string name = argv[0];
-        double min_val = std::stod(argv[1]);
-        double max_val = std::stod(argv[2]);
-        // Store as two entries: "roll_rate_min", "roll_rate_max"
-        (*limits)[name + "_min"] = min_val;
-        (*limits)[name + "_max"] = max_val;
+        for (const auto& entry : kLimitNames) {
+            if (std::strcmp(argv[0], entry.name) != 0) continue;
+            try {
+                (*limits)[entry.limit] = {std::stod(argv[1]), std::stod(argv[2])};
+            } catch (...) {
+                // Non-numeric limit: keep the default
+            }
+            break;
+        }
     }
     return 0;
 }
 
+SafetyVerifierImpl::LimitTable SafetyVerifierImpl::defaultLimits() {
+    LimitTable t;
+    t[kLimitRollRate] = {-0.35, 0.35};
+    t[kLimitPitchRate] = {-0.30, 0.30};
+    t[kLimitYawRate] = {-0.40, 0.40};
+    t[kLimitDynPressure] = {500.0, 20000.0};
+    t[kLimitAltitude] = {0.0, 15000.0};
+    t[kLimitTemperature] = {-55.0, 70.0};
+    t[kLimitVibrationRms] = {0.0, 5.0};
+    return t;
+}
+
 bool SafetyVerifierImpl::loadLimitsFromDb(const std::string& db_path) {
     sqlite3* db;
     int rc = sqlite3_open(db_path.c_str(), &db);
@@ -40,8 +67,8 @@ bool SafetyVerifierImpl::loadLimitsFromDb(const std::string& db_path) {
 
     const char* sql = "SELECT param_name, min_val, max_val FROM safety_limits;";
     char* errMsg = nullptr;
-    limits_.clear();
-    rc = sqlite3_exec(db, sql, limitCallback, &limits_, &errMsg);
+    LimitTable compiled = defaultLimits();
+    rc = sqlite3_exec(db, sql, limitCallback, &compiled, &errMsg);
     if (rc != SQLITE_OK) {
         sqlite3_free(errMsg);
         sqlite3_close(db);
@@ -50,108 +77,143 @@ bool SafetyVerifierImpl::loadLimitsFromDb(const std::string& db_path) {
     }
 
     sqlite3_close(db);
+    limits_ = compiled;
     return true;
 }
 
 void SafetyVerifierImpl::loadDefaults() {
-    limits_ = {
-        {"roll_rate_min", -0.35}, {"roll_rate_max", 0.35},
-        {"pitch_rate_min", -0.30}, {"pitch_rate_max", 0.30},
-        {"yaw_rate_min", -0.40}, {"yaw_rate_max", 0.40},
-        {"q_dyn_min", 500.0}, {"q_dyn_max", 20000.0},
-        {"altitude_min", 0.0}, {"altitude_max", 15000.0},
-        {"temperature_min", -55.0}, {"temperature_max", 70.0},
-        {"vibration_rms_max", 5.0}
-    };
+    limits_ = defaultLimits();
 }
 
 bool SafetyVerifierImpl::isGnssValid(const TimestampedSample& raw) {
+    return isGnssValid(raw.timestamp, raw.gps_lat, raw.gps_lon);
+}
+
+bool SafetyVerifierImpl::isGnssValid(double timestamp, double lat, double lon) {
     const double GNSS_INVALID_LAT = 0.0;
     const double GNSS_INVALID_LON = 0.0;
-    bool valid = (raw.gps_lat != GNSS_INVALID_LAT || raw.gps_lon != GNSS_INVALID_LON);
+    bool valid = (lat != GNSS_INVALID_LAT || lon != GNSS_INVALID_LON);
     if (valid) {
-        last_gnss_time_ = raw.timestamp;
+        last_gnss_time_ = timestamp;
         gnss_valid_ = true;
-    } else if (last_gnss_time_ >= 0 && (raw.timestamp - last_gnss_time_) > 1.0) {
+    } else if (last_gnss_time_ >= 0 && (timestamp - last_gnss_time_) > 1.0) {
         gnss_valid_ = false;
     }
     return gnss_valid_;
 }
 
-std::vector<Anomaly> SafetyVerifierImpl::check(const FusedState& state,
-                                               const TimestampedSample& raw) {
-    std::vector<Anomaly> anomalies;
+namespace {
+// Inputs of one flagged row, used to size each anomaly's value
+struct BreachRow {
+    double timestamp;
+    double gx, gy, gz;
+    double q_dyn, alt, temp;
+    double vx, vy, vz;
+    double gnss_outage;  // seconds since the last valid fix
+};
+
+inline float excess(double v, const SafetyVerifierImpl::LimitRange& r) {
+    return static_cast<float>((v < r.min) ? r.min - v : v - r.max);
+}
 
-    // 1. Angular rate limits (use raw IMU gyro)
-    auto checkRate = [&](const std::string& name, double rate, double min, double max) {
-        if (rate < min || rate > max) {
-            anomalies.push_back({
-                raw.timestamp, "limit_breach", name,
-                Severity::Major,
-                "Rate out of bounds"
-            });
-        }
-    };
-    checkRate("roll_rate", raw.imu_gx, getOr(limits_, "roll_rate_min", -0.35), getOr(limits_, "roll_rate_max", 0.35));
-    checkRate("pitch_rate", raw.imu_gy, getOr(limits_, "pitch_rate_min", -0.30), getOr(limits_, "pitch_rate_max", 0.30));
-    checkRate("yaw_rate", raw.imu_gz, getOr(limits_, "yaw_rate_min", -0.40), getOr(limits_, "yaw_rate_max", 0.40));
-
-    // 2. Dynamic pressure
-    double q_min = getOr(limits_, "q_dyn_min", 500.0);
-    double q_max = getOr(limits_, "q_dyn_max", 20000.0);
-    if (state.q_dyn < q_min || state.q_dyn > q_max) {
-        anomalies.push_back({
-            raw.timestamp, "limit_breach", "dynamic_pressure",
-            (state.q_dyn > q_max) ? Severity::Critical : Severity::Major,
-            "q outside envelope"
-        });
+// Expands a breach mask into anomalies, in the fixed order the checks run.
+template <typename Emit>
+void emitBreaches(uint16_t mask, const BreachRow& r, const SafetyVerifierImpl::LimitTable& t,
+                  Emit&& emit) {
+    using B = SafetyVerifierImpl;
+    const double ts = r.timestamp;
+    if (mask & B::kRollRate) {
+        emit({ts, anomaly_ids::kRollRateBreach, Severity::Major, excess(r.gx, t[B::kLimitRollRate])});
     }
-
-    // 3. Altitude
-    double alt_min = getOr(limits_, "altitude_min", 0.0);
-    double alt_max = getOr(limits_, "altitude_max", 15000.0);
-    if (state.alt_msl < alt_min || state.alt_msl > alt_max) {
-        anomalies.push_back({
-            raw.timestamp, "limit_breach", "altitude",
-            Severity::Major,
-            "Altitude out of range"
-        });
+    if (mask & B::kPitchRate) {
+        emit({ts, anomaly_ids::kPitchRateBreach, Severity::Major, excess(r.gy, t[B::kLimitPitchRate])});
     }
-
-    // 4. Temperature
-    double temp_min = getOr(limits_, "temperature_min", -55.0);
-    double temp_max = getOr(limits_, "temperature_max", 70.0);
-    if (raw.temperature < temp_min || raw.temperature > temp_max) {
-        anomalies.push_back({
-            raw.timestamp, "limit_breach", "temperature",
-            Severity::Minor,
-            "Temp out of spec"
-        });
+    if (mask & B::kYawRate) {
+        emit({ts, anomaly_ids::kYawRateBreach, Severity::Major, excess(r.gz, t[B::kLimitYawRate])});
     }
-
-    // 5. Vibration RMS
-    double vib_rms = std::sqrt(
-        (raw.vib_x*raw.vib_x + raw.vib_y*raw.vib_y + raw.vib_z*raw.vib_z) / 3.0
-    );
-    double vib_thresh = getOr(limits_, "vibration_rms_max", 5.0);
-    if (vib_rms > vib_thresh) {
-        anomalies.push_back({
-            raw.timestamp, "vibration_excess", "vibration",
-            Severity::Major,
-            "RMS vibration exceeds threshold"
-        });
+    if (mask & (B::kDynPressureLow | B::kDynPressureHigh)) {
+        emit({ts, anomaly_ids::kDynPressureBreach,
+              (mask & B::kDynPressureHigh) ? Severity::Critical : Severity::Major,
+              excess(r.q_dyn, t[B::kLimitDynPressure])});
     }
-
-    // 6. GNSS dropout
-    if (!isGnssValid(raw)) {
-        anomalies.push_back({
-            raw.timestamp, "gnss_dropout", "gps",
-            Severity::Major,
-            "GNSS signal lost >1s"
-        });
+    if (mask & B::kAltitude) {
+        emit({ts, anomaly_ids::kAltitudeBreach, Severity::Major, excess(r.alt, t[B::kLimitAltitude])});
+    }
+    if (mask & B::kTemperature) {
+        emit({ts, anomaly_ids::kTemperatureBreach, Severity::Minor, excess(r.temp, t[B::kLimitTemperature])});
     }
+    if (mask & B::kVibration) {
+        double vib_rms = std::sqrt((r.vx*r.vx + r.vy*r.vy + r.vz*r.vz) / 3.0);
+        emit({ts, anomaly_ids::kVibrationExcess, Severity::Major,
+              static_cast<float>(vib_rms - t[B::kLimitVibrationRms].max)});
+    }
+    if (mask & B::kGnssDropout) {
+        emit({ts, anomaly_ids::kGnssDropout, Severity::Major, static_cast<float>(r.gnss_outage)});
+    }
+}
+
+}  // namespace
+
+std::vector<Anomaly> SafetyVerifierImpl::check(const FusedState& state,
+                                               const TimestampedSample& raw) {
+    std::vector<Anomaly> anomalies;
 
+    const EnvelopeColumns row{&raw.imu_gx, &raw.imu_gy, &raw.imu_gz,
+                              &state.q_dyn, &state.alt_msl, &raw.temperature,
+                              &raw.vib_x, &raw.vib_y, &raw.vib_z};
+    uint16_t mask = 0;
+    envelopeKernel(SimdLevel::Scalar)(row, limits_, 1, &mask);
+    if (!isGnssValid(raw)) mask |= kGnssDropout;
+    if (!mask) return anomalies;
+
+    const double outage = (last_gnss_time_ >= 0) ? raw.timestamp - last_gnss_time_ : 0.0;
+    const BreachRow r{raw.timestamp, raw.imu_gx, raw.imu_gy, raw.imu_gz,
+                      state.q_dyn, state.alt_msl, raw.temperature,
+                      raw.vib_x, raw.vib_y, raw.vib_z, outage};
+    emitBreaches(mask, r, limits_, [&](Anomaly&& a) { anomalies.push_back(a); });
     return anomalies;
 }
 
+size_t SafetyVerifierImpl::computeBreachMask(const FusedBlock& state, const SampleBlock& raw,
+                                             uint16_t* mask) {
+    const size_t n = raw.size;
+    const EnvelopeColumns cols{raw.imu_gx.data(), raw.imu_gy.data(), raw.imu_gz.data(),
+                               state.q_dyn.data(), state.alt_msl.data(), raw.temperature.data(),
+                               raw.vib_x.data(), raw.vib_y.data(), raw.vib_z.data()};
+    size_t flagged = envelopeKernel(simd_level_)(cols, limits_, n, mask);
+
+    // GNSS validity carries state from row to row
+    for (size_t i = 0; i < n; ++i) {
+        if (!isGnssValid(raw.timestamp[i], raw.gps_lat[i], raw.gps_lon[i])) {
+            flagged += (mask[i] == 0);
+            mask[i] |= kGnssDropout;
+        }
+    }
+    return flagged;
+}
+
+void SafetyVerifierImpl::checkBlock(const FusedBlock& state, const SampleBlock& raw,
+                                    std::vector<BlockAnomaly>& out) {
+    const size_t n = raw.size;
+    if (breach_mask_.size() < n) breach_mask_.resize(n);
+    uint16_t* mask = breach_mask_.data();
+
+    // Nominal blocks stop here: no anomaly is built and nothing is allocated
+    double last_fix = last_gnss_time_;
+    if (computeBreachMask(state, raw, mask) == 0) return;
+
+    for (size_t i = 0; i < n; ++i) {
+        const double t = raw.timestamp[i];
+        if (raw.gps_lat[i] != 0.0 || raw.gps_lon[i] != 0.0) last_fix = t;
+        if (!mask[i]) continue;
+
+        const BreachRow r{t, raw.imu_gx[i], raw.imu_gy[i], raw.imu_gz[i],
+                          state.q_dyn[i], state.alt_msl[i], raw.temperature[i],
+                          raw.vib_x[i], raw.vib_y[i], raw.vib_z[i],
+                          (last_fix >= 0) ? t - last_fix : 0.0};
+        const auto row = static_cast<uint32_t>(i);
+        emitBreaches(mask[i], r, limits_, [&](Anomaly&& a) { out.push_back({row, a}); });
+    }
+}
+
 }  // namespace astvdp
@@ -1,23 +1,73 @@
 #pragma once
 #include "astvdp/interfaces.h"
+#include "core/cpu_features.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
 
 namespace astvdp {
 
 class SafetyVerifierImpl : public SafetyVerifier {
 public:
+    // Per-sample breach bits; each set bit yields one anomaly
+    enum BreachBit : uint16_t {
+        kRollRate = 1u << 0,
+        kPitchRate = 1u << 1,
+        kYawRate = 1u << 2,
+        kDynPressureLow = 1u << 3,
+        kDynPressureHigh = 1u << 4,
+        kAltitude = 1u << 5,
+        kTemperature = 1u << 6,
+        kVibration = 1u << 7,
+        kGnssDropout = 1u << 8,
+    };
+
+    // Envelope parameters, resolved once from safety_limits.param_name
+    enum Limit : uint8_t {
+        kLimitRollRate,      // "roll_rate"
+        kLimitPitchRate,     // "pitch_rate"
+        kLimitYawRate,       // "yaw_rate"
+        kLimitDynPressure,   // "q_dyn"
+        kLimitAltitude,      // "altitude"
+        kLimitTemperature,   // "temperature"
+        kLimitVibrationRms,  // "vibration_rms" (max only)
+        kLimitCount
+    };
+
+    struct LimitRange {
+        double min;
+        double max;
+    };
+    using LimitTable = std::array<LimitRange, kLimitCount>;
+
+    static LimitTable defaultLimits();
+    const LimitTable& limits() const { return limits_; }
+
     bool loadLimitsFromDb(const std::string& db_path) override;
     std::vector<Anomaly> check(const FusedState& state,
                                const TimestampedSample& raw) override;
+    void checkBlock(const FusedBlock& state, const SampleBlock& raw,
+                    std::vector<BlockAnomaly>& out) override;
+
+    // Writes one BreachBit mask per row of the block into mask[0, raw.size)
+    // and returns how many rows have any bit set. Envelope checks run in a
+    // SIMD kernel chosen at runtime; GNSS validity is tracked row by row.
+    size_t computeBreachMask(const FusedBlock& state, const SampleBlock& raw, uint16_t* mask);
+
+    // Defaults to the best level the CPU supports; lower it to compare paths
+    void setSimdLevel(SimdLevel level) { simd_level_ = level; }
 
 private:
     void loadDefaults();
     bool isGnssValid(const TimestampedSample& raw);
+    bool isGnssValid(double timestamp, double lat, double lon);
     double last_gnss_time_ = -1.0;
     bool gnss_valid_ = false;
+    SimdLevel simd_level_ = detectSimdLevel();
 
-    std::unordered_map<std::string, double> limits_;
+    LimitTable limits_ = defaultLimits();
+    std::vector<uint16_t> breach_mask_;
 };
 
 }  // namespace astvdp
\ No newline at end of file
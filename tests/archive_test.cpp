@@ -0,0 +1,124 @@
+// Round-trips the column codecs and the session archive: every encoding must
+// restore exact bit patterns, readers must see the written rows whatever the
+// chunk and block sizes, and damaged files must be rejected.
+#include "archive/archive_writer.h"
+#include "archive/column_codec.h"
+#include "ingest/archive_ingest.h"
+#include "simulation/flight_simulator.h"
+#include "test_support.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+void checkCodecs() {
+    std::mt19937 rng(3);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<std::vector<double>> columns = {
+        {},
+        {42.0},
+        {std::numeric_limits<double>::quiet_NaN(), -0.0, 0.0, std::numeric_limits<double>::infinity(),
+         -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::denorm_min(),
+         std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()},
+    };
+    std::vector<double> constant(1000, -33.9249), ramp, random;
+    for (int i = 0; i < 1000; ++i) {
+        ramp.push_back(i * 0.01);
+        random.push_back(noise(rng) * std::pow(10.0, i % 7 - 3));
+    }
+    columns.push_back(constant);
+    columns.push_back(ramp);
+    columns.push_back(random);
+
+    for (const auto& values : columns) {
+        for (ColumnEncoding encoding : {ColumnEncoding::kRaw, ColumnEncoding::kXor, ColumnEncoding::kDelta}) {
+            std::vector<uint8_t> bytes;
+            encodeColumn(encoding, values.data(), values.size(), bytes);
+            std::vector<double> decoded(values.size());
+            const bool ok = decodeColumn(encoding, bytes.data(), bytes.size(), decoded.data(), values.size());
+            bool same = ok;
+            for (size_t i = 0; same && i < values.size(); ++i) same = sameBits(values[i], decoded[i]);
+            expect(same, "codec round trip is bit-exact");
+            if (!bytes.empty()) {
+                expect(!decodeColumn(encoding, bytes.data(), bytes.size() - 1, decoded.data(), values.size()),
+                       "truncated column rejected");
+            }
+        }
+    }
+
+    std::vector<uint8_t> bytes;
+    expect(encodeColumnSmallest(constant.data(), constant.size(), bytes) != ColumnEncoding::kRaw &&
+               bytes.size() < constant.size(),
+           "constant column compresses");
+}
+
+void checkArchive() {
+    FlightSimulator::Profile prof;
+    prof.duration_sec = 60.0;
+    prof.inject_gnss_dropout = true;
+    const std::vector<TimestampedSample> flight = FlightSimulator::generate(prof);
+    const std::string path = (std::filesystem::temp_directory_path() / "astvdp_archive_test.astvdp").string();
+
+    for (bool compress : {false, true}) {
+        ArchiveWriter::Options options;
+        options.chunk_rows = 1000;  // does not divide the flight or the blocks
+        options.compress = compress;
+        ArchiveWriter writer;
+        expect(writer.open(path, options), "archive opens for writing");
+        SampleBlock block(333);
+        for (const auto& s : flight) {
+            block.push(s);
+            if (block.full()) {
+                writer.append(block);
+                block.clear();
+            }
+        }
+        writer.append(block);
+        expect(writer.close() && writer.rowsWritten() == flight.size(), "archive written");
+
+        expect(ArchiveIngest::isArchive(path), "archive magic detected");
+        for (size_t block_rows : {size_t{0}, size_t{1}, size_t{700}, size_t{4096}}) {
+            ArchiveIngest ingest;
+            expect(ingest.open(path), "archive opens for reading");
+            expect(sameRows(readAll(ingest, block_rows), flight), "archive rows match the written rows");
+        }
+
+        ArchiveIngest ingest;
+        ingest.open(path);
+        const auto& chunks = ingest.chunks();
+        expect(chunks.size() == (flight.size() + 999) / 1000, "one index entry per chunk");
+        if (!chunks.empty()) {
+            expect(chunks[0].rows == 1000 && chunks[0].first_time == flight[0].timestamp &&
+                       chunks[0].stats[0].min == flight[0].timestamp &&
+                       chunks[0].stats[0].max == flight[999].timestamp,
+                   "chunk index holds row count, time span and stats");
+        }
+    }
+
+    // Damaged trailer: the index cannot be trusted, so open() must fail
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('X');
+    }
+    ArchiveIngest damaged;
+    expect(!damaged.open(path), "damaged archive rejected");
+    std::filesystem::remove(path);
+}
+
+}  // namespace
+
+int main() {
+    checkCodecs();
+    checkArchive();
+    return report("archive");
+}
@@ -0,0 +1,90 @@
+// Batch sessions share one database connection: a session whose rows fail
+// to insert must fail on its own, without touching the rows, episodes and
+// metrics of a session written alongside it.
+#include "astvdp/sqlite_compat.h"
+#include "batch/batch_runner.h"
+#include "simulation/flight_simulator.h"
+#include "test_support.h"
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+int64_t queryInt(const std::string& path, const std::string& sql) {
+    sqlite3* db = nullptr;
+    int64_t value = -1;
+    if (sqlite3_open(path.c_str(), &db) == SQLITE_OK) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK &&
+            sqlite3_step(stmt) == SQLITE_ROW) {
+            value = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    sqlite3_close(db);
+    return value;
+}
+
+int64_t sessionCount(const std::string& path, const char* table, const std::string& mission,
+                     const std::string& where = "1") {
+    return queryInt(path, std::string("SELECT COUNT(*) FROM ") + table +
+                              " t JOIN flight_sessions s ON t.session_id = s.id WHERE s.mission_id = '" +
+                              mission + "' AND " + where + ";");
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() / "astvdp_batch_runner_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    // Several blocks per session, so the two sessions' writes interleave
+    FlightSimulator::Profile prof;
+    prof.duration_sec = 120.0;
+    prof.inject_vibration_fault = true;
+    std::vector<TimestampedSample> flight = FlightSimulator::generate(prof);
+    const std::string good = (dir / "good.csv").string();
+    const std::string bad = (dir / "bad.csv").string();
+    FlightSimulator::saveToCsv(flight, good);
+    // A NaN timestamp parses, but the schema rejects it as NULL
+    flight[9000].timestamp = std::nan("");
+    FlightSimulator::saveToCsv(flight, bad);
+
+    BatchManifest manifest;
+    manifest.threads = 2;
+    for (const auto& [input, mission] : {std::pair{good, "GOOD"}, std::pair{bad, "BAD"}}) {
+        BatchSession session;
+        session.input = input;
+        session.mission_id = mission;
+        session.output_dir = (dir / mission).string();
+        manifest.sessions.push_back(session);
+    }
+    BatchOptions options;
+    options.db_path = (dir / "batch.db").string();
+    options.output_dir = dir.string();
+
+    expect(runBatch(manifest, options) == 1, "failed session fails the batch");
+    const std::string& db = options.db_path;
+    expect(sessionCount(db, "flight_data", "GOOD") == static_cast<int64_t>(flight.size()),
+           "other session keeps every row");
+    expect(sessionCount(db, "anomalies", "GOOD") > 0, "other session keeps its episodes");
+    expect(sessionCount(db, "session_metrics", "GOOD") == 1, "other session saves its metrics");
+    const std::string after_bad = "t.timestamp >= " + std::to_string(flight[9001].timestamp);
+    expect(sessionCount(db, "flight_data", "BAD") <= 9000 &&
+               sessionCount(db, "flight_data", "BAD", after_bad) == 0,
+           "nothing from the failed block on is committed");
+    expect(sessionCount(db, "session_metrics", "BAD") == 0, "failed session saves no metrics");
+    expect(std::filesystem::exists(dir / "GOOD" / "report.html") &&
+               !std::filesystem::exists(dir / "BAD" / "report.html"),
+           "report only for the session that succeeded");
+
+    std::filesystem::remove_all(dir);
+    return report("batch_runner");
+}
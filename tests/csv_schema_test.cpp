@@ -0,0 +1,163 @@
+// Header-driven column mapping: a flight written with reordered, renamed-case
+// and extra (non-numeric) columns must read back exactly like the canonical
+// layout through every CSV reader, and legacy headerless layouts keep their
+// positional meaning. A named header that lacks required columns reads
+// positionally when its known names are in place, and is rejected otherwise.
+#include "ingest/csv_ingest.h"
+#include "ingest/csv_row_parser.h"
+#include "ingest/ingest_factory.h"
+#include "ingest/mmap_csv_ingest.h"
+#include "ingest/parallel_csv_ingest.h"
+#include "simulation/flight_simulator.h"
+#include "test_support.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+std::string cell(double v) {
+    std::ostringstream out;
+    out.precision(17);
+    out << v;
+    return out.str();
+}
+
+// Same samples in a foreign layout: permuted columns, mixed-case and quoted
+// names, a BOM, and unknown columns holding text. Every 50th row stops
+// before the vibration columns.
+void writeForeign(const std::vector<TimestampedSample>& flight, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    out << "\xEF\xBB\xBF" << "\"Pilot Note\",GPS_LON,gps_lat,TimeStamp,imu_az,imu_ay,imu_ax,fix_type,"
+        << "imu_gz,imu_gy,imu_gx,gps_alt,gps_vy,gps_vx,temperature,static_pressure,vib_z,vib_y,vib_x\n";
+    for (size_t i = 0; i < flight.size(); ++i) {
+        const TimestampedSample& s = flight[i];
+        out << "cruise " << i << ',' << cell(s.gps_lon) << ',' << cell(s.gps_lat) << ',' << cell(s.timestamp)
+            << ',' << cell(s.imu_az) << ',' << cell(s.imu_ay) << ',' << cell(s.imu_ax) << ",3D,"
+            << cell(s.imu_gz) << ',' << cell(s.imu_gy) << ',' << cell(s.imu_gx) << ',' << cell(s.gps_alt)
+            << ',' << cell(s.gps_vy) << ',' << cell(s.gps_vx) << ',' << cell(s.temperature) << ','
+            << cell(s.static_pressure);
+        if (i % 50 != 49) out << ',' << cell(s.vib_z) << ',' << cell(s.vib_y) << ',' << cell(s.vib_x);
+        out << "\r\n";
+    }
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() / "astvdp_csv_schema_test";
+    std::filesystem::create_directories(dir);
+    const std::string canonical = (dir / "canonical.csv").string();
+    const std::string foreign = (dir / "foreign.csv").string();
+
+    FlightSimulator::Profile prof;
+    prof.duration_sec = 30.0;
+    prof.inject_vibration_fault = true;
+    FlightSimulator::saveToCsv(FlightSimulator::generate(prof), canonical);
+    MmapCsvIngest reference;
+    std::vector<TimestampedSample> flight = readAll(reference, canonical);
+    expect(!flight.empty(), "canonical CSV reads");
+
+    writeForeign(flight, foreign);
+    // Short rows carry the vibration values of the row before them
+    std::vector<TimestampedSample> expected = flight;
+    for (size_t i = 49; i < expected.size(); i += 50) {
+        expected[i].vib_x = expected[i - 1].vib_x;
+        expected[i].vib_y = expected[i - 1].vib_y;
+        expected[i].vib_z = expected[i - 1].vib_z;
+    }
+
+    std::vector<std::unique_ptr<DataIngest>> readers;
+    readers.push_back(std::make_unique<MmapCsvIngest>());
+    readers.push_back(std::make_unique<CsvIngest>());
+    readers.push_back(std::make_unique<ParallelCsvIngest>(3, 4096));
+    for (size_t r = 0; r < readers.size(); ++r) {
+        expect(sameRows(readAll(*readers[r], foreign), expected), "foreign layout, reader " + std::to_string(r));
+        expect(sameRows(readAll(*readers[r], canonical), flight), "canonical layout, reader " + std::to_string(r));
+    }
+
+    // Seeking finds the timestamp in a column other than the first
+    {
+        MmapCsvIngest reader;
+        reader.open(foreign);
+        TimestampedSample s;
+        expect(reader.seek(flight[1234].timestamp) && reader.readNext(s) &&
+                   std::memcmp(&s, &expected[1234], sizeof s) == 0,
+               "seek in foreign layout");
+    }
+
+    const std::string header = "x,gps_lat,timestamp,other";
+    const CsvSchema named = CsvSchema::fromHeader(header);
+    expect(!named.positional() && named.column(CsvSchema::kTimestamp) == 2 &&
+               named.column(CsvSchema::kGpsLat) == 1 && named.column(CsvSchema::kImuAx) == -1,
+           "header compiled to a column table");
+    expect(!named.valid() && named.error().find("imu_ax") != std::string::npos &&
+               named.error().find("timestamp") == std::string::npos,
+           "missing required columns reported");
+    {
+        TimestampedSample s{};
+        s.imu_ax = 7.0;
+        const std::string row = "junk,45.5,12.25,more junk";
+        expect(named.parseRow(row.data(), row.data() + row.size(), s) && s.timestamp == 12.25 &&
+                   s.gps_lat == 45.5 && s.imu_ax == 7.0,
+               "unknown columns skipped, unmapped fields untouched");
+        const std::string short_row = "junk,45.5";
+        expect(!named.parseRow(short_row.data(), short_row.data() + short_row.size(), s),
+               "row without the timestamp column rejected");
+    }
+
+    // No known names: the positional layout, every cell converted
+    const CsvSchema legacy = CsvSchema::fromHeader(std::string("a,b,c"));
+    expect(legacy.positional() && legacy.valid(), "unknown header keeps the positional layout");
+    {
+        TimestampedSample s{};
+        const std::string row = "1,2,3,4,5,6,7,8,9,10,11,12,13,text";
+        expect(!legacy.parseRow(row.data(), row.data() + row.size(), s), "positional rows convert every cell");
+    }
+
+    // Named header without a timestamp cannot be read
+    const std::string no_time = (dir / "no_time.csv").string();
+    std::ofstream(no_time) << "imu_ax,imu_ay\n1,2\n";
+    MmapCsvIngest mmap_reader;
+    CsvIngest stream_reader;
+    expect(!mmap_reader.open(no_time) && !stream_reader.open(no_time), "missing timestamp column rejected");
+
+    // Short names around a known first column: the positional layout, as
+    // before headers were read
+    const std::string short_names = (dir / "short_names.csv").string();
+    {
+        std::ifstream in(canonical, std::ios::binary);
+        std::string line;
+        std::getline(in, line);
+        std::ofstream out(short_names, std::ios::binary);
+        out << "timestamp,ax,ay,az,gx,gy,gz,lat,lon,alt,vx,vy,pressure,temp,vibx,viby,vibz\n" << in.rdbuf();
+    }
+    expect(CsvSchema::fromHeader(std::string("timestamp,ax,ay,az")).positional(), "in-place names stay positional");
+    for (size_t r = 0; r < readers.size(); ++r) {
+        expect(sameRows(readAll(*readers[r], short_names), flight), "short names read positionally, reader " +
+                                                                         std::to_string(r));
+    }
+
+    // Known names out of place with required columns missing: rejected with
+    // the missing columns named, rather than read as 0
+    const std::string partial = (dir / "partial.csv").string();
+    std::ofstream(partial) << "imu_az,timestamp,ax,ay\n9.81,0.01,1,2\n";
+    for (size_t r = 0; r < readers.size(); ++r) {
+        expect(!readers[r]->open(partial), "partial named header rejected, reader " + std::to_string(r));
+    }
+    std::string error;
+    expect(!openIngest(partial, 1, &error) && error.find("imu_ax") != std::string::npos &&
+               error.find("gps_vy") != std::string::npos && error.find("imu_az") == std::string::npos,
+           "openIngest reports the missing columns: " + error);
+
+    std::filesystem::remove_all(dir);
+    return report("csv_schema");
+}
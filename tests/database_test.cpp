@@ -0,0 +1,181 @@
+// Batched flight_data writer: a batch commits when it reaches max_rows or
+// spans max_span_ms of sample time, flush() and endSession() commit the
+// rest, a failed insert drops only the rows of its own call, a batch holds
+// one session's rows, and WAL is only used when asked for.
+#include "astvdp/sqlite_compat.h"
+#include "core/database.h"
+#include "test_support.h"
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+// Reads through a second connection, so only committed rows are counted
+int64_t queryInt(const std::string& path, const char* sql) {
+    sqlite3* db = nullptr;
+    int64_t value = -1;
+    if (sqlite3_open(path.c_str(), &db) == SQLITE_OK) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+            value = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    sqlite3_close(db);
+    return value;
+}
+
+std::string queryText(const std::string& path, const char* sql) {
+    sqlite3* db = nullptr;
+    std::string value;
+    if (sqlite3_open(path.c_str(), &db) == SQLITE_OK) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+            value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+    }
+    sqlite3_close(db);
+    return value;
+}
+
+int64_t committedRows(const std::string& path) {
+    return queryInt(path, "SELECT COUNT(*) FROM flight_data;");
+}
+
+int64_t committedAnomalies(const std::string& path) {
+    return queryInt(path, "SELECT COUNT(*) FROM anomalies;");
+}
+
+TimestampedSample sampleAt(double t) {
+    TimestampedSample s{};
+    s.timestamp = t;
+    s.imu_az = 9.81;
+    return s;
+}
+
+void checkFlushOnRows(const std::string& path) {
+    Database db(path);
+    Database::WriteOptions options;
+    options.max_rows = 3;
+    options.max_span_ms = 1e9;
+    db.setWriteOptions(options);
+    expect(db.open(), "database opens");
+    const int64_t id = db.startSession("ROWS", "TEST");
+
+    expect(db.appendFlightData(id, sampleAt(0.0)) && db.appendFlightData(id, sampleAt(0.01)),
+           "rows appended");
+    expect(committedRows(path) == 0, "batch below max_rows stays pending");
+    db.appendFlightData(id, sampleAt(0.02));
+    expect(committedRows(path) == 3, "batch commits at max_rows");
+    db.appendFlightData(id, sampleAt(0.03));
+    expect(committedRows(path) == 3, "next batch pending");
+    expect(db.flush() && committedRows(path) == 4, "flush commits the pending rows");
+    expect(db.flush(), "flush with nothing pending");
+
+    db.appendFlightData(id, sampleAt(0.04));
+    expect(db.endSession(id, 0.04) && committedRows(path) == 5, "endSession commits the pending rows");
+    db.close();
+}
+
+void checkFlushOnSpan(const std::string& path) {
+    Database db(path);
+    Database::WriteOptions options;
+    options.max_rows = 1000;
+    options.max_span_ms = 100.0;
+    db.setWriteOptions(options);
+    db.open();
+    const int64_t id = db.startSession("SPAN", "TEST");
+
+    SampleBlock block(3);
+    for (double t : {0.0, 0.05, 0.099}) block.push(sampleAt(t));
+    expect(db.appendFlightData(id, block) && committedRows(path) == 0, "batch under max_span_ms stays pending");
+    db.appendFlightData(id, sampleAt(0.1));
+    expect(committedRows(path) == 4, "batch commits once it spans max_span_ms");
+    db.appendFlightData(id, sampleAt(0.2));
+    db.close();
+    expect(committedRows(path) == 5, "close commits the pending rows");
+}
+
+void checkRollback(const std::string& path) {
+    Database db(path);
+    Database::WriteOptions options;
+    options.max_rows = 100;
+    db.setWriteOptions(options);
+    db.open();
+    const int64_t id = db.startSession("ROLLBACK", "TEST");
+
+    db.appendFlightData(id, sampleAt(0.0));
+    db.appendFlightData(id, sampleAt(0.01));
+    Anomaly anomaly{};
+    anomaly.timestamp = 0.01;
+    expect(db.insertAnomaly(id, anomaly), "anomaly inserted mid-batch");
+    // No such session: the foreign key rejects the row
+    expect(!db.appendFlightData(id + 1000, sampleAt(0.02)), "failed insert reported");
+    // A NaN timestamp binds as NULL, which the schema rejects: the block's
+    // rows before it go too
+    SampleBlock block(3);
+    for (double t : {0.03, std::nan(""), 0.05}) block.push(sampleAt(t));
+    expect(!db.appendFlightData(id, block), "failed block reported");
+    expect(db.flush() && committedRows(path) == 2 && committedAnomalies(path) == 1,
+           "failed inserts drop only their own rows");
+
+    expect(db.appendFlightData(id, sampleAt(0.06)) && db.flush() && committedRows(path) == 3,
+           "writer usable after a rollback");
+    db.close();
+}
+
+void checkSessionSwitch(const std::string& path) {
+    Database db(path);
+    db.open();
+    const int64_t a = db.startSession("A", "TEST");
+    const int64_t b = db.startSession("B", "TEST");
+
+    db.appendFlightData(a, sampleAt(0.0));
+    db.appendFlightData(a, sampleAt(0.01));
+    expect(db.appendFlightData(b, sampleAt(5.0)) && committedRows(path) == 2,
+           "another session's rows commit the pending batch");
+    SampleBlock block(2);
+    for (double t : {0.02, std::nan("")}) block.push(sampleAt(t));
+    expect(!db.appendFlightData(a, block) && db.flush() && committedRows(path) == 3,
+           "a failed session leaves the other session's rows");
+    db.close();
+}
+
+void checkJournalMode(const std::string& path) {
+    {
+        Database db(path);
+        db.open();
+    }
+    expect(queryText(path, "PRAGMA journal_mode;") != "wal", "rollback journal by default");
+    {
+        Database db(path);
+        Database::WriteOptions options;
+        options.wal = true;
+        db.setWriteOptions(options);
+        db.open();
+    }
+    expect(queryText(path, "PRAGMA journal_mode;") == "wal", "WAL when asked for");
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() / "astvdp_database_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    checkFlushOnRows((dir / "rows.db").string());
+    checkFlushOnSpan((dir / "span.db").string());
+    checkRollback((dir / "rollback.db").string());
+    checkSessionSwitch((dir / "switch.db").string());
+    checkJournalMode((dir / "journal.db").string());
+
+    std::filesystem::remove_all(dir);
+    return report("database");
+}
@@ -0,0 +1,185 @@
+// Envelope breach masks: every SIMD level must give the scalar kernel's mask
+// bit for bit, and the scalar kernel the plain comparisons, for NaNs,
+// infinities, values exactly on a limit and every remainder length. Through
+// SafetyVerifierImpl, the block mask must agree with the per-sample check().
+#include "verification/envelope_kernels.h"
+#include "verification/safety_verifier.h"
+#include "test_support.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+using B = SafetyVerifierImpl;
+
+constexpr SimdLevel kLevels[] = {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2};
+
+struct Columns {
+    std::vector<double> gx, gy, gz, q, alt, temp, vx, vy, vz;
+
+    EnvelopeColumns view(size_t first = 0) const {
+        return {gx.data() + first, gy.data() + first, gz.data() + first,
+                q.data() + first, alt.data() + first, temp.data() + first,
+                vx.data() + first, vy.data() + first, vz.data() + first};
+    }
+};
+
+// One of `edges` now and then, otherwise a value inside the range
+double pick(std::mt19937& rng, const B::LimitRange& r, const std::vector<double>& edges) {
+    if (rng() % 4 == 0) return edges[rng() % edges.size()];
+    return std::uniform_real_distribution<double>(r.min, r.max)(rng);
+}
+
+std::vector<double> edgesOf(const B::LimitRange& r) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    return {r.min, r.max, std::nextafter(r.min, -inf), std::nextafter(r.max, inf),
+            std::nextafter(r.min, inf), std::nextafter(r.max, -inf), nan, -nan, inf, -inf, 0.0, -0.0};
+}
+
+Columns makeColumns(const B::LimitTable& t, size_t n) {
+    std::mt19937 rng(11);
+    Columns c;
+    const B::LimitRange vib_range{0.0, t[B::kLimitVibrationRms].max};
+    for (size_t i = 0; i < n; ++i) {
+        c.gx.push_back(pick(rng, t[B::kLimitRollRate], edgesOf(t[B::kLimitRollRate])));
+        c.gy.push_back(pick(rng, t[B::kLimitPitchRate], edgesOf(t[B::kLimitPitchRate])));
+        c.gz.push_back(pick(rng, t[B::kLimitYawRate], edgesOf(t[B::kLimitYawRate])));
+        c.q.push_back(pick(rng, t[B::kLimitDynPressure], edgesOf(t[B::kLimitDynPressure])));
+        c.alt.push_back(pick(rng, t[B::kLimitAltitude], edgesOf(t[B::kLimitAltitude])));
+        c.temp.push_back(pick(rng, t[B::kLimitTemperature], edgesOf(t[B::kLimitTemperature])));
+        // Equal axes at the limit give an RMS of exactly the limit
+        const std::vector<double> vib_edges = edgesOf(vib_range);
+        const double v = pick(rng, vib_range, vib_edges);
+        const bool equal = rng() % 3 == 0;
+        c.vx.push_back(v);
+        c.vy.push_back(equal ? v : pick(rng, vib_range, vib_edges) * 0.5);
+        c.vz.push_back(equal ? v : -pick(rng, vib_range, vib_edges) * 0.5);
+    }
+    return c;
+}
+
+// Plain comparisons: NaN never breaches, a value on a limit is inside
+uint16_t expectedMask(const Columns& c, const B::LimitTable& t, size_t i) {
+    auto outside = [](double v, const B::LimitRange& r) { return v < r.min || v > r.max; };
+    uint16_t m = 0;
+    if (outside(c.gx[i], t[B::kLimitRollRate])) m |= B::kRollRate;
+    if (outside(c.gy[i], t[B::kLimitPitchRate])) m |= B::kPitchRate;
+    if (outside(c.gz[i], t[B::kLimitYawRate])) m |= B::kYawRate;
+    if (c.q[i] < t[B::kLimitDynPressure].min) m |= B::kDynPressureLow;
+    if (c.q[i] > t[B::kLimitDynPressure].max) m |= B::kDynPressureHigh;
+    if (outside(c.alt[i], t[B::kLimitAltitude])) m |= B::kAltitude;
+    if (outside(c.temp[i], t[B::kLimitTemperature])) m |= B::kTemperature;
+    const double rms = std::sqrt((c.vx[i] * c.vx[i] + c.vy[i] * c.vy[i] + c.vz[i] * c.vz[i]) / 3.0);
+    if (rms > t[B::kLimitVibrationRms].max) m |= B::kVibration;
+    return m;
+}
+
+void checkKernels() {
+    const B::LimitTable t = B::defaultLimits();
+    const size_t n = 4099;  // leaves a remainder for 2- and 4-lane kernels
+    const Columns c = makeColumns(t, n);
+
+    std::vector<uint16_t> expected(n);
+    size_t expected_flagged = 0;
+    bool on_limit = false;
+    for (size_t i = 0; i < n; ++i) {
+        expected[i] = expectedMask(c, t, i);
+        expected_flagged += expected[i] != 0;
+        on_limit = on_limit || (c.vx[i] == c.vy[i] && c.vx[i] == t[B::kLimitVibrationRms].max);
+    }
+    expect(expected_flagged > 0 && expected_flagged < n && on_limit, "test data has edges and nominal rows");
+
+    for (SimdLevel level : kLevels) {
+        const std::string name = simdLevelName(level);
+        std::vector<uint16_t> mask(n, 0xffff);
+        const size_t flagged = envelopeKernel(level)(c.view(), t, n, mask.data());
+        expect(mask == expected && flagged == expected_flagged, name + ": whole block matches");
+
+        // Every remainder length, starting on odd and even rows
+        bool tails = true;
+        for (size_t first : {size_t{0}, size_t{1}, size_t{3}}) {
+            for (size_t len = 0; len <= 9; ++len) {
+                std::vector<uint16_t> part(len + 1, 0xabcd);
+                const size_t part_flagged = envelopeKernel(level)(c.view(first), t, len, part.data());
+                size_t want = 0;
+                for (size_t i = 0; i < len; ++i) {
+                    tails = tails && part[i] == expected[first + i];
+                    want += expected[first + i] != 0;
+                }
+                tails = tails && part_flagged == want && part[len] == 0xabcd;
+            }
+        }
+        expect(tails, name + ": short blocks match and stay in bounds");
+    }
+}
+
+// One anomaly per bit; the low and high dynamic pressure bits never meet
+size_t anomalyCount(uint16_t mask) {
+    size_t count = 0;
+    for (; mask; mask &= mask - 1) ++count;
+    return count;
+}
+
+void checkVerifier() {
+    const B::LimitTable t = B::defaultLimits();
+    const size_t n = 1027;
+    const Columns c = makeColumns(t, n);
+    SampleBlock raw(n);
+    FusedBlock state(n);
+    for (size_t i = 0; i < n; ++i) {
+        TimestampedSample s{};
+        s.timestamp = i * 0.01;
+        s.imu_gx = c.gx[i];
+        s.imu_gy = c.gy[i];
+        s.imu_gz = c.gz[i];
+        s.temperature = c.temp[i];
+        s.vib_x = c.vx[i];
+        s.vib_y = c.vy[i];
+        s.vib_z = c.vz[i];
+        // A GNSS outage over rows 300..499
+        s.gps_lat = (i >= 300 && i < 500) ? 0.0 : 45.0;
+        s.gps_lon = (i >= 300 && i < 500) ? 0.0 : 7.0;
+        raw.push(s);
+        FusedState f;
+        f.timestamp = s.timestamp;
+        f.q_dyn = c.q[i];
+        f.alt_msl = c.alt[i];
+        state.set(i, f);
+    }
+    state.size = n;
+
+    std::vector<uint16_t> scalar;
+    for (SimdLevel level : kLevels) {
+        SafetyVerifierImpl verifier;
+        verifier.setSimdLevel(level);
+        std::vector<uint16_t> mask(n);
+        verifier.computeBreachMask(state, raw, mask.data());
+        if (level == SimdLevel::Scalar) scalar = mask;
+        expect(mask == scalar, std::string(simdLevelName(level)) + ": verifier mask matches scalar");
+    }
+
+    SafetyVerifierImpl per_sample;
+    bool same = true;
+    bool dropout = false;
+    for (size_t i = 0; i < n; ++i) {
+        same = same && per_sample.check(state.get(i), raw.get(i)).size() == anomalyCount(scalar[i]);
+        dropout = dropout || (scalar[i] & B::kGnssDropout);
+    }
+    expect(same && dropout, "block mask matches per-sample check()");
+}
+
+}  // namespace
+
+int main() {
+    checkKernels();
+    checkVerifier();
+    return report("envelope kernels");
+}
@@ -0,0 +1,124 @@
+// Checks the block ComplementaryFusion path against the per-sample path:
+// attitude within kFastAtan2MaxError, all other outputs exact, and every SIMD
+// level bit-identical to the scalar kernel.
+#include "fusion/complementary_fusion.h"
+#include "fusion/fusion_kernels.h"
+#include "test_support.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+void checkAtan2() {
+    double worst = 0.0;
+    const double pi = std::acos(-1.0);
+    for (int i = 0; i <= 200000; ++i) {
+        const double angle = -pi + 2.0 * pi * i / 200000.0;
+        for (double r : {1e-3, 1.0, 9.81, 1e4}) {
+            const double y = r * std::sin(angle);
+            const double x = r * std::cos(angle);
+            worst = std::max(worst, std::abs(fastAtan2(y, x) - std::atan2(y, x)));
+        }
+    }
+    for (double y : {0.0, 1.0, -1.0}) {
+        for (double x : {0.0, 1.0, -1.0}) {
+            if (y == 0.0 && x == 0.0) continue;
+            worst = std::max(worst, std::abs(fastAtan2(y, x) - std::atan2(y, x)));
+        }
+    }
+    expect(worst <= kFastAtan2MaxError, "fastAtan2 error bound", worst);
+}
+
+SampleBlock makeSamples(size_t n) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    std::uniform_real_distribution<double> angle(-3.0, 3.0);
+    SampleBlock block(n);
+    double t = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        TimestampedSample s;
+        s.timestamp = t;
+        t += 0.01 + 0.001 * (i % 3);
+        const double roll = angle(rng) * 0.3;
+        s.imu_ax = 9.81 * std::sin(angle(rng) * 0.1) + noise(rng);
+        s.imu_ay = 9.81 * std::sin(roll) + noise(rng);
+        s.imu_az = 9.81 * std::cos(roll) * ((i % 50 == 0) ? -1.0 : 1.0);
+        s.imu_gx = noise(rng);
+        s.imu_gy = noise(rng);
+        s.imu_gz = noise(rng);
+        const double speed = (i % 7 == 0) ? 0.5 : 80.0;  // some rows below the yaw cutoff
+        const double track = angle(rng);
+        s.gps_vx = speed * std::cos(track);
+        s.gps_vy = speed * std::sin(track);
+        s.gps_alt = 1000.0 + i;
+        block.push(s);
+    }
+    return block;
+}
+
+// Runs processBlock over `all` in chunks of `chunk` rows
+FusedBlock runBlocks(ComplementaryFusion& fusion, const SampleBlock& all, size_t chunk) {
+    FusedBlock out(all.size);
+    SampleBlock part(chunk);
+    FusedBlock fused(chunk);
+    for (size_t start = 0; start < all.size; start += chunk) {
+        part.clear();
+        for (size_t i = start; i < std::min(all.size, start + chunk); ++i) part.push(all.get(i));
+        fusion.processBlock(part, fused);
+        for (size_t i = 0; i < fused.size; ++i) out.set(start + i, fused.get(i));
+    }
+    out.size = all.size;
+    return out;
+}
+
+void checkFusion() {
+    const SampleBlock samples = makeSamples(5003);
+
+    ComplementaryFusion reference;
+    std::vector<FusedState> expected(samples.size);
+    for (size_t i = 0; i < samples.size; ++i) reference.process(samples.get(i), expected[i]);
+
+    FusedBlock scalar;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2}) {
+        ComplementaryFusion fusion;
+        fusion.setSimdLevel(level);
+        const FusedBlock got = runBlocks(fusion, samples, 37);  // odd size exercises the tails
+
+        double attitude_err = 0.0;
+        bool exact = true;
+        bool identical = true;
+        for (size_t i = 0; i < samples.size; ++i) {
+            const FusedState g = got.get(i);
+            const FusedState& e = expected[i];
+            attitude_err = std::max({attitude_err, std::abs(g.roll - e.roll),
+                                     std::abs(g.pitch - e.pitch), std::abs(g.yaw - e.yaw)});
+            exact = exact && g.timestamp == e.timestamp && g.alt_msl == e.alt_msl &&
+                    g.vn == e.vn && g.ve == e.ve && g.vd == e.vd && g.q_dyn == e.q_dyn;
+            if (level != SimdLevel::Scalar) {
+                const FusedState s = scalar.get(i);
+                identical = identical && sameBits(g.roll, s.roll) && sameBits(g.pitch, s.pitch) &&
+                            sameBits(g.yaw, s.yaw) && sameBits(g.q_dyn, s.q_dyn);
+            }
+        }
+        std::printf("%s: max attitude error %.3g rad\n", simdLevelName(level), attitude_err);
+        expect(attitude_err <= kFastAtan2MaxError, "attitude within tolerance", attitude_err);
+        expect(exact, "non-attitude outputs exact", 0.0);
+        expect(identical, "SIMD kernel bit-identical to scalar", 0.0);
+        if (level == SimdLevel::Scalar) scalar = got;
+    }
+}
+
+}  // namespace
+
+int main() {
+    checkAtan2();
+    checkFusion();
+    return report("fusion tolerance");
+}
@@ -0,0 +1,160 @@
+// ParallelCsvIngest must hand out exactly what MmapCsvIngest does: the same
+// rows, block by block, including short rows that carry columns across chunk
+// edges, CRLF and a missing final newline. A bad row ends the input for every
+// CSV reader, wherever it falls relative to block and chunk edges.
+#include "ingest/csv_ingest.h"
+#include "ingest/mmap_csv_ingest.h"
+#include "ingest/parallel_csv_ingest.h"
+#include "test_support.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+const char* kHeader = "timestamp,imu_ax,imu_ay,imu_az,imu_gx,imu_gy,imu_gz,gps_lat,gps_lon,gps_alt,"
+                      "gps_vx,gps_vy,static_pressure,temperature,vib_x,vib_y,vib_z\n";
+
+// `rows` rows, mostly full, some that stop after 12, 13 or 14 columns; with
+// a bad line in place of row `bad_row` (none when it is past the end)
+std::string messyCsv(int rows, int bad_row, bool final_newline) {
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<double> value(-100.0, 100.0);
+    std::string csv = kHeader;
+    for (int i = 0; i < rows; ++i) {
+        if (i == bad_row) {
+            csv += "not,a,row\n";
+            continue;
+        }
+        const unsigned kind = rng() % 100;
+        const int columns = kind < 90 ? 17 : 12 + static_cast<int>(rng() % 3);
+        csv += std::to_string(i * 0.01);
+        for (int c = 1; c < columns; ++c) csv += "," + std::to_string(value(rng));
+        csv += (kind % 7 == 0) ? "\r\n" : "\n";
+    }
+    if (!final_newline) csv += "200.0,1,2,3,4,5,6,7,8,9,10,11";
+    return csv;
+}
+
+// Compares batch by batch up to the end of input, which must then stay ended
+void compareBatches(const std::string& path, size_t threads, size_t chunk_bytes, size_t capacity) {
+    MmapCsvIngest serial;
+    ParallelCsvIngest parallel(threads, chunk_bytes);
+    serial.open(path);
+    parallel.open(path);
+    SampleBlock a(capacity), b(capacity);
+    size_t rows = 0;
+    bool same = true;
+    do {
+        serial.readBatch(a);
+        parallel.readBatch(b);
+        same = sameBlock(a, b);
+        rows += a.size;
+    } while (same && a.size > 0);
+    same = same && serial.readBatch(a) == 0 && parallel.readBatch(b) == 0;
+    expect(same && rows > 0, "batches match: threads " + std::to_string(threads) + " chunk " +
+                                 std::to_string(chunk_bytes) + " capacity " + std::to_string(capacity));
+}
+
+// A bad row ends the input at the same row for every reader and block size,
+// whether it falls mid-block or on a block edge
+void checkBadRow(const std::filesystem::path& dir, int bad_row) {
+    const std::string path = (dir / ("bad_" + std::to_string(bad_row) + ".csv")).string();
+    std::ofstream(path, std::ios::binary) << messyCsv(10000, bad_row, true);
+    const std::string where = " (bad row " + std::to_string(bad_row) + ")";
+
+    MmapCsvIngest reference;
+    const std::vector<TimestampedSample> expected = readAll(reference, path, 0);
+    expect(expected.size() == static_cast<size_t>(bad_row), "input ends at the bad row" + where);
+
+    CsvIngest csv;
+    MmapCsvIngest mmap;
+    ParallelCsvIngest parallel(3, 4096);
+    DataIngest* readers[] = {&csv, &mmap, &parallel};
+    const char* names[] = {"csv", "mmap", "parallel"};
+    for (size_t r = 0; r < 3; ++r) {
+        for (size_t capacity : {size_t{0}, size_t{1000}, size_t{4096}}) {
+            readers[r]->open(path);
+            const std::vector<TimestampedSample> rows = readAll(*readers[r], capacity);
+            SampleBlock block(16);
+            TimestampedSample row{};
+            const bool ended = readers[r]->readBatch(block) == 0 && readers[r]->readBatch(block) == 0 &&
+                               !readers[r]->readNext(row);
+            readers[r]->close();
+            const std::string what = std::string(names[r]) + " capacity " + std::to_string(capacity) + where;
+            expect(sameRows(rows, expected), "rows before the bad row: " + what);
+            expect(ended, "input stays ended: " + what);
+        }
+    }
+}
+
+void compareRows(const std::string& path, size_t threads, size_t chunk_bytes) {
+    MmapCsvIngest serial;
+    ParallelCsvIngest parallel(threads, chunk_bytes);
+    serial.open(path);
+    parallel.open(path);
+    TimestampedSample x{}, y{};
+    bool same = true;
+    for (int i = 0; same && i < 25000; ++i) {
+        const bool ok_x = serial.readNext(x);
+        const bool ok_y = parallel.readNext(y);
+        same = ok_x == ok_y && (!ok_x || std::memcmp(&x, &y, sizeof x) == 0);
+    }
+    expect(same, "readNext matches: chunk " + std::to_string(chunk_bytes));
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() / "astvdp_parallel_csv_test";
+    std::filesystem::create_directories(dir);
+    const std::string path = (dir / "messy.csv").string();
+    std::ofstream(path, std::ios::binary) << messyCsv(20000, 20000, false);
+    const std::string bad_path = (dir / "messy_bad.csv").string();
+    std::ofstream(bad_path, std::ios::binary) << messyCsv(20000, 15000, true);
+
+    for (size_t threads : {1, 3, 8}) {
+        for (size_t chunk_bytes : {size_t{1}, size_t{100}, size_t{4096}, ParallelCsvIngest::kDefaultChunkBytes}) {
+            for (size_t capacity : {1, 97, 4096}) {
+                compareBatches(path, threads, chunk_bytes, capacity);
+                compareBatches(bad_path, threads, chunk_bytes, capacity);
+            }
+        }
+    }
+    compareRows(path, 4, 1000);
+    compareRows(bad_path, 4, 1000);
+    for (int bad_row : {5000, 4096, 4095, 0}) checkBadRow(dir, bad_row);
+
+    // Seeking restarts the chunk window at the indexed offset
+    {
+        MmapCsvIngest serial;
+        ParallelCsvIngest parallel(4, 2000);
+        serial.open(path);
+        parallel.open(path);
+        SampleBlock a, b;
+        parallel.readBatch(b);  // leave chunks in flight
+        expect(serial.seek(123.456) && parallel.seek(123.456), "seek supported");
+        serial.readBatch(a);
+        parallel.readBatch(b);
+        expect(a.size > 0 && sameBlock(a, b), "seek lands on the same rows");
+    }
+
+    // Empty and header-only files
+    for (const char* text : {"", "timestamp\n"}) {
+        const std::string empty = (dir / "empty.csv").string();
+        std::ofstream(empty, std::ios::binary) << text;
+        ParallelCsvIngest parallel(2);
+        SampleBlock b;
+        expect(parallel.open(empty) && parallel.readBatch(b) == 0, "empty input reads nothing");
+    }
+
+    std::filesystem::remove_all(dir);
+    return report("parallel_csv");
+}
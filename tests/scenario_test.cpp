@@ -0,0 +1,206 @@
+// Scenario simulator: Philox must match the published known-answer vectors,
+// scenario files must parse and reject bad fields, and the generated flight
+// must be bit-identical for any thread count or split, follow its segments
+// and faults, and carry noise of the requested spread.
+#include "core/work_stealing_pool.h"
+#include "ingest/scenario_ingest.h"
+#include "simulation/philox.h"
+#include "simulation/scenario.h"
+#include "simulation/scenario_simulator.h"
+#include "test_support.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+const char* kFlight = R"({
+  "name": "test", "seed": 99, "sample_rate_hz": 100, "noise_std": 0.05,
+  "segments": [
+    { "duration": 20, "climb_rate": 5, "pitch": 0.1 },
+    { "duration": 30, "bank": 0.3, "turn_rate": 0.05, "speed": 100 },
+    { "duration": 20, "climb_rate": -2 }
+  ],
+  "faults": [
+    { "type": "gnss_dropout", "start": 25, "end": 27 },
+    { "type": "vibration_ramp", "start": 60, "rate": 0.2 },
+    { "type": "imu_drift", "start": 10, "end": 15, "rate": 0.01 }
+  ]
+})";
+
+Scenario flight() {
+    Scenario s;
+    std::string error;
+    parseScenario(kFlight, s, error);
+    return s;
+}
+
+void checkPhilox() {
+    // Known-answer vectors from the Random123 distribution (kat_vectors)
+    const Philox4x32::Counter zero = Philox4x32::generate({0, 0, 0, 0}, {0, 0});
+    expect(zero == Philox4x32::Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}, "philox zero vector");
+    const Philox4x32::Counter ones =
+        Philox4x32::generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff});
+    expect(ones == Philox4x32::Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}, "philox ones vector");
+    const Philox4x32::Counter pi =
+        Philox4x32::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0});
+    expect(pi == Philox4x32::Counter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}, "philox pi vector");
+}
+
+void checkParse() {
+    Scenario s;
+    std::string error;
+    expect(parseScenario(kFlight, s, error), "scenario parses: " + error);
+    expect(s.name == "test" && s.seed == 99 && s.segments.size() == 3 && s.faults.size() == 3,
+           "scenario fields read");
+    expect(s.segments[0].speed == 80.0 && s.origin_lat == 45.0 && s.repeat == 1, "defaults applied");
+    expect(s.faults[1].end == INFINITY && s.faults[0].type == Scenario::Fault::kGnssDropout,
+           "open-ended fault");
+    expect(s.duration() == 70.0 && s.sampleCount() == 7000, "duration and sample count");
+
+    const char* bad[] = {
+        "[]",
+        R"({ "segments": [] })",
+        R"({ "segments": [ { "duration": 0 } ] })",
+        R"({ "seed": -1, "segments": [ { "duration": 1 } ] })",
+        R"({ "seed": 1.5, "segments": [ { "duration": 1 } ] })",
+        R"({ "sample_rate_hz": 0, "segments": [ { "duration": 1 } ] })",
+        R"({ "repeat": 0, "segments": [ { "duration": 1 } ] })",
+        R"({ "segments": [ { "duration": 1 } ], "faults": [ { "type": "ice" } ] })",
+        R"({ "segments": [ { "duration": 1 } ], "faults": [ { "type": "imu_drift", "start": 5, "end": 5 } ] })",
+        R"({ "segments": [ { "duration": "long" } ] })",
+    };
+    for (const char* json : bad) {
+        Scenario rejected;
+        error.clear();
+        expect(!parseScenario(json, rejected, error) && !error.empty(), std::string("rejected: ") + json);
+    }
+    expect(!loadScenario("missing_scenario.json", s, error), "missing file rejected");
+}
+
+void checkDeterminism() {
+    const ScenarioSimulator sim(flight());
+    const size_t n = static_cast<size_t>(sim.size());
+    SampleBlock serial(n);
+    sim.generate(0, n, serial);
+    serial.size = n;
+
+    WorkStealingPool pool(3);
+    SampleBlock parallel(n);
+    sim.generate(0, n, parallel, 0, pool);
+    expect(sameRows(serial, parallel, n), "same samples on 1 and 3 threads");
+
+    // Any slice, written at any row, matches the whole flight
+    SampleBlock slice(600);
+    sim.generate(4321, 500, slice, 100);
+    expect(sameRows(slice, serial, 500, 100, 4321), "slice matches the whole flight");
+
+    Scenario reseeded = flight();
+    const ScenarioSimulator again(reseeded);
+    SampleBlock repeat(n);
+    again.generate(0, n, repeat);
+    expect(sameRows(serial, repeat, n), "same seed, same flight");
+    reseeded.seed = 100;
+    SampleBlock other(1);
+    ScenarioSimulator(reseeded).generate(0, 1, other);
+    expect(other.imu_ax[0] != serial.imu_ax[0] && other.timestamp[0] == serial.timestamp[0],
+           "new seed, new noise");
+}
+
+void checkFlight() {
+    const ScenarioSimulator sim(flight());
+    const size_t n = static_cast<size_t>(sim.size());
+    SampleBlock block(n);
+    sim.generate(0, n, block);
+
+    // Noise spread over the first segment, where the truth is constant
+    double sum = 0.0;
+    double sq = 0.0;
+    for (size_t i = 0; i < 2000; ++i) {
+        sum += block.imu_gx[i];
+        sq += block.imu_gx[i] * block.imu_gx[i];
+    }
+    const double mean = sum / 2000.0;
+    const double sd = std::sqrt(sq / 2000.0 - mean * mean);
+    expect(std::fabs(mean) < 0.005 && std::fabs(sd - 0.05) < 0.005, "noise has the requested spread");
+
+    expect(block.timestamp[2500] == 25.0 && block.gps_lat[2500] == 0.0 && block.gps_lon[2699] == 0.0,
+           "dropout zeroes the position");
+    expect(block.gps_lat[2499] != 0.0 && block.gps_lat[2700] != 0.0, "dropout ends on time");
+    double turn_rate = 0.0;
+    for (size_t i = 2000; i < 5000; ++i) turn_rate += block.imu_gz[i] / 3000.0;
+    expect(std::fabs(turn_rate - 0.05) < 0.005 && std::fabs(block.imu_ay[3000] - 9.81 * std::sin(0.3)) < 0.3,
+           "turn segment flown");
+    expect(block.vib_x[6999] > 1.0 + 0.2 * 9.0 && block.vib_x[5000] < 1.8, "vibration ramps up");
+
+    // Without noise, the position is continuous across segment boundaries
+    // and altitude and pressure follow the climb and descent
+    Scenario quiet = flight();
+    quiet.noise_std = 0.0;
+    const ScenarioSimulator exact(quiet);
+    exact.generate(0, n, block);
+    expect(std::fabs(block.gps_alt[2000] - 100.0) < 1e-9 &&
+               std::fabs(block.gps_alt[6999] - (100.0 - 2.0 * 19.99)) < 1e-9,
+           "altitude follows the climb rates");
+    expect(std::fabs(block.static_pressure[2000] - 101325.0 * std::pow(1.0 - 100.0 / 44330.0, 5.255)) < 1e-6,
+           "pressure follows the altitude");
+    double max_step = 0.0;
+    for (size_t i = 2800; i + 1 < n; ++i) {
+        max_step = std::max(max_step, std::fabs(block.gps_lat[i + 1] - block.gps_lat[i]));
+    }
+    expect(max_step * 111320.0 < 1.01, "position continuous at 100 m/s");
+}
+
+void checkIngest() {
+    ScenarioIngest ingest(flight(), 2);
+    expect(ingest.open(""), "ingest opens");
+    SampleBlock block(1024);
+    size_t total = 0;
+    size_t batches = 0;
+    while (size_t n = ingest.readBatch(block)) {
+        total += n;
+        ++batches;
+    }
+    expect(total == 7000 && batches == 7, "every sample read in blocks");
+
+    expect(ingest.seek(42.005), "seek");
+    TimestampedSample row{};
+    expect(ingest.readNext(row) && row.timestamp == 42.01, "seek lands on the next sample");
+    SampleBlock whole(7000);
+    ingest.simulator().generate(0, 7000, whole);
+    const TimestampedSample expected = whole.get(4201);
+    expect(std::memcmp(&row, &expected, sizeof row) == 0, "readNext matches generate()");
+
+    // readNext serves whole noise tiles; rows must not depend on where a
+    // seek lands inside one
+    bool rows_match = ingest.seek(0.0);
+    size_t rows_read = 0;
+    while (ingest.readNext(row)) {
+        const TimestampedSample want = whole.get(rows_read++);
+        rows_match = rows_match && std::memcmp(&row, &want, sizeof row) == 0;
+    }
+    expect(rows_match && rows_read == 7000, "readNext reads every sample");
+    for (uint64_t index : {63u, 64u, 6999u, 130u, 1u}) {
+        const TimestampedSample want = whole.get(index);
+        expect(ingest.seek(want.timestamp) && ingest.readNext(row) && std::memcmp(&row, &want, sizeof row) == 0,
+               "readNext after seek to sample " + std::to_string(index));
+    }
+    expect(ingest.seek(1e9) && ingest.readBatch(block) == 0, "seek past the end");
+    ingest.close();
+}
+
+}  // namespace
+
+int main() {
+    checkPhilox();
+    checkParse();
+    checkDeterminism();
+    checkFlight();
+    checkIngest();
+    return report("scenario");
+}
@@ -0,0 +1,180 @@
+// Drives SessionRunner in-process from memory: output must not depend on the
+// thread count, the sink must see every row and anomaly exactly once, and
+// failures are reported through SessionResult::status. A simulated flight
+// generated block by block must match the materialized one.
+#include "ingest/memory_ingest.h"
+#include "ingest/simulator_ingest.h"
+#include "pipeline/session_runner.h"
+#include "simulation/flight_simulator.h"
+#include "test_support.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+class RecordingSink : public SessionSink {
+public:
+    int64_t session_id = 7;
+    size_t begun = 0;
+    size_t ended = 0;
+    size_t samples = 0;
+    bool writes_ok = true;
+    std::vector<Anomaly> anomalies;
+    std::vector<AnomalyEpisode> episodes;
+
+    int64_t beginSession(const std::string&, const std::string&) override {
+        ++begun;
+        return session_id;
+    }
+    void writeSamples(const SampleBlock& block) override { samples += block.size; }
+    void writeAnomaly(const Anomaly& a) override { anomalies.push_back(a); }
+    void writeEpisode(const AnomalyEpisode& e) override { episodes.push_back(e); }
+    bool finishWrites() override { return writes_ok; }
+    void endSession(const SessionResult&) override { ++ended; }
+};
+
+FlightSimulator::Profile flightProfile() {
+    FlightSimulator::Profile prof;
+    prof.duration_sec = 120.0;
+    prof.inject_vibration_fault = true;
+    prof.inject_gnss_dropout = true;
+    return prof;
+}
+
+const std::vector<TimestampedSample>& flight() {
+    static const std::vector<TimestampedSample> data = FlightSimulator::generate(flightProfile());
+    return data;
+}
+
+SessionResult runFlight(SessionConfig config, RecordingSink* sink) {
+    MemoryIngest ingest(flight());
+    ingest.open("");
+    return SessionRunner(config).run(ingest, sink);
+}
+
+bool sameEpisodes(const std::vector<AnomalyEpisode>& a, const std::vector<AnomalyEpisode>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].start_time != b[i].start_time || a[i].end_time != b[i].end_time ||
+            a[i].count != b[i].count || a[i].id != b[i].id || a[i].severity != b[i].severity) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void checkEpisodes() {
+    SessionConfig config;
+    config.threads = 1;
+    RecordingSink serial_sink;
+    const SessionResult serial = runFlight(config, &serial_sink);
+    config.threads = 4;
+    RecordingSink staged_sink;
+    const SessionResult staged = runFlight(config, &staged_sink);
+
+    expect(serial.ok() && staged.ok(), "sessions succeed");
+    expect(serial.session_id == 7, "session id comes from the sink");
+    expect(serial.sample_count == flight().size(), "every sample processed");
+    expect(serial_sink.samples == flight().size(), "sink sees every sample");
+    expect(serial_sink.begun == 1 && serial_sink.ended == 1, "sink begun and ended once");
+    expect(!serial.anomalies.empty(), "injected faults detected");
+    expect(serial_sink.episodes.size() == serial.anomalies.size(), "sink sees every episode");
+    expect(serial_sink.anomalies.empty(), "no raw anomalies when coalescing");
+    expect(sameEpisodes(serial.anomalies, staged.anomalies), "same episodes at 1 and 4 threads");
+    expect(serial.metrics.stability_index == staged.metrics.stability_index &&
+               serial.metrics.risk_classification == staged.metrics.risk_classification,
+           "same metrics at 1 and 4 threads");
+    for (size_t i = 1; i < serial.anomalies.size(); ++i) {
+        expect(serial.anomalies[i - 1].start_time <= serial.anomalies[i].start_time,
+               "episodes in start-time order");
+    }
+
+    config.raw_anomalies = true;
+    RecordingSink raw_sink;
+    const SessionResult raw = runFlight(config, &raw_sink);
+    size_t coalesced = 0;
+    for (const auto& e : serial.anomalies) coalesced += e.count;
+    expect(raw.anomalies.size() == coalesced, "episodes cover every raw anomaly");
+    expect(raw_sink.anomalies.size() == raw.anomalies.size() && raw_sink.episodes.empty(),
+           "raw mode writes anomalies only");
+
+    const SessionResult unsunk = runFlight(SessionConfig{}, nullptr);
+    expect(sameEpisodes(unsunk.anomalies, serial.anomalies) && unsunk.session_id == -1,
+           "sink is optional");
+}
+
+void checkFailures() {
+    SessionConfig config;
+    RecordingSink sink;
+    MemoryIngest empty;
+    empty.open("");
+    const SessionResult none = SessionRunner(config).run(empty, &sink);
+    expect(none.status == SessionResult::kNoSamples, "empty input reports kNoSamples");
+    expect(sink.ended == 1, "session ended after empty input");
+
+    RecordingSink refusing;
+    refusing.session_id = -1;
+    const SessionResult refused = runFlight(config, &refusing);
+    expect(refused.status == SessionResult::kSessionFailed, "sink refusal reports kSessionFailed");
+    expect(refusing.samples == 0 && refusing.ended == 0, "nothing written after refusal");
+
+    RecordingSink failing;
+    failing.writes_ok = false;
+    const SessionResult write_failed = runFlight(config, &failing);
+    expect(write_failed.status == SessionResult::kSessionFailed && failing.ended == 1,
+           "failed writes report kSessionFailed");
+
+    config.fusion = "kalman";
+    expect(runFlight(config, nullptr).status == SessionResult::kUnknownFusion,
+           "unknown fusion reports kUnknownFusion");
+}
+
+void checkSimulatorIngest() {
+    const auto dir = std::filesystem::temp_directory_path() / "astvdp_session_runner_test";
+    std::filesystem::create_directories(dir);
+    const std::string copy = (dir / "copy.csv").string();
+    const std::string saved = (dir / "saved.csv").string();
+
+    SimulatorIngest sim(flightProfile(), copy);
+    expect(sim.open(""), "simulator opens");
+    SampleBlock block(1000);
+    std::vector<TimestampedSample> rows;
+    while (sim.readBatch(block)) {
+        for (size_t i = 0; i < block.size; ++i) rows.push_back(block.get(i));
+    }
+    sim.close();
+    bool same = rows.size() == flight().size();
+    for (size_t i = 0; same && i < rows.size(); ++i) {
+        same = std::memcmp(&rows[i], &flight()[i], sizeof rows[i]) == 0;
+    }
+    expect(same, "streamed simulation matches generate()");
+    FlightSimulator::saveToCsv(flight(), saved);
+    expect(readFile(copy) == readFile(saved), "CSV copy matches saveToCsv()");
+
+    SessionConfig config;
+    config.threads = 4;
+    SimulatorIngest streamed(flightProfile());
+    streamed.open("");
+    const SessionResult direct = SessionRunner(config).run(streamed, nullptr);
+    expect(direct.ok() && direct.sample_count == flight().size() &&
+               sameEpisodes(direct.anomalies, runFlight(config, nullptr).anomalies),
+           "simulated session matches the in-memory one");
+    std::filesystem::remove_all(dir);
+}
+
+}  // namespace
+
+int main() {
+    checkEpisodes();
+    checkFailures();
+    checkSimulatorIngest();
+    return report("session runner");
+}
@@ -0,0 +1,111 @@
+// Welch PSD of a known sine: the peak lands on the sine's bin and the band
+// holding it carries the sine's power, including a sine at Nyquist, whose
+// bin closes the top band. A steady sine raises no anomaly; once its
+// amplitude jumps, its band raises vibration_band_energy.
+#include "diagnostics/spectral_analyzer.h"
+#include "test_support.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+constexpr double kRate = 100.0;
+constexpr double kAmplitude = 2.0;
+
+// Feeds vib_x = sine(i) on a constant vib_y/vib_z and returns the analyzer
+SpectralAnalyzer run(double (*sine)(size_t), const SpectralConfig& config) {
+    SpectralAnalyzer analyzer(config);
+    SampleBlock block(2000);
+    for (size_t i = 0; i < block.capacity(); ++i) {
+        TimestampedSample s{};
+        s.timestamp = static_cast<double>(i) / kRate;
+        s.vib_x = 1.0 + sine(i);
+        s.vib_y = 0.5;
+        s.vib_z = 0.5;
+        block.push(s);
+    }
+    std::vector<Anomaly> anomalies;
+    for (size_t i = 0; i < block.size; ++i) analyzer.update(block, i, anomalies);
+    return analyzer;
+}
+
+double near(double value, double expected) {
+    return std::abs(value - expected) / expected;
+}
+
+void checkBinSine() {
+    // Bin 20 of a 256-point segment: 7.8125 Hz, mean square A^2 / 2
+    SpectralConfig config;
+    config.sample_rate_hz = kRate;
+    const SpectralAnalyzer a = run(
+        [](size_t i) { return kAmplitude * std::sin(2.0 * std::acos(-1.0) * 20.0 * i / 256.0); }, config);
+    expect(a.peakFrequency(0) == 20.0 * kRate / 256.0, "peak on the sine's bin", a.peakFrequency(0));
+    const double power = a.bandPower(0, 0);
+    expect(near(power, kAmplitude * kAmplitude / 2.0) < 0.01, "band power is the sine's mean square", power);
+    expect(a.bandPower(0, 1) + a.bandPower(0, 2) + a.bandPower(0, 3) < 1e-6 * power, "other bands empty");
+    expect(a.bandPower(1, 0) < 1e-20, "constant axis has no power");
+}
+
+void checkNyquistSine() {
+    // (-1)^i sits in the Nyquist bin: mean square A^2
+    SpectralConfig config;
+    config.sample_rate_hz = kRate;
+    const SpectralAnalyzer a = run([](size_t i) { return (i % 2 ? -kAmplitude : kAmplitude); }, config);
+    expect(a.peakFrequency(0) == kRate / 2.0, "peak at Nyquist", a.peakFrequency(0));
+    expect(a.bands().back().second == kRate / 2.0, "top band ends at Nyquist");
+    const double power = a.bandPower(0, 3);
+    expect(near(power, kAmplitude * kAmplitude) < 0.01, "top band holds the Nyquist power", power);
+
+    // Explicit bands: only the last one is closed at its upper edge
+    config.bands = {{0.0, 50.0}, {40.0, 50.0}};
+    const SpectralAnalyzer b = run([](size_t i) { return (i % 2 ? -kAmplitude : kAmplitude); }, config);
+    expect(near(b.bandPower(0, 1), kAmplitude * kAmplitude) < 0.01, "last band closed", b.bandPower(0, 1));
+    expect(b.bandPower(0, 0) < 0.5 * kAmplitude * kAmplitude, "other bands open", b.bandPower(0, 0));
+}
+
+void checkBandEnergyRise() {
+    // Steady bin-20 sine, then 4x the amplitude: 16x the band power, well
+    // above rise_ratio
+    SpectralConfig config;
+    config.sample_rate_hz = kRate;
+    SpectralAnalyzer analyzer(config);
+    constexpr size_t kSteady = 3000;
+    SampleBlock block(kSteady + 2000);
+    for (size_t i = 0; i < block.capacity(); ++i) {
+        TimestampedSample s{};
+        s.timestamp = static_cast<double>(i) / kRate;
+        const double amplitude = i < kSteady ? 1.0 : 4.0;
+        s.vib_x = 1.0 + amplitude * std::sin(2.0 * std::acos(-1.0) * 20.0 * i / 256.0);
+        block.push(s);
+    }
+    std::vector<Anomaly> steady;
+    std::vector<Anomaly> raised;
+    for (size_t i = 0; i < block.size; ++i) analyzer.update(block, i, i < kSteady ? steady : raised);
+
+    expect(steady.empty(), "no anomaly while the band is steady", static_cast<double>(steady.size()));
+    const std::string band = "Band 0-12.5 Hz energy rising";  // first of four up to 50 Hz
+    bool band_raised = false;
+    bool other_axes = false;
+    for (const Anomaly& a : raised) {
+        const AnomalyDescriptor& d = a.describe();
+        band_raised = band_raised || (d.type == "vibration_band_energy" && d.param == "vib_x" &&
+                                      d.details == band && a.severity == Severity::Major &&
+                                      a.value > config.rise_ratio);
+        other_axes = other_axes || d.param != "vib_x";
+    }
+    expect(band_raised, "rising band raises vibration_band_energy", static_cast<double>(raised.size()));
+    expect(!other_axes, "constant axes raise nothing");
+}
+
+}  // namespace
+
+int main() {
+    checkBinSine();
+    checkNyquistSine();
+    checkBandEnergyRise();
+    return report("spectral");
+}
@@ -0,0 +1,220 @@
+// Streamed ingest: a flight written into a FIFO or UNIX socket in random
+// partial chunks must read back exactly as MmapCsvIngest reads the file,
+// and readBatch must hand over the rows received so far without waiting
+// for a full block. Bad and blank lines are skipped without ending the
+// stream, even when one arrives on its own.
+#include "ingest/mmap_csv_ingest.h"
+#include "ingest/stream_ingest.h"
+#include "simulation/flight_simulator.h"
+#include "test_support.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace astvdp;
+using namespace astvdp::test;
+
+namespace {
+
+#ifndef _WIN32
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        const ssize_t n = ::write(fd, data, size);
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Writes `text` in random 1..max_chunk byte pieces, so lines split anywhere
+void writeChunked(int fd, const std::string& text, size_t max_chunk, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> len(1, max_chunk);
+    for (size_t pos = 0; pos < text.size();) {
+        const size_t n = std::min(len(rng), text.size() - pos);
+        if (!writeAll(fd, text.data() + pos, n)) break;
+        pos += n;
+    }
+}
+
+#endif
+
+}  // namespace
+
+int main() {
+#ifdef _WIN32
+    std::printf("stream_ingest: skipped (POSIX only)\n");
+    return 0;
+#else
+    const auto dir = std::filesystem::temp_directory_path() / "astvdp_stream_ingest_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::string csv = (dir / "flight.csv").string();
+    const std::string fifo = (dir / "flight.fifo").string();
+    const std::string sock = (dir / "flight.sock").string();
+
+    FlightSimulator::Profile prof;
+    prof.duration_sec = 30.0;
+    prof.inject_vibration_fault = true;
+    FlightSimulator::saveToCsv(FlightSimulator::generate(prof), csv);
+    std::ifstream in(csv, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    // Drop the final newline: the last line may end without one
+    if (!text.empty() && text.back() == '\n') text.pop_back();
+    MmapCsvIngest reference;
+    const std::vector<TimestampedSample> flight = readAll(reference, csv);
+    expect(!flight.empty(), "reference CSV reads");
+
+    expect(StreamIngest::isStreamSource("-") && StreamIngest::isStreamSource("unix:/tmp/x.sock"),
+           "stdin and socket names are streams");
+    expect(!StreamIngest::isStreamSource(csv), "regular file is not a stream");
+    expect(::mkfifo(fifo.c_str(), 0600) == 0 && StreamIngest::isStreamSource(fifo), "FIFO is a stream");
+
+    // FIFO fed in small and large random pieces
+    const size_t chunk_sizes[] = {7, 300, 100000};
+    for (size_t c = 0; c < 3; ++c) {
+        std::thread writer([&] {
+            const int fd = ::open(fifo.c_str(), O_WRONLY);
+            writeChunked(fd, text, chunk_sizes[c], static_cast<unsigned>(c + 1));
+            ::close(fd);
+        });
+        StreamIngest stream;
+        expect(sameRows(readAll(stream, fifo), flight), "FIFO rows, chunk " + std::to_string(chunk_sizes[c]));
+        writer.join();
+    }
+
+    // Bad and blank lines scattered through the stream are skipped
+    {
+        std::string messy;
+        size_t skipped = 0;
+        for (size_t pos = 0, line = 0; pos < text.size(); ++line) {
+            const size_t next = std::min(text.find('\n', pos), text.size() - 1) + 1;
+            messy.append(text, pos, next - pos);
+            if (line > 0 && line % 500 == 0 && next < text.size()) {
+                messy += line % 1000 == 0 ? "\n" : "x,1,2\n";
+                ++skipped;
+            }
+            pos = next;
+        }
+        std::thread writer([&] {
+            const int fd = ::open(fifo.c_str(), O_WRONLY);
+            writeChunked(fd, messy, 300, 4);
+            ::close(fd);
+        });
+        StreamIngest stream;
+        expect(sameRows(readAll(stream, fifo), flight) && stream.skippedLines() == skipped,
+               "FIFO rows around bad lines");
+        writer.join();
+    }
+
+    // Rows already received are returned without waiting for a full block;
+    // a line cut mid-number waits for its end
+    {
+        const size_t header_end = text.find('\n') + 1;
+        size_t cut = header_end;
+        for (int i = 0; i < 10; ++i) cut = text.find('\n', cut) + 1;
+        const size_t partial = cut + 20;
+        const size_t line_end = text.find('\n', cut) + 1;
+
+        int fds[2];
+        expect(::pipe(fds) == 0, "pipe");
+        writeAll(fds[1], text.data(), partial);
+        const int saved_stdin = ::dup(0);
+        ::dup2(fds[0], 0);
+        ::close(fds[0]);
+
+        StreamIngest stream;
+        expect(stream.open("-"), "stdin opens");
+        SampleBlock block(1000);
+        expect(stream.readBatch(block) == 10, "ten complete rows returned");
+        const TimestampedSample last = block.get(9);
+        expect(std::memcmp(&last, &flight[9], sizeof last) == 0, "received rows match the file");
+        writeAll(fds[1], text.data() + partial, line_end - partial);
+        expect(stream.readBatch(block) == 1 && block.timestamp[0] == flight[10].timestamp,
+               "completed line returned");
+
+        // A bad line, then a blank one, each arriving alone: readBatch keeps
+        // waiting for the next row instead of reporting the end of stream
+        size_t row_begin = line_end;
+        size_t row = 11;
+        for (const char* lone : {"1.0,oops\n", "\n"}) {
+            writeAll(fds[1], lone, std::strlen(lone));
+            const size_t row_end = text.find('\n', row_begin) + 1;
+            std::thread late([&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                writeAll(fds[1], text.data() + row_begin, row_end - row_begin);
+            });
+            const size_t n = stream.readBatch(block);
+            late.join();
+            expect(n == 1 && block.timestamp[0] == flight[row].timestamp,
+                   std::string("row after a lone ") + (lone[0] == '\n' ? "blank" : "bad") + " line");
+            row_begin = row_end;
+            ++row;
+        }
+        writeAll(fds[1], "2.0,oops\n", 9);
+        ::close(fds[1]);
+        expect(stream.readBatch(block) == 0, "end of stream");
+        expect(stream.skippedLines() == 3, "bad and blank lines counted");
+        stream.close();
+        ::dup2(saved_stdin, 0);
+        ::close(saved_stdin);
+    }
+
+    // UNIX socket client
+    {
+        const int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, sock.c_str(), sizeof addr.sun_path - 1);
+        const bool listening = server >= 0 && sock.size() < sizeof addr.sun_path &&
+                               ::bind(server, reinterpret_cast<const sockaddr*>(&addr), sizeof addr) == 0 &&
+                               ::listen(server, 1) == 0;
+        expect(listening, "socket listens");
+        if (listening) {
+            std::thread writer([&] {
+                const int client = ::accept(server, nullptr, nullptr);
+                writeChunked(client, text, 5000, 9);
+                ::close(client);
+            });
+            StreamIngest stream;
+            expect(sameRows(readAll(stream, "unix:" + sock), flight), "socket rows");
+            writer.join();
+        }
+        if (server >= 0) ::close(server);
+        StreamIngest stream;
+        expect(!stream.open("unix:" + (dir / "missing.sock").string()), "missing socket rejected");
+    }
+
+    // Named header without a timestamp is rejected as for files
+    {
+        std::thread writer([&] {
+            const int fd = ::open(fifo.c_str(), O_WRONLY);
+            writeAll(fd, "imu_ax,imu_ay\n1,2\n", 18);
+            ::close(fd);
+        });
+        StreamIngest stream;
+        expect(!stream.open(fifo), "missing timestamp column rejected");
+        writer.join();
+    }
+
+    std::filesystem::remove_all(dir);
+    return report("stream_ingest");
+#endif
+}
@@ -0,0 +1,98 @@
+#pragma once
+// Shared by the unit-test executables: failed checks are printed and counted,
+// and main() ends with `return report("name");`. Sample comparisons are on
+// exact bit patterns, so NaNs and signed zeros must match too.
+#include "astvdp/interfaces.h"
+#include "astvdp/types.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace astvdp::test {
+
+inline int failures = 0;
+
+inline void expect(bool ok, const std::string& what) {
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+// With the measured value that was out of bounds
+inline void expect(bool ok, const std::string& what, double detail) {
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s (%.3g)\n", what.c_str(), detail);
+        ++failures;
+    }
+}
+
+// Prints "<name>: OK" when every check passed; returns the exit status
+inline int report(const char* name) {
+    if (failures == 0) std::printf("%s: OK\n", name);
+    return failures == 0 ? 0 : 1;
+}
+
+inline bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof a) == 0;
+}
+
+inline bool sameRow(const TimestampedSample& a, const TimestampedSample& b) {
+    return std::memcmp(&a, &b, sizeof a) == 0;
+}
+
+inline bool sameRows(const std::vector<TimestampedSample>& a, const std::vector<TimestampedSample>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!sameRow(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+// Rows [a_first, a_first + count) of `a` against as many from `b_first` of `b`
+inline bool sameRows(const SampleBlock& a, const SampleBlock& b, size_t count, size_t a_first = 0,
+                     size_t b_first = 0) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!sameRow(a.get(a_first + i), b.get(b_first + i))) return false;
+    }
+    return true;
+}
+
+inline bool sameBlock(const SampleBlock& a, const SampleBlock& b) {
+    return a.size == b.size && sameRows(a, b, a.size);
+}
+
+// Every row left in an open reader, in blocks of `block_rows` (0: readNext)
+inline std::vector<TimestampedSample> readAll(DataIngest& ingest, size_t block_rows = 1000) {
+    std::vector<TimestampedSample> rows;
+    if (block_rows == 0) {
+        TimestampedSample s{};
+        while (ingest.readNext(s)) rows.push_back(s);
+        return rows;
+    }
+    SampleBlock block(block_rows);
+    while (ingest.readBatch(block)) {
+        for (size_t i = 0; i < block.size; ++i) rows.push_back(block.get(i));
+    }
+    return rows;
+}
+
+// Opens `path`, reads every row and closes; empty if it does not open
+inline std::vector<TimestampedSample> readAll(DataIngest& ingest, const std::string& path,
+                                              size_t block_rows = 1000) {
+    if (!ingest.open(path)) return {};
+    std::vector<TimestampedSample> rows = readAll(ingest, block_rows);
+    ingest.close();
+    return rows;
+}
+
+inline std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+}  // namespace astvdp::test
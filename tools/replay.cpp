@@ -0,0 +1,207 @@
+// astvdp_replay: plays a recorded flight back as a live CSV stream, the
+// stand-in for a telemetry downlink when testing streamed ingest.
+//
+//   astvdp_replay [--rate <x>] [--output <path>] [--listen unix:<path>] <flight.csv|flight.astvdp>
+//
+// Rows go out at their recorded timestamps scaled by --rate (1 = real time,
+// 10 = ten times faster, 0 = as fast as the reader takes them), written with
+// 17 significant digits so the reader sees the recorded values exactly.
+// Output goes to stdout, to --output (a FIFO or file), or to the first
+// client that connects to --listen.
+#include "argh/argh.h"
+#include "astvdp/interfaces.h"
+#include "ingest/ingest_factory.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <csignal>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t kFlushBytes = 64 * 1024;
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+#ifdef _WIN32
+        const int n = _write(fd, data, static_cast<unsigned>(size));
+#else
+        const ssize_t n = ::write(fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void appendRow(std::string& out, const astvdp::SampleBlock& b, size_t i) {
+    const double values[] = {b.timestamp[i], b.imu_ax[i], b.imu_ay[i], b.imu_az[i], b.imu_gx[i], b.imu_gy[i],
+                             b.imu_gz[i], b.gps_lat[i], b.gps_lon[i], b.gps_alt[i], b.gps_vx[i], b.gps_vy[i],
+                             b.static_pressure[i], b.temperature[i], b.vib_x[i], b.vib_y[i], b.vib_z[i]};
+    char cell[32];
+    for (size_t c = 0; c < sizeof values / sizeof values[0]; ++c) {
+        const int n = std::snprintf(cell, sizeof cell, c == 0 ? "%.17g" : ",%.17g", values[c]);
+        out.append(cell, static_cast<size_t>(n));
+    }
+    out += '\n';
+}
+
+// Listens on a UNIX socket and returns the first client, or -1
+int acceptOne(const std::string& path) {
+#ifdef _WIN32
+    (void)path;
+    std::cerr << "--listen is not supported on Windows\n";
+    return -1;
+#else
+    sockaddr_un addr{};
+    if (path.empty() || path.size() >= sizeof addr.sun_path) {
+        std::cerr << "Invalid socket path: " << path << "\n";
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    const int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::unlink(path.c_str());
+    if (server < 0 || ::bind(server, reinterpret_cast<const sockaddr*>(&addr), sizeof addr) != 0 ||
+        ::listen(server, 1) != 0) {
+        std::cerr << "Failed to listen on " << path << ": " << std::strerror(errno) << "\n";
+        if (server >= 0) ::close(server);
+        return -1;
+    }
+    std::cerr << "Waiting for a client on unix:" << path << "\n";
+    int client;
+    do {
+        client = ::accept(server, nullptr, nullptr);
+    } while (client < 0 && errno == EINTR);
+    ::close(server);
+    ::unlink(path.c_str());
+    return client;
+#endif
+}
+
+int openOutput(const std::string& path) {
+#ifdef _WIN32
+    return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);  // a FIFO blocks until read
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    argh::parser cmdl;
+    cmdl.add_params({"--rate", "--output", "--listen"});
+    cmdl.parse(argc, argv);
+
+    const std::string input = cmdl(1).str();
+    if (cmdl["--help"] || input.empty()) {
+        std::cout << "Usage: astvdp_replay [--rate <x>] [--output <path>] [--listen unix:<path>] "
+                  << "<flight.csv|flight.astvdp>\n";
+        return input.empty() && !cmdl["--help"] ? 1 : 0;
+    }
+    double rate = 1.0;
+    if (!(cmdl({"--rate"}, rate) >> rate) || !(rate >= 0.0)) {
+        std::cerr << "Error: --rate must be a number >= 0\n";
+        return 1;
+    }
+    std::string output_path;
+    std::string listen_path;
+    cmdl({"--output"}, "") >> output_path;
+    cmdl({"--listen"}, "") >> listen_path;
+    if (listen_path.compare(0, 5, "unix:") == 0) listen_path.erase(0, 5);
+    if (!output_path.empty() && !listen_path.empty()) {
+        std::cerr << "Error: use either --output or --listen, not both\n";
+        return 1;
+    }
+
+    std::unique_ptr<astvdp::DataIngest> ingest = astvdp::openIngest(input);
+    if (!ingest) {
+        std::cerr << "Failed to open input: " << input << "\n";
+        return 1;
+    }
+
+#ifndef _WIN32
+    std::signal(SIGPIPE, SIG_IGN);  // a reader that goes away ends the replay
+#endif
+    int fd = 1;
+    if (!listen_path.empty()) {
+        fd = acceptOne(listen_path);
+    } else if (!output_path.empty()) {
+        fd = openOutput(output_path);
+    } else {
+#ifdef _WIN32
+        _setmode(1, _O_BINARY);
+#endif
+    }
+    if (fd < 0) {
+        std::cerr << "Failed to open output\n";
+        return 1;
+    }
+
+    std::string out =
+        "timestamp,imu_ax,imu_ay,imu_az,imu_gx,imu_gy,imu_gz,gps_lat,gps_lon,gps_alt,gps_vx,gps_vy,"
+        "static_pressure,temperature,vib_x,vib_y,vib_z\n";
+    astvdp::SampleBlock block;
+    size_t rows = 0;
+    bool ok = true;
+    bool started = false;
+    double first_time = 0.0;
+    std::chrono::steady_clock::time_point start;
+    while (ok && ingest->readBatch(block) > 0) {
+        for (size_t i = 0; ok && i < block.size; ++i) {
+            if (rate > 0.0) {
+                if (!started) {
+                    started = true;
+                    first_time = block.timestamp[i];
+                    start = std::chrono::steady_clock::now();
+                }
+                const auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                             std::chrono::duration<double>((block.timestamp[i] - first_time) / rate));
+                if (due > std::chrono::steady_clock::now()) {
+                    // Everything due so far goes out before waiting
+                    ok = writeAll(fd, out.data(), out.size());
+                    out.clear();
+                    std::this_thread::sleep_until(due);
+                }
+            }
+            appendRow(out, block, i);
+            ++rows;
+            if (out.size() >= kFlushBytes) {
+                ok = ok && writeAll(fd, out.data(), out.size());
+                out.clear();
+            }
+        }
+    }
+    ok = ok && writeAll(fd, out.data(), out.size());
+    ingest->close();
+    if (fd != 1) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+    if (!ok) {
+        std::cerr << "Output closed after " << rows << " rows\n";
+        return 1;
+    }
+    std::cerr << "Replayed " << rows << " rows\n";
+    return 0;
+}